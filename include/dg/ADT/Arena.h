@@ -0,0 +1,109 @@
+#ifndef DG_ADT_ARENA_H_
+#define DG_ADT_ARENA_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+///
+// Storage for objects derived from BaseT that live as long as the arena.
+// The objects are allocated from big chunks of memory (bump-pointer
+// allocation), so creating an object is cheap and the objects are close
+// to each other in memory. Objects are never freed one by one.
+// The objects are indexed in the order of their creation.
+// BaseT must have a virtual destructor if it is used for derived objects.
+template <typename BaseT, size_t CHUNK_SIZE = 64 * 1024>
+class Arena {
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    std::vector<BaseT *> _objects;
+    char *_cur{nullptr};
+    size_t _left{0};
+    size_t _used{0};
+    size_t _allocated{0};
+
+    void *_allocate(size_t size, size_t align) {
+        size_t pad = reinterpret_cast<uintptr_t>(_cur) % align;
+        pad = pad == 0 ? 0 : align - pad;
+        if (_left < size + pad) {
+            // big objects get their own chunk
+            size_t chunk = size + align > CHUNK_SIZE ? size + align : CHUNK_SIZE;
+            _chunks.emplace_back(new char[chunk]);
+            _cur = _chunks.back().get();
+            _left = chunk;
+            _allocated += chunk;
+            pad = reinterpret_cast<uintptr_t>(_cur) % align;
+            pad = pad == 0 ? 0 : align - pad;
+        }
+
+        void *mem = _cur + pad;
+        _cur += size + pad;
+        _left -= size + pad;
+        _used += size;
+        return mem;
+    }
+
+    void _destroy() {
+        for (auto *o : _objects)
+            o->~BaseT();
+        _objects.clear();
+        _chunks.clear();
+        _cur = nullptr;
+        _left = _used = _allocated = 0;
+    }
+
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& rhs) noexcept { *this = std::move(rhs); }
+    Arena& operator=(Arena&& rhs) noexcept {
+        if (this != &rhs) {
+            _destroy();
+            _chunks.swap(rhs._chunks);
+            _objects.swap(rhs._objects);
+            std::swap(_cur, rhs._cur);
+            std::swap(_left, rhs._left);
+            std::swap(_used, rhs._used);
+            std::swap(_allocated, rhs._allocated);
+        }
+        return *this;
+    }
+
+    ~Arena() { _destroy(); }
+
+    template <typename T, typename... Args>
+    T *create(Args&&... args) {
+        T *obj = new (_allocate(sizeof(T), alignof(T)))
+                        T(std::forward<Args>(args)...);
+        _objects.push_back(obj);
+        return obj;
+    }
+
+    BaseT *operator[](size_t idx) const {
+        assert(idx < _objects.size());
+        return _objects[idx];
+    }
+
+    BaseT *back() const { return _objects.back(); }
+
+    size_t size() const { return _objects.size(); }
+    bool empty() const { return _objects.empty(); }
+
+    // bytes taken by the objects
+    size_t usedMemory() const { return _used; }
+    // bytes allocated by the arena
+    size_t allocatedMemory() const { return _allocated; }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_ARENA_H_
@@ -2,7 +2,10 @@
 #define _DG_CONTAINER_H_
 
 #include <set>
+#include <vector>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <algorithm>
 
 namespace dg {
@@ -39,6 +42,15 @@ public:
         return container.insert(n).second;
     }
 
+    // insert values from a sorted container. This is faster
+    // than inserting the values one by one
+    template <typename ContT>
+    void insertSorted(const ContT& values)
+    {
+        assert(std::is_sorted(values.begin(), values.end()));
+        container.insert(values.begin(), values.end());
+    }
+
     bool contains(ValueT n) const
     {
         return container.count(n) != 0;
@@ -54,11 +66,21 @@ public:
         container.clear();
     }
 
-    bool empty()
+    bool empty() const
     {
         return container.empty();
     }
 
+    // the set is always compact
+    void compact() {}
+
+    // estimate of the memory allocated by the container (a node
+    // of the red-black tree has three pointers and a color)
+    size_t memoryUsage() const
+    {
+        return container.size() * (sizeof(ValueT) + 4 * sizeof(void *));
+    }
+
     void swap(DGContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth)
     {
         container.swap(oth.container);
@@ -108,6 +130,142 @@ class EdgesContainer : public DGContainer<NodeT *, EXPECTED_EDGES_NUM>
 {
 };
 
+/// ------------------------------------------------------------------
+// - DGVectorContainer
+//
+//   The same interface as DGContainer, but the values are kept
+//   in a sorted vector. That takes much less memory than std::set
+//   (no node per element) and iterating over the values is fast.
+//   Inserting and erasing a single value is linear in the size
+//   of the container, so bigger batches of values should be inserted
+//   with insertSorted(). Iterators are invalidated by any modification.
+/// ------------------------------------------------------------------
+template <typename ValueT, unsigned int EXPECTED_ELEMENTS_NUM = 8>
+class DGVectorContainer
+{
+public:
+    using ContainerT = typename std::vector<ValueT>;
+    // do not allow changing the values via iterators,
+    // the same as with std::set
+    using iterator = typename ContainerT::const_iterator;
+    using const_iterator = typename ContainerT::const_iterator;
+    using size_type = typename ContainerT::size_type;
+
+    iterator begin() const { return container.begin(); }
+    iterator end() const { return container.end(); }
+
+    size_type size() const
+    {
+        return container.size();
+    }
+
+    bool insert(ValueT n)
+    {
+        // the values are often inserted in increasing order
+        if (container.empty() || container.back() < n) {
+            container.push_back(n);
+            return true;
+        }
+
+        auto it = std::lower_bound(container.begin(), container.end(), n);
+        if (*it == n)
+            return false;
+
+        container.insert(it, n);
+        return true;
+    }
+
+    // insert values from a sorted container. The values are merged
+    // in linear time and duplicate values are removed afterwards
+    template <typename ContT>
+    void insertSorted(const ContT& values)
+    {
+        assert(std::is_sorted(values.begin(), values.end()));
+        auto mid = container.size();
+        container.insert(container.end(), values.begin(), values.end());
+        std::inplace_merge(container.begin(), container.begin() + mid,
+                           container.end());
+        container.erase(std::unique(container.begin(), container.end()),
+                        container.end());
+    }
+
+    bool contains(ValueT n) const
+    {
+        return std::binary_search(container.begin(), container.end(), n);
+    }
+
+    size_t erase(ValueT n)
+    {
+        auto it = std::lower_bound(container.begin(), container.end(), n);
+        if (it == container.end() || *it != n)
+            return 0;
+
+        container.erase(it);
+        return 1;
+    }
+
+    void clear()
+    {
+        container.clear();
+    }
+
+    bool empty() const
+    {
+        return container.empty();
+    }
+
+    // release the memory that is reserved for future insertions.
+    // Call it when no more values are going to be inserted.
+    void compact()
+    {
+        if (container.capacity() != container.size())
+            ContainerT(container.begin(), container.end()).swap(container);
+    }
+
+    size_t memoryUsage() const
+    {
+        return container.capacity() * sizeof(ValueT);
+    }
+
+    void swap(DGVectorContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth)
+    {
+        container.swap(oth.container);
+    }
+
+    void intersect(const DGVectorContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth)
+    {
+        ContainerT tmp;
+        std::set_intersection(container.begin(), container.end(),
+                              oth.container.begin(), oth.container.end(),
+                              std::back_inserter(tmp));
+        container.swap(tmp);
+    }
+
+    bool operator==(const DGVectorContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth) const
+    {
+        return container == oth.container;
+    }
+
+    bool operator!=(const DGVectorContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth) const
+    {
+        return !operator==(oth);
+    }
+
+private:
+    ContainerT container;
+};
+
+// Containers for the dependence edges of nodes. The sorted vectors
+// take much less memory, but the std::set is used by default, because
+// inserting edges one by one into nodes with many edges is slow.
+#ifdef DG_VECTOR_EDGES
+template <typename NodeT, unsigned int EXPECTED_EDGES_NUM = 4>
+using NodeEdgesContainer = DGVectorContainer<NodeT *, EXPECTED_EDGES_NUM>;
+#else
+template <typename NodeT, unsigned int EXPECTED_EDGES_NUM = 4>
+using NodeEdgesContainer = EdgesContainer<NodeT, EXPECTED_EDGES_NUM>;
+#endif
+
 } // namespace dg
 
 #endif // _DG_CONTAINER_H_
@@ -0,0 +1,201 @@
+#ifndef DG_HASH_INDEXED_MAP_H_
+#define DG_HASH_INDEXED_MAP_H_
+
+#include <map>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+namespace dg {
+namespace ADT {
+
+///
+// std::map with a hash index for looking up the keys.
+// The elements are stored (and iterated) in the std::map,
+// so the iteration is ordered as with the std::map,
+// but find() and friends take constant time on average.
+// The index is an open-addressing table (with linear probing)
+// of iterators into the map, so it needs only one word and a flag
+// for every slot.
+template <typename Key, typename T>
+class HashIndexedMap {
+    using MapT = std::map<Key, T>;
+
+public:
+    using key_type = typename MapT::key_type;
+    using mapped_type = typename MapT::mapped_type;
+    using value_type = typename MapT::value_type;
+    using size_type = typename MapT::size_type;
+    using iterator = typename MapT::iterator;
+    using const_iterator = typename MapT::const_iterator;
+
+private:
+    struct Slot {
+        iterator it{};
+        bool used{false};
+    };
+
+    MapT _map;
+    // the size of the index is 0 or a power of 2
+    std::vector<Slot> _index;
+
+    static size_t _hash(const Key& key) {
+        // mix the bits, pointers have the lowest bits zero
+        uint64_t h = std::hash<Key>()(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    size_t _mask() const { return _index.size() - 1; }
+
+    // return the slot with the key or the empty slot where
+    // the key would be placed
+    size_t _slot(const Key& key) const {
+        assert(!_index.empty());
+        size_t i = _hash(key) & _mask();
+        while (_index[i].used && _index[i].it->first != key)
+            i = (i + 1) & _mask();
+        return i;
+    }
+
+    void _rehash(size_t size) {
+        _index.assign(size, Slot());
+        for (auto it = _map.begin(), et = _map.end(); it != et; ++it) {
+            auto& slot = _index[_slot(it->first)];
+            slot.it = it;
+            slot.used = true;
+        }
+    }
+
+    void _addToIndex(iterator it) {
+        // keep the load factor at most 3/4
+        if (_map.size() * 4 > _index.size() * 3)
+            _rehash(_index.empty() ? 16 : _index.size() * 2);
+        else {
+            auto& slot = _index[_slot(it->first)];
+            assert(!slot.used);
+            slot.it = it;
+            slot.used = true;
+        }
+    }
+
+    void _removeFromIndex(const Key& key) {
+        size_t i = _slot(key);
+        assert(_index[i].used && "The key is not in the index");
+        // shift back the following elements from the same cluster,
+        // so that we do not need tombstones
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & _mask();
+            if (!_index[j].used)
+                break;
+            size_t ideal = _hash(_index[j].it->first) & _mask();
+            // can the element at j be moved to i?
+            if (((j - ideal) & _mask()) >= ((j - i) & _mask())) {
+                _index[i] = _index[j];
+                i = j;
+            }
+        }
+        _index[i].used = false;
+    }
+
+public:
+    HashIndexedMap() = default;
+    HashIndexedMap(HashIndexedMap&&) = default;
+    HashIndexedMap& operator=(HashIndexedMap&&) = default;
+
+    // the index points to the elements of the original map,
+    // so it must be built again for a copy
+    HashIndexedMap(const HashIndexedMap& rhs) : _map(rhs._map) {
+        _rehash(rhs._index.size());
+    }
+
+    HashIndexedMap& operator=(const HashIndexedMap& rhs) {
+        if (this != &rhs) {
+            _map = rhs._map;
+            _rehash(rhs._index.size());
+        }
+        return *this;
+    }
+
+    iterator begin() { return _map.begin(); }
+    iterator end() { return _map.end(); }
+    const_iterator begin() const { return _map.begin(); }
+    const_iterator end() const { return _map.end(); }
+
+    size_type size() const { return _map.size(); }
+    bool empty() const { return _map.empty(); }
+
+    void clear() {
+        _map.clear();
+        _index.clear();
+    }
+
+    iterator find(const Key& key) {
+        if (_map.empty())
+            return _map.end();
+        const auto& slot = _index[_slot(key)];
+        return slot.used ? slot.it : _map.end();
+    }
+
+    const_iterator find(const Key& key) const {
+        if (_map.empty())
+            return _map.end();
+        const auto& slot = _index[_slot(key)];
+        return slot.used ? const_iterator(slot.it) : _map.end();
+    }
+
+    size_type count(const Key& key) const { return find(key) != end(); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        auto ret = _map.emplace(std::forward<Args>(args)...);
+        if (ret.second)
+            _addToIndex(ret.first);
+        return ret;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return emplace(value);
+    }
+
+    T& operator[](const Key& key) {
+        auto it = find(key);
+        if (it != end())
+            return it->second;
+        return emplace(key, T()).first->second;
+    }
+
+    iterator erase(const_iterator it) {
+        assert(it != end());
+        _removeFromIndex(it->first);
+        return _map.erase(it);
+    }
+
+    iterator erase(iterator it) {
+        return erase(const_iterator(it));
+    }
+
+    size_type erase(const Key& key) {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    // memory taken by the index
+    size_t indexMemoryUsage() const {
+        return _index.capacity() * sizeof(Slot);
+    }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_HASH_INDEXED_MAP_H_
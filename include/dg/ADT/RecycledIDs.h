@@ -0,0 +1,46 @@
+#ifndef DG_ADT_RECYCLED_IDS_H_
+#define DG_ADT_RECYCLED_IDS_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+///
+// Numbers 1, 2, ... for objects that are used as indices. The number
+// of a released object is given to the next acquiring object, so the
+// numbers stay smaller than the greatest number of objects that existed
+// at once, no matter how many objects were created and destroyed before
+// (e.g. when more programs are analyzed one after another).
+// The numbers may be acquired and released from more threads at once.
+class RecycledIDs {
+    std::mutex _lock;
+    std::vector<unsigned> _released;
+    std::atomic<unsigned> _max{0};
+
+public:
+    unsigned acquire() {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_released.empty())
+            return ++_max;
+
+        unsigned id = _released.back();
+        _released.pop_back();
+        return id;
+    }
+
+    void release(unsigned id) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _released.push_back(id);
+    }
+
+    // the greatest number given so far
+    unsigned getMax() const { return _max.load(std::memory_order_relaxed); }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_RECYCLED_IDS_H_
@@ -1,12 +1,14 @@
 #ifndef DG_BBLOCK_BASE_H_
 #define DG_BBLOCK_BASE_H_
 
+#include <atomic>
 #include <vector>
 
 namespace dg {
 
 class BBlockId {
-    static unsigned idcnt;
+    // blocks may be created from more threads (more graphs at once)
+    static std::atomic<unsigned> idcnt;
     unsigned id;
 public:
     BBlockId() : id(++idcnt) {}
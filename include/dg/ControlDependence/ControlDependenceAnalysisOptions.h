@@ -9,16 +9,26 @@ struct ControlDependenceAnalysisOptions : AnalysisOptions {
     // FIXME: add options class for CD
     enum class CDAlgorithm {
         STANDARD,
-        NTSCD
-    } algorithm;
+        NTSCD,
+        // the same dependencies as NTSCD, but computed by
+        // the algorithm that visits only the relevant blocks
+        NTSCD2
+    } algorithm{CDAlgorithm::STANDARD};
 
     // take into account interprocedural control dependencies
     // (raising e.g., from calls to exit() which terminates the program)
     bool interprocedural{true};
 
+    // in the legacy dependence graph, add the control dependencies
+    // between basic blocks instead of adding an edge to every instruction
+    // of the dependent block (the standard CD is always added this way)
+    bool blockEdges{false};
+
     bool standardCD() const { return algorithm == CDAlgorithm::STANDARD; }
     bool ntscdCD() const { return algorithm == CDAlgorithm::NTSCD; }
+    bool ntscd2CD() const { return algorithm == CDAlgorithm::NTSCD2; }
     bool interproceduralCD() const { return interprocedural; }
+    bool blockEdgesCD() const { return blockEdges; }
 };
 
 } // namespace dg
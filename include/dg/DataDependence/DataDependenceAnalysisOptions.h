@@ -109,6 +109,11 @@ struct DataDependenceAnalysisOptions : AnalysisOptions {
     // or just objects?
     bool fieldInsensitive{false};
 
+    // Place phi nodes eagerly into iterated dominance frontiers
+    // of the blocks that define the memory (computed once
+    // per procedure) instead of creating them on demand
+    bool eagerPhiPlacement{false};
+
     bool undefinedArePure() const { return undefinedFunsBehavior == dda::PURE; }
     bool undefinedFunsWriteAny() const { return undefinedFunsBehavior & dda::WRITE_ANY; }
     bool undefinedFunsReadAny() const { return undefinedFunsBehavior & dda::READ_ANY; }
@@ -9,6 +9,7 @@
 
 #include "BBlock.h"
 #include "ADT/DGContainer.h"
+#include "ADT/HashIndexedMap.h"
 #include "Node.h"
 
 namespace dg {
@@ -82,12 +83,23 @@ public:
     // type of this dependence graph - so that we can refer to it in the code
     using DependenceGraphT = typename NodeT::DependenceGraphType;
 
+    // The nodes and blocks are iterated in the order of their keys.
+    // With DG_HASH_NODES, the maps have also a hash index,
+    // so that looking up the nodes takes constant time.
+#ifdef DG_HASH_NODES
+    using ContainerType = ADT::HashIndexedMap<KeyT, NodeT *>;
+#else
     using ContainerType = std::map<KeyT, NodeT *>;
+#endif
     using iterator = typename ContainerType::iterator;
     using const_iterator = typename ContainerType::const_iterator;
 #ifdef ENABLE_CFG
+#ifdef DG_HASH_NODES
+    using BBlocksMapT = ADT::HashIndexedMap<KeyT, BBlock<NodeT> *>;
+#else
     using BBlocksMapT = std::map<KeyT, BBlock<NodeT> *>;
 #endif
+#endif
 
 private:
     // entry and exit nodes of the graph
@@ -0,0 +1,208 @@
+#ifndef DG_DOMINATOR_TREE_H_
+#define DG_DOMINATOR_TREE_H_
+
+#include <vector>
+#include <unordered_map>
+
+namespace dg {
+
+///
+// Dominator tree and dominance frontiers of the blocks
+// reachable from the given entry block. BBlockT is any block
+// derived from BBlockBase (it needs successors and predecessors).
+//
+// Dominators are computed using the iterative algorithm due:
+//
+// K. D. Cooper, T. J. Harvey, and K. Kennedy. 2001.
+// A Simple, Fast Dominance Algorithm.
+// Software Practice and Experience 4, 1-10.
+//
+// and dominance frontiers are computed using the algorithm
+// from the same paper (that walks up the dominator tree
+// from the predecessors of join points).
+//
+template <typename BBlockT>
+class DominatorTree {
+    enum : unsigned { UNDEFINED = ~0U };
+
+    // blocks in reverse post-order
+    std::vector<BBlockT *> _blocks;
+    // block -> its index in _blocks
+    std::unordered_map<const BBlockT *, unsigned> _index;
+    // index of the immediate dominator (the entry is its own idom)
+    std::vector<unsigned> _idom;
+    std::vector<std::vector<unsigned>> _frontiers;
+
+    unsigned getIndex(const BBlockT *block) const {
+        auto it = _index.find(block);
+        return it == _index.end() ? UNDEFINED : it->second;
+    }
+
+    void computeReversePostorder(BBlockT *entry) {
+        std::vector<BBlockT *> postorder;
+        // stack of (block, index of the next successor to visit)
+        std::vector<std::pair<BBlockT *, size_t>> stack;
+
+        _index.emplace(entry, UNDEFINED);
+        stack.emplace_back(entry, 0);
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            auto *block = top.first;
+            if (block->succ_begin() + top.second != block->succ_end()) {
+                auto *succ = *(block->succ_begin() + top.second);
+                ++top.second;
+                if (_index.emplace(succ, UNDEFINED).second) {
+                    stack.emplace_back(succ, 0);
+                }
+            } else {
+                postorder.push_back(block);
+                stack.pop_back();
+            }
+        }
+
+        _blocks.assign(postorder.rbegin(), postorder.rend());
+        for (unsigned i = 0; i < _blocks.size(); ++i) {
+            _index[_blocks[i]] = i;
+        }
+    }
+
+    unsigned intersect(unsigned a, unsigned b) const {
+        while (a != b) {
+            while (a > b)
+                a = _idom[a];
+            while (b > a)
+                b = _idom[b];
+        }
+        return a;
+    }
+
+    void computeIDoms() {
+        _idom.assign(_blocks.size(), UNDEFINED);
+        _idom[0] = 0;
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (unsigned i = 1; i < _blocks.size(); ++i) {
+                auto *block = _blocks[i];
+                unsigned newidom = UNDEFINED;
+                for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I) {
+                    auto p = getIndex(*I);
+                    if (p == UNDEFINED || _idom[p] == UNDEFINED)
+                        continue; // unreachable or not processed yet
+                    newidom = newidom == UNDEFINED ? p : intersect(p, newidom);
+                }
+
+                if (_idom[i] != newidom) {
+                    _idom[i] = newidom;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    void computeFrontiers() {
+        _frontiers.assign(_blocks.size(), {});
+        for (unsigned i = 0; i < _blocks.size(); ++i) {
+            auto *block = _blocks[i];
+            if (block->pred_end() - block->pred_begin() < 2)
+                continue;
+
+            for (auto I = block->pred_begin(), E = block->pred_end(); I != E; ++I) {
+                auto runner = getIndex(*I);
+                if (runner == UNDEFINED)
+                    continue;
+
+                while (runner != _idom[i]) {
+                    auto& DF = _frontiers[runner];
+                    // we process the frontiers of 'block' together,
+                    // so a duplicate can be only the last element
+                    if (DF.empty() || DF.back() != i)
+                        DF.push_back(i);
+                    if (runner == 0)
+                        break; // the entry has no dominator
+                    runner = _idom[runner];
+                }
+            }
+        }
+    }
+
+public:
+    void compute(BBlockT *entry) {
+        _blocks.clear();
+        _index.clear();
+
+        computeReversePostorder(entry);
+        computeIDoms();
+        computeFrontiers();
+    }
+
+    bool isReachable(const BBlockT *block) const {
+        return getIndex(block) != UNDEFINED;
+    }
+
+    // return nullptr for the entry and for unreachable blocks
+    BBlockT *getIDom(const BBlockT *block) const {
+        auto i = getIndex(block);
+        if (i == UNDEFINED || i == 0)
+            return nullptr;
+        return _blocks[_idom[i]];
+    }
+
+    std::vector<BBlockT *> getFrontiers(const BBlockT *block) const {
+        std::vector<BBlockT *> ret;
+        auto i = getIndex(block);
+        if (i == UNDEFINED)
+            return ret;
+
+        ret.reserve(_frontiers[i].size());
+        for (auto f : _frontiers[i])
+            ret.push_back(_blocks[f]);
+        return ret;
+    }
+
+    ///
+    // Return the iterated dominance frontier of the given blocks,
+    // i.e., the blocks where phi nodes must be placed for a variable
+    // that is defined in the given blocks.
+    template <typename ContT>
+    std::vector<BBlockT *> getIteratedFrontiers(const ContT& blocks) const {
+        std::vector<BBlockT *> ret;
+        std::vector<bool> inIDF(_blocks.size());
+        std::vector<bool> queued(_blocks.size());
+        std::vector<unsigned> worklist;
+
+        for (const BBlockT *block : blocks) {
+            auto i = getIndex(block);
+            if (i != UNDEFINED && !queued[i]) {
+                queued[i] = true;
+                worklist.push_back(i);
+            }
+        }
+
+        while (!worklist.empty()) {
+            auto i = worklist.back();
+            worklist.pop_back();
+
+            for (auto f : _frontiers[i]) {
+                if (inIDF[f])
+                    continue;
+
+                inIDF[f] = true;
+                ret.push_back(_blocks[f]);
+                if (!queued[f]) {
+                    queued[f] = true;
+                    worklist.push_back(f);
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    size_t size() const { return _blocks.size(); }
+};
+
+} // namespace dg
+
+#endif // DG_DOMINATOR_TREE_H_
@@ -13,12 +13,14 @@
 #include "dg/MemorySSA/DefinitionsMap.h"
 
 #include "dg/ReadWriteGraph/ReadWriteGraph.h"
+#include "dg/Dominators/DominatorTree.h"
 
 #include "dg/ADT/Queue.h"
 #include "dg/util/debug.h"
 
 #include "Definitions.h"
 #include "ModRef.h"
+#include "ModRefSummaries.h"
 
 namespace dg {
 namespace dda {
@@ -28,6 +30,9 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
     class BBlockInfo {
         Definitions definitions{};
         RWNodeCall *call{nullptr};
+        // phi nodes placed at the beginning of the block
+        // by the eager phi placement
+        DefinitionsMap<RWNode> entryPhis{};
 
     public:
         void setCallBlock(RWNodeCall *c) { call = c; }
@@ -37,10 +42,14 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
 
         Definitions& getDefinitions() { return definitions; }
         const Definitions& getDefinitions() const { return definitions; }
+
+        DefinitionsMap<RWNode>& getEntryPhis() { return entryPhis; }
+        const DefinitionsMap<RWNode>& getEntryPhis() const { return entryPhis; }
     };
 
     class SubgraphInfo {
-        std::unordered_map<RWBBlock *, BBlockInfo> _bblock_infos;
+        // indexed by the index of the block in the subgraph
+        std::vector<BBlockInfo> _bblock_infos;
 
         class Summary {
         public:
@@ -56,9 +65,9 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
             void addInput(const DefSite& ds, RWNode *n) { inputs.add(ds, n); }
             void addOutput(const DefSite& ds, RWNode *n) { outputs.add(ds, n); }
 
-            RWNode *getUnknownPhi() {
+            RWNode *getUnknownPhi(RWNode *unknown) {
                 // FIXME: optimize this, we create std::set for nothing...
-                auto S = inputs.get({UNKNOWN_MEMORY, 0, Offset::UNKNOWN});
+                auto S = inputs.get({unknown, 0, Offset::UNKNOWN});
                 if (S.empty()) {
                     return nullptr;
                 }
@@ -76,7 +85,19 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
         // effects of the procedure
         ModRefInfo modref;
 
-        SubgraphInfo(RWSubgraph *s);
+        // information for the eager phi placement
+        DominatorTree<RWBBlock> dominators;
+        bool phisPlaced{false};
+        // some block writes to unknown memory, so we know
+        // where to place phi nodes only for 'phiTargets'
+        bool hasUnknownWrites{false};
+        std::set<const RWNode *> phiTargets;
+
+        // can we search the definitions of 'target' by walking
+        // the dominator tree (i.e., are there all phi nodes for it)?
+        bool hasPhisFor(const RWNode *target) const {
+            return phisPlaced && (!hasUnknownWrites || phiTargets.count(target) > 0);
+        }
 
         friend class MemorySSATransformation;
 
@@ -85,10 +106,13 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
 
         Summary& getSummary() { return summary; }
         const Summary& getSummary() const { return summary; }
-        BBlockInfo& getBBlockInfo(RWBBlock *b) { return _bblock_infos[b]; }
+        BBlockInfo& getBBlockInfo(RWBBlock *b) {
+            assert(b->getIndex() < _bblock_infos.size());
+            return _bblock_infos[b->getIndex()];
+        }
         const BBlockInfo *getBBlockInfo(RWBBlock *b) const {
-            auto it = _bblock_infos.find(b);
-            return it == _bblock_infos.end() ? nullptr : &it->second;
+            return b->getIndex() < _bblock_infos.size() ?
+                    &_bblock_infos[b->getIndex()] : nullptr;
         }
     };
 
@@ -185,8 +209,27 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
                                        RWNode *calledValue);
 
     void computeModRef(RWSubgraph *subg, SubgraphInfo& si);
+
+    ///
+    // Eager phi placement: place phi nodes for all memory defined
+    // in the subgraph into the iterated dominance frontiers of the
+    // defining blocks and find their operands. Must be done before
+    // performing LVN in any block of the subgraph.
+    void placePhis(RWSubgraph *subg, SubgraphInfo& si);
+    void placePhis(RWBBlock *block) {
+        if (options.eagerPhiPlacement) {
+            auto *subg = block->getSubgraph();
+            placePhis(subg, getSubgraphInfo(subg));
+        }
+    }
     bool callMayDefineTarget(RWNodeCall *C, RWNode *target);
 
+    // Compute fingerprints of everything the mod/ref information
+    // of subgraphs depends on. The fingerprint is 0 if some of
+    // the involved nodes has no stable name.
+    std::unordered_map<const RWSubgraph *, uint64_t>
+    computeModRefFingerprints(const RWNodeNaming& naming);
+
     RWNode *createPhi(const DefSite& ds, RWNodeType type = RWNodeType::PHI);
     RWNode *createPhi(Definitions& D, const DefSite& ds, RWNodeType type = RWNodeType::PHI);
     RWNode *createAndPlacePhi(RWBBlock *block, const DefSite& ds);
@@ -197,14 +240,18 @@ class MemorySSATransformation : public DataDependenceAnalysisImpl {
 
     std::vector<RWNode *> _phis;
     dg::ADT::QueueLIFO<RWNode> _queue;
-    std::unordered_map<const RWSubgraph *, SubgraphInfo> _subgraphs_info;
+    // indexed by the index of the subgraph, created in initialize()
+    std::vector<SubgraphInfo> _subgraphs_info;
 
     Definitions& getBBlockDefinitions(RWBBlock *b, const DefSite *ds = nullptr);
 
-    SubgraphInfo& getSubgraphInfo(const RWSubgraph *s) { return _subgraphs_info[s]; }
+    SubgraphInfo& getSubgraphInfo(const RWSubgraph *s) {
+        assert(s->getIndex() < _subgraphs_info.size());
+        return _subgraphs_info[s->getIndex()];
+    }
     const SubgraphInfo *getSubgraphInfo(const RWSubgraph *s) const {
-        auto it = _subgraphs_info.find(s);
-        return it == _subgraphs_info.end() ? nullptr : &it->second;
+        return s->getIndex() < _subgraphs_info.size() ?
+                &_subgraphs_info[s->getIndex()] : nullptr;
     }
     BBlockInfo& getBBlockInfo(RWBBlock *b) {
         return getSubgraphInfo(b->getSubgraph()).getBBlockInfo(b);
@@ -251,6 +298,19 @@ public:
         return bi ? &bi->getDefinitions() : nullptr;
     }
 
+    ///
+    // Reuse the stored mod/ref summaries of subgraphs that are still valid
+    // and compute and store into 'summaries' the rest of them.
+    // Must be called after run() and before searching any definitions
+    // (so that the summaries are computed from the original graph).
+    // Subgraphs that contain nodes without a stable name are skipped.
+    // Return the number of reused summaries.
+    unsigned updateModRefSummaries(ModRefSummaries& summaries,
+                                   const RWNodeNaming& naming);
+
+    // the number of phi nodes created so far
+    size_t getPhisNum() const { return _phis.size(); }
+
     const SubgraphInfo::Summary *getSummary(const RWSubgraph *s) const {
         auto si = getSubgraphInfo(s);
         if (!si)
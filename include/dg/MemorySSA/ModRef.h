@@ -76,13 +76,13 @@ public:
     // Check whether the procedure may define 'n' (ignoring writes
     // to unknown memory, \see mayDefineOrUnknown())
     bool mayDefine(RWNode *n) const { return maydef.definesTarget(n); }
-    bool mayDefineUnknown() const { return mayDefine(UNKNOWN_MEMORY); }
 
     ///
     // Check whether the procedure may define 'n', taking into
-    // account also writes to unknown memory
-    bool mayDefineOrUnknown(RWNode *n) const {
-        return mayDefine(n) or mayDefineUnknown();
+    // account also writes to unknown memory. 'unknown' is
+    // the unknown memory of the graph.
+    bool mayDefineOrUnknown(RWNode *n, RWNode *unknown) const {
+        return mayDefine(n) or mayDefine(unknown);
     }
 
     auto getMayDef(RWNode *n) -> decltype(maydef.get(n)) {
@@ -0,0 +1,86 @@
+#ifndef DG_MOD_REF_SUMMARIES_H_
+#define DG_MOD_REF_SUMMARIES_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+#include "dg/Offset.h"
+
+namespace dg {
+namespace dda {
+
+class RWNode;
+
+///
+// Mapping between nodes of the read-write graph and names that
+// are stable across runs of the analysis (e.g., names of globals
+// or positions of instructions in the program). It is provided
+// by the front-end that built the graph.
+class RWNodeNaming {
+public:
+    virtual ~RWNodeNaming() = default;
+
+    // return an empty string if the node has no stable name
+    virtual std::string getName(const RWNode *node) const = 0;
+    // return nullptr if there is no node with the given name
+    virtual RWNode *getNode(const std::string& name) const = 0;
+};
+
+///
+// Mod/ref summaries of procedures that can be stored and reused
+// in later runs of the analysis. A summary is keyed by the name
+// of the procedure and by a fingerprint of everything its mod/ref
+// information is computed from (the memory accesses of the procedure
+// and of all procedures it may call), so a stored summary is reused
+// only if it is still valid. Only the last summary of each procedure
+// is kept, storing a summary with a new fingerprint evicts the old one.
+class ModRefSummaries {
+public:
+    // bytes [start, end] of the memory 'target' accessed by 'nodes'
+    struct Entry {
+        std::string target;
+        Offset start;
+        Offset end;
+        std::vector<std::string> nodes;
+    };
+
+    struct Summary {
+        std::vector<Entry> maydef;
+        std::vector<Entry> mayref;
+        std::vector<Entry> mustdef;
+    };
+
+private:
+    using FingerprintedSummary = std::pair<uint64_t, Summary>;
+    std::map<std::string, FingerprintedSummary> _summaries;
+
+public:
+    const Summary *get(const std::string& fun, uint64_t fingerprint) const {
+        auto it = _summaries.find(fun);
+        if (it == _summaries.end() || it->second.first != fingerprint)
+            return nullptr;
+        return &it->second.second;
+    }
+
+    void set(const std::string& fun, uint64_t fingerprint, Summary&& s) {
+        _summaries[fun] = FingerprintedSummary{fingerprint, std::move(s)};
+    }
+
+    size_t size() const { return _summaries.size(); }
+    bool empty() const { return _summaries.empty(); }
+    void clear() { _summaries.clear(); }
+
+    // read summaries from the stream and add them to this object,
+    // return false if the input is malformed
+    bool read(std::istream& in);
+    void write(std::ostream& out) const;
+};
+
+} // namespace dda
+} // namespace dg
+
+#endif // DG_MOD_REF_SUMMARIES_H_
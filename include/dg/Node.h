@@ -1,8 +1,14 @@
 #ifndef NODE_H_
 #define NODE_H_
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 #include "DGParameters.h"
 #include "ADT/DGContainer.h"
+#include "ADT/RecycledIDs.h"
 #include "legacy/Analysis.h"
 
 namespace dg {
@@ -22,7 +28,7 @@ template <typename DependenceGraphT, typename KeyT, typename NodeT>
 class Node
 {
 public:
-    using EdgesT = EdgesContainer<NodeT>;
+    using EdgesT = NodeEdgesContainer<NodeT>;
     using ControlEdgesT = EdgesT;
     using DataEdgesT = EdgesT;
     using UseEdgesT = EdgesT;
@@ -41,7 +47,20 @@ public:
     using interference_iterator = typename InterferenceEdges::iterator;
     using const_interference_iterator = typename InterferenceEdges::const_iterator;
 
-    Node(const KeyT& k) : key(k) {}
+    Node(const KeyT& k) : key(k), id(getIDs().acquire()) {}
+    ~Node() { getIDs().release(id); }
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    // unique number of the node (among the existing nodes of this type).
+    // The numbers are dense, the number of a destroyed node is given
+    // to the next created node, so they can be used as indices.
+    unsigned getID() const { return id; }
+    // the greatest ID given to a node so far. It is bounded by the
+    // greatest number of nodes that existed at once, not by the number
+    // of all nodes created (e.g. for more modules) in this process.
+    static unsigned getMaxID() { return getIDs().getMax(); }
 
     DependenceGraphT *setDG(DependenceGraphT *dg)
     {
@@ -72,6 +91,37 @@ public:
                                      dataDepEdges, n->revDataDepEdges);
     }
 
+    // add data dependence edges 'from'-->'to' for all pairs
+    // (from, to) in 'edges'. The edges are sorted and inserted
+    // in bulk, which is faster than adding them one by one.
+    static void addDataDependencies(std::vector<std::pair<NodeT *, NodeT *>>& edges)
+    {
+        std::vector<NodeT *> nodes;
+
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            NodeT *from = edges[i].first;
+            nodes.clear();
+            for (; i < edges.size() && edges[i].first == from; ++i)
+                nodes.push_back(edges[i].second);
+            from->dataDepEdges.insertSorted(nodes);
+        }
+
+        std::sort(edges.begin(), edges.end(),
+                  [](const std::pair<NodeT *, NodeT *>& a,
+                     const std::pair<NodeT *, NodeT *>& b) {
+                      return a.second < b.second ||
+                             (a.second == b.second && a.first < b.first);
+                  });
+        for (size_t i = 0; i < edges.size();) {
+            NodeT *to = edges[i].second;
+            nodes.clear();
+            for (; i < edges.size() && edges[i].second == to; ++i)
+                nodes.push_back(edges[i].first);
+            to->revDataDepEdges.insertSorted(nodes);
+        }
+    }
+
     // this node uses (e.g. like an operand) the node 'n'
     bool addUseDependence(NodeT *n)
     {
@@ -116,13 +166,13 @@ public:
     void removeOutcomingCDs()
     {
         while (!controlDepEdges.empty())
-            removeControlDependence(*controlDepEdges.begin());
+            removeControlDependence(_last(controlDepEdges));
     }
 
     void removeIncomingCDs()
     {
         while (!revControlDepEdges.empty()) {
-            NodeT *cd = *revControlDepEdges.begin();
+            NodeT *cd = _last(revControlDepEdges);
             // this will remove the reverse control dependence from
             // this node
             cd->removeControlDependence(static_cast<NodeT *>(this));
@@ -138,13 +188,13 @@ public:
     void removeOutcomingDDs()
     {
         while (!dataDepEdges.empty())
-            removeDataDependence(*dataDepEdges.begin());
+            removeDataDependence(_last(dataDepEdges));
     }
 
     void removeIncomingDDs()
     {
         while (!revDataDepEdges.empty()) {
-            NodeT *cd = *revDataDepEdges.begin();
+            NodeT *cd = _last(revDataDepEdges);
             // this will remove the reverse control dependence from
             // this node
             cd->removeDataDependence(static_cast<NodeT *>(this));
@@ -161,13 +211,13 @@ public:
     void removeOutcomingUses()
     {
         while (!useEdges.empty())
-            removeUseDependence(*useEdges.begin());
+            removeUseDependence(_last(useEdges));
     }
 
     void removeIncomingUses()
     {
         while (!userEdges.empty()) {
-            NodeT *cd = *userEdges.begin();
+            NodeT *cd = _last(userEdges);
             // this will remove the reverse control dependence from
             // this node
             cd->removeUseDependence(static_cast<NodeT *>(this));
@@ -281,6 +331,28 @@ public:
     size_t getUseDependenciesNum() const { return useEdges.size(); }
     size_t getUserDependenciesNum() const { return userEdges.size(); }
 
+    // release the memory reserved for adding new edges
+    void compactEdges()
+    {
+        controlDepEdges.compact();
+        dataDepEdges.compact();
+        useEdges.compact();
+        interferenceDepEdges.compact();
+        revControlDepEdges.compact();
+        revDataDepEdges.compact();
+        userEdges.compact();
+        revInterferenceDepEdges.compact();
+    }
+
+    // memory allocated by the containers of edges
+    size_t getEdgesMemoryUsage() const
+    {
+        return controlDepEdges.memoryUsage() + dataDepEdges.memoryUsage() +
+               useEdges.memoryUsage() + interferenceDepEdges.memoryUsage() +
+               revControlDepEdges.memoryUsage() + revDataDepEdges.memoryUsage() +
+               userEdges.memoryUsage() + revInterferenceDepEdges.memoryUsage();
+    }
+
 #ifdef ENABLE_CFG
     BBlock<NodeT> *getBBlock() { return basicBlock; }
     const BBlock<NodeT> *getBBlock() const { return basicBlock; }
@@ -365,6 +437,13 @@ protected:
 
 private:
 
+    // the edges are removed from the back, which is cheap
+    // also for the containers that are vectors
+    static NodeT *_last(const EdgesT& cont)
+    {
+        return *std::prev(cont.end());
+    }
+
     // add an edge 'ths' --> 'n' to containers of 'ths' and 'n'
     static bool _addBidirectionalEdge(NodeT *ths, NodeT *n,
                                       EdgesT& ths_cont, EdgesT& n_cont) {
@@ -415,6 +494,16 @@ private:
     // id of the slice this nodes is in. If it is 0, it is in no slice
     uint32_t slice_id{0};
 
+    unsigned id;
+
+    // nodes may be created from more threads (more graphs at once).
+    // The pool of IDs is never destroyed, because nodes may be destroyed
+    // after static objects.
+    static ADT::RecycledIDs& getIDs() {
+        static auto *ids = new ADT::RecycledIDs();
+        return *ids;
+    }
+
 #ifdef ENABLE_CFG
     // some analyses need classical CFG edges
     // and it is better to have even basic blocks
@@ -277,7 +277,8 @@ public:
             case PSNodeType::NULL_ADDR:
                 break;
             case PSNodeType::UNKNOWN_MEM:
-                // UNKNOWN_MEMLOC points to itself
+                // the unknown memory points to itself
+                // (set by the graph that owns it)
                 break;
             default:
                 // this constructor is for the above mentioned types only
@@ -744,6 +745,18 @@ public:
     friend class PSNodeFork;
 };
 
+inline bool Pointer::isNull() const {
+    return target->getType() == PSNodeType::NULL_ADDR;
+}
+
+inline bool Pointer::isUnknown() const {
+    return target->getType() == PSNodeType::UNKNOWN_MEM;
+}
+
+inline bool Pointer::isInvalidated() const {
+    return target->getType() == PSNodeType::INVALIDATED;
+}
+
 } // namespace pta
 } // namespace dg
 
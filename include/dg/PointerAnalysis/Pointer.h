@@ -3,6 +3,7 @@
 
 #include "dg/Offset.h"
 #include <cassert>
+#include <utility>
 
 namespace dg {
 namespace pta {
@@ -10,9 +11,17 @@ namespace pta {
 // declare PSNode
 class PSNode;
 
-extern PSNode *NULLPTR;
-extern PSNode *UNKNOWN_MEMORY;
-extern PSNode *INVALIDATED;
+// Process-wide special nodes from the time before every pointer graph
+// had its own (see PointerGraph::getNull(), getUnknownMemory() and
+// getInvalidated()). They are kept only so that old code compiles.
+// They are not part of any graph, so the analysis never uses them,
+// but pointers to them are still recognized by Pointer::isNull() etc.
+extern PSNode *NULLPTR
+    __attribute__((deprecated("use PointerGraph::getNull()")));
+extern PSNode *UNKNOWN_MEMORY
+    __attribute__((deprecated("use PointerGraph::getUnknownMemory()")));
+extern PSNode *INVALIDATED
+    __attribute__((deprecated("use PointerGraph::getInvalidated()")));
 
 struct Pointer
 {
@@ -36,10 +45,12 @@ struct Pointer
         return target == oth.target && offset == oth.offset;
     }
 
-    bool isNull() const { return target == NULLPTR; }
-    bool isUnknown() const { return target == UNKNOWN_MEMORY; }
+    // every pointer graph has its own special nodes, so we recognize
+    // them by their type (these are defined in PSNode.h)
+    inline bool isNull() const;
+    inline bool isUnknown() const;
     bool isValid() const { return !isNull() && !isUnknown(); }
-    bool isInvalidated() const { return target == INVALIDATED; }
+    inline bool isInvalidated() const;
 
 #ifndef NDEBUG
     void dump() const;
@@ -49,8 +60,52 @@ struct Pointer
 
 };
 
-extern const Pointer UnknownPointer;
-extern const Pointer NullPointer;
+// pointers to the deprecated special nodes above
+extern const Pointer UnknownPointer
+    __attribute__((deprecated("use PointerGraph::getUnknownPointer()")));
+extern const Pointer NullPointer
+    __attribute__((deprecated("use PointerGraph::getNullPointer()")));
+
+///
+// The special targets (null, unknown and invalidated memory) that
+// a points-to set contains. The sets update it whenever they add or
+// remove pointers, so that hasNull(), hasUnknown() and hasInvalidated()
+// do not need to search the set.
+class SpecialTargets {
+    enum : unsigned { HAS_NULL = 1, HAS_UNKNOWN = 2, HAS_INVALIDATED = 4 };
+    unsigned flags{0};
+
+    static unsigned flagsOf(const Pointer& ptr) {
+        return (ptr.isNull() ? HAS_NULL : 0) |
+               (ptr.isUnknown() ? HAS_UNKNOWN : 0) |
+               (ptr.isInvalidated() ? HAS_INVALIDATED : 0);
+    }
+
+public:
+    void add(const Pointer& ptr) { flags |= flagsOf(ptr); }
+    void add(const SpecialTargets& rhs) { flags |= rhs.flags; }
+    void clear() { flags = 0; }
+    void swap(SpecialTargets& rhs) { std::swap(flags, rhs.flags); }
+
+    ///
+    // Call after some pointers to 'target' were removed from the set 'S'.
+    // The set may still contain other pointers to 'target', so we must
+    // search it, but only if 'target' is a special node.
+    template <typename PointersT>
+    void removed(PSNode *target, const PointersT& S) {
+        if (flagsOf(Pointer(target, 0)) == 0)
+            return;
+
+        flags = 0;
+        for (const Pointer& ptr : S) {
+            add(ptr);
+        }
+    }
+
+    bool hasNull() const { return flags & HAS_NULL; }
+    bool hasUnknown() const { return flags & HAS_UNKNOWN; }
+    bool hasInvalidated() const { return flags & HAS_INVALIDATED; }
+};
 
 } // namespace pta
 } // namespace dg
@@ -13,12 +13,6 @@
 namespace dg {
 namespace pta {
 
-// special nodes and pointers to them
-extern PSNode *NULLPTR;
-extern PSNode *UNKNOWN_MEMORY;
-extern const Pointer NullPointer;
-extern const Pointer UnknownPointer;
-
 class PointerAnalysis
 {
     void initPointerAnalysis() {
@@ -127,14 +127,14 @@ public:
             }
         }
 
-        S.add(INVALIDATED, 0);
+        S.add(PG->getInvalidated(), 0);
         S1.swap(S);
     }
 
     static inline bool isInvalidTarget(const PSNode * const target) {
-        return  target == INVALIDATED ||
-                target == UNKNOWN_MEMORY ||
-                target == NULLPTR;
+        return  target->getType() == PSNodeType::INVALIDATED ||
+                target->getType() == PSNodeType::UNKNOWN_MEM ||
+                target->getType() == PSNodeType::NULL_ADDR;
     }
 
     bool handleInvalidateLocals(PSNode *node) {
@@ -188,7 +188,7 @@ public:
                 for (const auto& ptr : predS) {
                     PSNodeAlloc *alloc = PSNodeAlloc::get(ptr.target);
                     if (alloc && isLocal(alloc, node) && knownInstance(alloc)) {
-                        changed |= S.add(INVALIDATED, 0);
+                        changed |= S.add(PG->getInvalidated(), 0);
                     } else
                         changed |= S.add(ptr);
                 }
@@ -200,14 +200,14 @@ public:
         return changed;
     }
 
-    static void replaceTargetWithInv(PointsToSetT& S1, PSNode *target) {
+    void replaceTargetWithInv(PointsToSetT& S1, PSNode *target) {
         PointsToSetT S;
         for (const auto& ptr : S1) {
             if (ptr.target != target)
                 S.add(ptr);
         }
 
-        S.add(INVALIDATED, 0);
+        S.add(PG->getInvalidated(), 0);
         S1.swap(S);
     }
 
@@ -289,13 +289,13 @@ public:
         auto mo = getOrCreateMO(mm, target);
         if (mo->pointsTo.size() == 1) {
             auto& S = mo->pointsTo[0];
-            if (S.size() == 1 && (*S.begin()).target == INVALIDATED) {
+            if (S.size() == 1 && (*S.begin()).isInvalidated()) {
                 return false; // no update
             }
         }
 
         mo->pointsTo.clear();
-        mo->pointsTo[0].add(INVALIDATED, 0);
+        mo->pointsTo[0].add(PG->getInvalidated(), 0);
         return true;
     }
 
@@ -348,7 +348,7 @@ public:
                 if (invStrongUpdate(operand)) { // strong update
                     const auto& ptr = *(operand->pointsTo.begin());
                     if (ptr.isUnknown())
-                        changed |= it.second.add(INVALIDATED, 0);
+                        changed |= it.second.add(PG->getInvalidated(), 0);
                     else if (ptr.isNull() || ptr.isInvalidated())
                         continue;
                     else if (it.second.pointsToTarget(ptr.target)) {
@@ -364,7 +364,7 @@ public:
                         // invalidate on unknown memory yields invalidate for
                         // each element
                         if (ptr.isUnknown() || it.second.pointsToTarget(ptr.target)) {
-                            changed |= it.second.add(INVALIDATED, 0);
+                            changed |= it.second.add(PG->getInvalidated(), 0);
                         }
                     }
                 }
@@ -393,7 +393,7 @@ public:
                             // on this invalidated memory
                             changed |= S.add(ptr);
                         }
-                        changed |= S.add(INVALIDATED, 0);
+                        changed |= S.add(PG->getInvalidated(), 0);
                     } else {
                         // this is a pointer to some memory that was not
                         // invalidated, so merge it into the points-to set
@@ -19,12 +19,6 @@
 namespace dg {
 namespace pta {
 
-// special nodes and pointers to them
-extern PSNode *NULLPTR;
-extern PSNode *UNKNOWN_MEMORY;
-extern const Pointer NullPointer;
-extern const Pointer UnknownPointer;
-
 class PointerGraph;
 
 // A single procedure in Pointer Graph
@@ -129,6 +123,14 @@ class PointerGraph
     using NodesT = std::vector<std::unique_ptr<PSNode>>;
     using SubgraphsT = std::vector<std::unique_ptr<PointerSubgraph>>;
 
+    // the special nodes representing null, unknown memory and
+    // invalidated memory. Every graph has its own (the nodes record
+    // their users) and they are allocated separately, so that they
+    // stay at their place when the graph is moved.
+    std::unique_ptr<PSNode> _nullptr{new PSNode(PSNodeType::NULL_ADDR)};
+    std::unique_ptr<PSNode> _unknown{new PSNode(PSNodeType::UNKNOWN_MEM)};
+    std::unique_ptr<PSNode> _invalidated{new PSNode(PSNodeType::INVALIDATED)};
+
     NodesT nodes;
     SubgraphsT _subgraphs;
 
@@ -141,10 +143,8 @@ class PointerGraph
     GenericCallGraph<PSNode *> callGraph;
 
     void initStaticNodes() {
-        NULLPTR->pointsTo.clear();
-        UNKNOWN_MEMORY->pointsTo.clear();
-        NULLPTR->pointsTo.add(Pointer(NULLPTR, 0));
-        UNKNOWN_MEMORY->pointsTo.add(Pointer(UNKNOWN_MEMORY, Offset::UNKNOWN));
+        _nullptr->pointsTo.add(getNullPointer());
+        _unknown->pointsTo.add(getUnknownPointer());
     }
 
     NodesT _globals;
@@ -272,6 +272,15 @@ public:
     PointerGraph(const PointerGraph&) = delete;
     PointerGraph operator=(const PointerGraph&) = delete;
 
+    PSNode *getNull() const { return _nullptr.get(); }
+    PSNode *getUnknownMemory() const { return _unknown.get(); }
+    PSNode *getInvalidated() const { return _invalidated.get(); }
+
+    Pointer getNullPointer() const { return {getNull(), 0}; }
+    Pointer getUnknownPointer() const {
+        return {getUnknownMemory(), Offset::UNKNOWN};
+    }
+
     PointerSubgraph *getEntry() const { return _entry; }
     void setEntry(PointerSubgraph *e) {
 #if DEBUG_ENABLED
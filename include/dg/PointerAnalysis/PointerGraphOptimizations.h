@@ -84,8 +84,8 @@ class PSUnknownsReducer {
                         if (user->getType() == PSNodeType::LOAD) {
                             // replace the uses of the load value by unknown
                             // (this is what would happen in the analysis)
-                            user->replaceAllUsesWith(UNKNOWN_MEMORY);
-                            mapping.add(user, UNKNOWN_MEMORY);
+                            user->replaceAllUsesWith(PS->getUnknownMemory());
+                            mapping.add(user, PS->getUnknownMemory());
                         }
                         // store can be removed directly
                         user->isolate();
@@ -99,8 +99,8 @@ class PSUnknownsReducer {
             } else if (nd->getType() == PSNodeType::PHI && nd->getOperandsNum() == 0) {
                 for (PSNode *user : nd->getUsers()) {
                     // replace the uses of this value with unknown
-                    user->replaceAllUsesWith(UNKNOWN_MEMORY);
-                    mapping.add(user, UNKNOWN_MEMORY);
+                    user->replaceAllUsesWith(PS->getUnknownMemory());
+                    mapping.add(user, PS->getUnknownMemory());
 
                     // store can be removed directly
                     user->isolate();
@@ -20,8 +20,12 @@ class AlignedPointerIdPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> overflowSet;
-    static std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
-    static std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
+    SpecialTargets special;
+    // The IDs are numbered separately in every thread, so that more
+    // threads can analyze different programs at once (llvm-slicer -jobs).
+    // Therefore, a set must be used only in the thread that filled it.
+    static thread_local std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
+    static thread_local std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
 
     //if the pointer doesn't have ID, it's assigned one
     size_t getPointerID(const Pointer& ptr) const {
@@ -51,6 +55,7 @@ public:
     }
 
     bool add(const Pointer& ptr) {
+        special.add(ptr);
         if(has({ptr.target, Offset::UNKNOWN})) {
             return false;
         }
@@ -64,6 +69,7 @@ public:
     }
 
     bool add(const AlignedPointerIdPointsToSet& S) {
+        special.add(S.special);
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.overflowSet) {
             changed |= overflowSet.insert(ptr).second;
@@ -72,10 +78,16 @@ public:
     }
 
     bool remove(const Pointer& ptr) {
+        bool changed;
         if(isOffsetValid(ptr.offset)) {
-            return pointers.unset(getPointerID(ptr));
+            changed = pointers.unset(getPointerID(ptr));
+        } else {
+            changed = overflowSet.erase(ptr) != 0;
         }
-        return overflowSet.erase(ptr) != 0;
+        if (changed) {
+            special.removed(ptr.target, *this);
+        }
+        return changed;
     }
 
     bool remove(PSNode *target, Offset offset) {
@@ -105,12 +117,17 @@ public:
                 it++;
             }
         }
-        return changed || !toRemove.empty();
+        changed |= !toRemove.empty();
+        if (changed) {
+            special.removed(target, *this);
+        }
+        return changed;
     }
 
     void clear() {
         pointers.reset();
         overflowSet.clear();
+        special.clear();
     }
 
     bool pointsTo(const Pointer& ptr) const {
@@ -161,16 +178,15 @@ public:
     }
 
     bool hasUnknown() const {
-        return pointsToTarget(UNKNOWN_MEMORY);
+        return special.hasUnknown();
     }
 
     bool hasNull() const {
-        return pointsToTarget(NULLPTR);
-
+        return special.hasNull();
     }
 
     bool hasInvalidated() const {
-        return pointsToTarget(INVALIDATED);
+        return special.hasInvalidated();
     }
 
     size_t size() const {
@@ -180,6 +196,7 @@ public:
     void swap(AlignedPointerIdPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         overflowSet.swap(rhs.overflowSet);
+        special.swap(rhs.special);
     }
 
     size_t overflowSetSize() const {
@@ -20,8 +20,12 @@ class AlignedSmallOffsetsPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> oddPointers;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    SpecialTargets special;
+    // The IDs are numbered separately in every thread, so that more
+    // threads can analyze different programs at once (llvm-slicer -jobs).
+    // Therefore, a set must be used only in the thread that filled it.
+    static thread_local std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
+    static thread_local std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
 
     //if the node doesn't have ID, it's assigned one
     size_t getNodeID(PSNode *node) const {
@@ -59,6 +63,7 @@ public:
     AlignedSmallOffsetsPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
 
     bool add(PSNode *target, Offset off) {
+        special.add(Pointer(target, off));
         if(has({target, Offset::UNKNOWN})) {
             return false;
         }
@@ -76,6 +81,7 @@ public:
     }
 
     bool add(const AlignedSmallOffsetsPointsToSet& S) {
+        special.add(S.special);
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.oddPointers) {
             changed |= oddPointers.insert(ptr).second;
@@ -84,10 +90,16 @@ public:
     }
 
     bool remove(const Pointer& ptr) {
+        bool changed;
         if(isOffsetValid(ptr.offset)) {
-            return pointers.unset(getPosition(ptr.target, ptr.offset));
+            changed = pointers.unset(getPosition(ptr.target, ptr.offset));
+        } else {
+            changed = oddPointers.erase(ptr) != 0;
         }
-        return oddPointers.erase(ptr) != 0;
+        if (changed) {
+            special.removed(ptr.target, *this);
+        }
+        return changed;
     }
 
     bool remove(PSNode *target, Offset offset) {
@@ -110,12 +122,16 @@ public:
                 it++;
             }
         }
+        if (changed) {
+            special.removed(target, *this);
+        }
         return changed;
     }
 
     void clear() {
         pointers.reset();
         oddPointers.clear();
+        special.clear();
     }
 
     bool pointsTo(const Pointer& ptr) const {
@@ -167,15 +183,15 @@ public:
     }
 
     bool hasUnknown() const {
-        return pointsToTarget(UNKNOWN_MEMORY);
+        return special.hasUnknown();
     }
 
     bool hasNull() const {
-        return pointsToTarget(NULLPTR);
+        return special.hasNull();
     }
 
     bool hasInvalidated() const {
-        return pointsToTarget(INVALIDATED);
+        return special.hasInvalidated();
     }
 
     size_t size() const {
@@ -185,6 +201,7 @@ public:
     void swap(AlignedSmallOffsetsPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         oddPointers.swap(rhs.oddPointers);
+        special.swap(rhs.special);
     }
 
     size_t overflowSetSize() const {
@@ -18,6 +18,7 @@ class OffsetsSetPointsToSet {
     // so we represent them coinciesly this way
     using ContainerT = std::map<PSNode *, ADT::SparseBitvector>;
     ContainerT pointers;
+    SpecialTargets special;
 
     bool addWithUnknownOffset(PSNode *target) {
         auto it = pointers.find(target);
@@ -41,6 +42,8 @@ public:
     OffsetsSetPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
 
     bool add(PSNode *target, Offset off) {
+        special.add(Pointer(target, off));
+
         if (off.isUnknown())
             return addWithUnknownOffset(target);
 
@@ -67,6 +70,7 @@ public:
     // union (unite S into this set)
     bool add(const OffsetsSetPointsToSet& S) {
         bool changed = false;
+        special.add(S.special);
         for (auto& it : S.pointers) {
             changed |= pointers[it.first].set(it.second);
         }
@@ -95,7 +99,16 @@ public:
             return false;
         }
 
-        return it->second.unset(*offset);
+        if (!it->second.unset(*offset))
+            return false;
+
+        // do not keep targets without offsets, the iterator
+        // would stumble over them
+        if (it->second.empty())
+            pointers.erase(it);
+
+        special.removed(target, *this);
+        return true;
     }
 
     ///
@@ -107,10 +120,14 @@ public:
         }
 
         pointers.erase(it);
+        special.removed(target, *this);
         return true;
     }
 
-    void clear() { pointers.clear(); }
+    void clear() {
+        pointers.clear();
+        special.clear();
+    }
 
     bool pointsTo(const Pointer& ptr) const {
         auto it = pointers.find(ptr.target);
@@ -155,9 +172,9 @@ public:
         return count(ptr) > 0;
     }
 
-    bool hasUnknown() const { return pointsToTarget(UNKNOWN_MEMORY); }
-    bool hasNull() const { return pointsToTarget(NULLPTR); }
-    bool hasInvalidated() const { return pointsToTarget(INVALIDATED); }
+    bool hasUnknown() const { return special.hasUnknown(); }
+    bool hasNull() const { return special.hasNull(); }
+    bool hasInvalidated() const { return special.hasInvalidated(); }
 
     size_t size() const {
         size_t num = 0;
@@ -168,7 +185,10 @@ public:
         return num;
     }
 
-    void swap(OffsetsSetPointsToSet& rhs) { pointers.swap(rhs.pointers); }
+    void swap(OffsetsSetPointsToSet& rhs) {
+        pointers.swap(rhs.pointers);
+        special.swap(rhs.special);
+    }
 
     class const_iterator {
         typename ContainerT::const_iterator container_it;
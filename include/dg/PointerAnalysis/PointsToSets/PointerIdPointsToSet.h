@@ -16,8 +16,12 @@ class PSNode;
 class PointerIdPointsToSet {
 
     ADT::SparseBitvector pointers;
-    static std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
-    static std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
+    SpecialTargets special;
+    // The IDs are numbered separately in every thread, so that more
+    // threads can analyze different programs at once (llvm-slicer -jobs).
+    // Therefore, a set must be used only in the thread that filled it.
+    static thread_local std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
+    static thread_local std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
 
     //if the pointer doesn't have ID, it's assigned one
     size_t getPointerID(const Pointer& ptr) const {
@@ -43,6 +47,7 @@ public:
     }
 
     bool add(const Pointer& ptr) {
+        special.add(ptr);
         if(has({ptr.target, Offset::UNKNOWN})) {
             return false;
         }
@@ -53,11 +58,16 @@ public:
     }
 
     bool add(const PointerIdPointsToSet& S) {
+        special.add(S.special);
         return pointers.set(S.pointers);
     }
 
     bool remove(const Pointer& ptr) {
-        return pointers.unset(getPointerID(ptr));
+        if (!pointers.unset(getPointerID(ptr)))
+            return false;
+
+        special.removed(ptr.target, *this);
+        return true;
     }
 
     bool remove(PSNode *target, Offset offset) {
@@ -75,11 +85,17 @@ public:
         for (auto ptrID : toRemove)  {
             pointers.unset(ptrID);
         }
-        return !toRemove.empty();
+
+        if (toRemove.empty())
+            return false;
+
+        special.removed(target, *this);
+        return true;
     }
 
     void clear() {
         pointers.reset();
+        special.clear();
     }
 
     bool pointsTo(const Pointer& ptr) const {
@@ -122,16 +138,15 @@ public:
     }
 
     bool hasUnknown() const {
-        return pointsToTarget(UNKNOWN_MEMORY);
+        return special.hasUnknown();
     }
 
     bool hasNull() const {
-        return pointsToTarget(NULLPTR);
-
+        return special.hasNull();
     }
 
     bool hasInvalidated() const {
-        return pointsToTarget(INVALIDATED);
+        return special.hasInvalidated();
     }
 
     size_t size() const {
@@ -140,6 +155,7 @@ public:
 
     void swap(PointerIdPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
+        special.swap(rhs.special);
     }
 
     class const_iterator {
@@ -17,8 +17,12 @@ class SeparateOffsetsPointsToSet {
 
     ADT::SparseBitvector nodes;
     ADT::SparseBitvector offsets;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1, 2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    SpecialTargets special;
+    // The IDs are numbered separately in every thread, so that more
+    // threads can analyze different programs at once (llvm-slicer -jobs).
+    // Therefore, a set must be used only in the thread that filled it.
+    static thread_local std::map<PSNode*,size_t> ids;  //nodes are numbered 1, 2, ...
+    static thread_local std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
 
     //if the node doesn't have ID, it is assigned one
     size_t getNodeID(PSNode *node) const {
@@ -35,6 +39,7 @@ public:
     SeparateOffsetsPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
 
     bool add(PSNode *target, Offset off) {
+        special.add(Pointer(target, off));
         if(offsets.get(Offset::UNKNOWN)) {
             return !nodes.set(getNodeID(target));
         }
@@ -50,6 +55,7 @@ public:
     }
 
     bool add(const SeparateOffsetsPointsToSet& S) {
+        special.add(S.special);
         bool changed = nodes.set(S.nodes);
         return offsets.set(S.offsets) || changed;
     }
@@ -69,6 +75,7 @@ public:
     void clear() {
         nodes.reset();
         offsets.reset();
+        special.clear();
     }
 
     bool pointsTo(const Pointer& ptr) const {
@@ -106,16 +113,15 @@ public:
     }
 
     bool hasUnknown() const {
-        return pointsToTarget(UNKNOWN_MEMORY);
+        return special.hasUnknown();
     }
 
     bool hasNull() const {
-        return pointsToTarget(NULLPTR);
-
+        return special.hasNull();
     }
 
     bool hasInvalidated() const {
-        return pointsToTarget(INVALIDATED);
+        return special.hasInvalidated();
     }
 
     size_t size() const {
@@ -125,6 +131,7 @@ public:
     void swap(SeparateOffsetsPointsToSet& rhs) {
         nodes.swap(rhs.nodes);
         offsets.swap(rhs.offsets);
+        special.swap(rhs.special);
     }
 
     //iterates through all the possible combinations of nodes and their offsets stored in this points-to set
@@ -17,6 +17,7 @@ class PSNode;
 class SimplePointsToSet {
     using ContainerT = std::set<Pointer>;
     ContainerT pointers;
+    SpecialTargets special;
 
     bool addWithUnknownOffset(PSNode *target) {
         if (has({target, Offset::UNKNOWN}))
@@ -39,6 +40,8 @@ public:
     using const_iterator = typename ContainerT::const_iterator;
 
     bool add(PSNode *target, Offset off) {
+        special.add(Pointer(target, off));
+
         if (off.isUnknown())
             return addWithUnknownOffset(target);
 
@@ -58,6 +61,7 @@ public:
     // into 'this' set (i.e. merge rhs to this set)
     bool add(const SimplePointsToSet& rhs) {
         bool changed = false;
+        special.add(rhs.special);
         for (const auto& ptr : rhs.pointers) {
             changed |= pointers.insert(ptr).second;
         }
@@ -74,7 +78,11 @@ public:
     }
 
     bool remove(const Pointer& ptr) {
-        return pointers.erase(ptr) != 0;
+        if (pointers.erase(ptr) == 0)
+            return false;
+
+        special.removed(ptr.target, *this);
+        return true;
     }
 
     ///
@@ -103,7 +111,10 @@ public:
         return false;
     }
 
-    void clear() { pointers.clear(); }
+    void clear() {
+        pointers.clear();
+        special.clear();
+    }
 
     bool pointsTo(const Pointer& ptr) const {
         return pointers.count(ptr) > 0;
@@ -138,11 +149,14 @@ public:
     size_t size() const { return pointers.size(); }
     bool empty() const { return pointers.empty(); }
     bool has(const Pointer& ptr) { return count(ptr) > 0; }
-    bool hasUnknown() const { return pointsToTarget(UNKNOWN_MEMORY); }
-    bool hasNull() const { return pointsToTarget(NULLPTR); }
-    bool hasInvalidated() const { return pointsToTarget(INVALIDATED); }
+    bool hasUnknown() const { return special.hasUnknown(); }
+    bool hasNull() const { return special.hasNull(); }
+    bool hasInvalidated() const { return special.hasInvalidated(); }
 
-    void swap(SimplePointsToSet& rhs) { pointers.swap(rhs.pointers); }
+    void swap(SimplePointsToSet& rhs) {
+        pointers.swap(rhs.pointers);
+        special.swap(rhs.special);
+    }
 
     const_iterator begin() const { return pointers.begin(); }
     const_iterator end() const { return pointers.end(); }
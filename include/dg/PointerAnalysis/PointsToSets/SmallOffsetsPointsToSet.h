@@ -18,8 +18,12 @@ class SmallOffsetsPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> largePointers;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    SpecialTargets special;
+    // The IDs are numbered separately in every thread, so that more
+    // threads can analyze different programs at once (llvm-slicer -jobs).
+    // Therefore, a set must be used only in the thread that filled it.
+    static thread_local std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
+    static thread_local std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
 
     //if the node doesn't have ID, it's assigned one
     size_t getNodeID(PSNode *node) const {
@@ -57,6 +61,7 @@ public:
     SmallOffsetsPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
 
     bool add(PSNode *target, Offset off) {
+        special.add(Pointer(target, off));
         if(has({target, Offset::UNKNOWN})) {
             return false;
         } else if(off.isUnknown()) {
@@ -73,6 +78,7 @@ public:
     }
 
     bool add(const SmallOffsetsPointsToSet& S) {
+        special.add(S.special);
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.largePointers) {
             changed |= largePointers.insert(ptr).second;
@@ -81,10 +87,16 @@ public:
     }
 
     bool remove(const Pointer& ptr) {
+        bool changed;
         if(isOffsetValid(ptr.offset)) {
-            return pointers.unset(getPosition(ptr.target, ptr.offset));
+            changed = pointers.unset(getPosition(ptr.target, ptr.offset));
+        } else {
+            changed = largePointers.erase(ptr) != 0;
+        }
+        if (changed) {
+            special.removed(ptr.target, *this);
         }
-        return largePointers.erase(ptr) != 0;
+        return changed;
     }
 
     bool remove(PSNode *target, Offset offset) {
@@ -107,12 +119,16 @@ public:
                 it++;
             }
         }
+        if (changed) {
+            special.removed(target, *this);
+        }
         return changed;
     }
 
     void clear() {
         pointers.reset();
         largePointers.clear();
+        special.clear();
     }
 
     bool pointsTo(const Pointer& ptr) const {
@@ -164,15 +180,15 @@ public:
     }
 
     bool hasUnknown() const {
-        return pointsToTarget(UNKNOWN_MEMORY);
+        return special.hasUnknown();
     }
 
     bool hasNull() const {
-        return pointsToTarget(NULLPTR);
+        return special.hasNull();
     }
 
     bool hasInvalidated() const {
-        return pointsToTarget(INVALIDATED);
+        return special.hasInvalidated();
     }
 
     size_t size() const {
@@ -182,6 +198,7 @@ public:
     void swap(SmallOffsetsPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         largePointers.swap(rhs.largePointers);
+        special.swap(rhs.special);
     }
 
     size_t overflowSetSize() const {
@@ -109,8 +109,6 @@ struct GenericDefSite {
 // for compatibility until we need to change it
 using DefSite = GenericDefSite<RWNode>;
 
-extern RWNode *UNKNOWN_MEMORY;
-
 // FIXME: change this std::set to std::map (target->offsets)
 class DefSiteSet : public std::set<DefSite> {
 public:
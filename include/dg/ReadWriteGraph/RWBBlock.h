@@ -14,6 +14,11 @@ class RWBBlock;
 
 class RWBBlock : public BBlockBase<RWBBlock> {
     RWSubgraph *subgraph{nullptr};
+    // the position of the block in its subgraph
+    unsigned _index{0};
+
+    void setIndex(unsigned idx) { _index = idx; }
+    friend class RWSubgraph;
 
 public:
 
@@ -26,6 +31,10 @@ public:
     RWSubgraph *getSubgraph() { return subgraph; }
     const RWSubgraph *getSubgraph() const { return subgraph; }
 
+    // blocks of a subgraph are numbered 0, 1, ..., so the index
+    // can be used to index side tables of analyses
+    unsigned getIndex() const { return _index; }
+
     // FIXME: move also this into BBlockBase
     void append(NodeT *n) { _nodes.push_back(n); n->setBBlock(this); }
     void prepend(NodeT *n) { _nodes.push_front(n); n->setBBlock(this); }
@@ -21,6 +21,8 @@ class ReachingDefinitionsAnalysis;
 enum class RWNodeType {
         // invalid type of node
         NONE,
+        // the unknown memory location (every graph has its own)
+        UNKNOWN_MEM,
         // these are nodes that just represent memory allocation sites
         // we need to have them even in reaching definitions analysis,
         // so that we can use them as targets in DefSites
@@ -56,8 +58,6 @@ enum class RWNodeType {
         NOOP
 };
 
-extern RWNode *UNKNOWN_MEMORY;
-
 class RWBBlock;
 
 class RWNode : public SubgraphNode<RWNode> {
@@ -126,7 +126,7 @@ public:
         const DefSiteSetT& getUses() const { return uses; }
     } annotations;
 
-    // for invalid nodes like UNKNOWN_MEMLOC
+    // for nodes that are not in the graph, like the unknown memory
     RWNode(RWNodeType t = RWNodeType::NONE)
     : SubgraphNode<RWNode>(0), type(t) {}
 
@@ -266,7 +266,7 @@ public:
         annotations.getOverwrites().insert(ds);
     }
 
-    bool isUnknown() const { return this == UNKNOWN_MEMORY; }
+    bool isUnknown() const { return type == RWNodeType::UNKNOWN_MEM; }
     bool isUse() const { return !getUses().empty(); }
     bool isDef() const { return !getDefines().empty() || !getOverwrites().empty(); }
 
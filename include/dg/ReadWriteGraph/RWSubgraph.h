@@ -54,11 +54,19 @@ class RWSubgraph {
 
     std::vector<RWNode *> _callers;
 
+    // the position of the subgraph in the graph
+    unsigned _index{0};
+
     // for debugging
     std::string name;
 
+    void _addBBlock(std::unique_ptr<RWBBlock>&& block) {
+        block->setIndex(_bblocks.size());
+        _bblocks.push_back(std::move(block));
+    }
+
 public:
-    RWSubgraph() = default;
+    RWSubgraph(unsigned idx = 0) : _index(idx) {}
     RWSubgraph(RWSubgraph&&) = default;
     RWSubgraph& operator=(RWSubgraph&&) = default;
 
@@ -68,8 +76,12 @@ public:
     void setName(const std::string& nm) { name = nm; }
     const std::string& getName() const { return name; }
 
+    // subgraphs are numbered 0, 1, ... in the order of creation,
+    // so the index can be used to index side tables of analyses
+    unsigned getIndex() const { return _index; }
+
     RWBBlock& createBBlock() {
-        _bblocks.emplace_back(new RWBBlock(this));
+        _addBBlock(std::unique_ptr<RWBBlock>(new RWBBlock(this)));
         return *_bblocks.back().get();
     }
 
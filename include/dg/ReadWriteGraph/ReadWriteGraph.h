@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "dg/BFS.h"
+#include "dg/ADT/Arena.h"
 #include "dg/ReadWriteGraph/RWNode.h"
 #include "dg/ReadWriteGraph/RWBBlock.h"
 #include "dg/ReadWriteGraph/RWSubgraph.h"
@@ -19,13 +20,18 @@ class ReadWriteGraph {
     unsigned int dfsnum{1};
 
     size_t lastNodeID{0};
-    using NodesT = std::vector<std::unique_ptr<RWNode>>;
+    // nodes are allocated in an arena and indexed by their ID - 1
+    using NodesT = ADT::Arena<RWNode>;
     using SubgraphsT = std::vector<std::unique_ptr<RWSubgraph>>;
 
     NodesT _nodes;
     SubgraphsT _subgraphs;
     RWSubgraph *_entry{nullptr};
 
+    // the unknown memory location of this graph. It is allocated
+    // separately, so that the graph can be moved.
+    std::unique_ptr<RWNode> _unknown{new RWNode(RWNodeType::UNKNOWN_MEM)};
+
     // iterator over the bsubgraphs that returns the bsubgraph,
     // not the unique_ptr to the bsubgraph
     struct subgraph_iterator : public SubgraphsT::iterator {
@@ -63,6 +69,8 @@ public:
     const RWSubgraph *getEntry() const { return _entry; }
     void setEntry(RWSubgraph *e) { _entry = e; }
 
+    RWNode *getUnknownMemory() const { return _unknown.get(); }
+
     void removeUselessNodes();
 
     void optimize() {
@@ -71,18 +79,26 @@ public:
 
     RWNode& create(RWNodeType t) {
       if (t == RWNodeType::CALL) {
-        _nodes.emplace_back(new RWNodeCall(++lastNodeID));
-      } else {
-        _nodes.emplace_back(new RWNode(++lastNodeID, t));
+        return *_nodes.create<RWNodeCall>(++lastNodeID);
       }
-      return *_nodes.back().get();
+      return *_nodes.create<RWNode>(++lastNodeID, t);
     }
 
     RWSubgraph& createSubgraph() {
-      _subgraphs.emplace_back(new RWSubgraph());
+      _subgraphs.emplace_back(new RWSubgraph(_subgraphs.size()));
       return *_subgraphs.back().get();
     }
 
+    RWNode *getNode(unsigned id) const {
+        assert(id > 0 && id <= _nodes.size());
+        return _nodes[id - 1];
+    }
+
+    size_t getNodesNum() const { return _nodes.size(); }
+    // memory taken by the nodes (without the memory
+    // allocated by the nodes themselves)
+    size_t getNodesMemory() const { return _nodes.allocatedMemory(); }
+
     // Build blocks for the nodes. If 'dce' is set to true,
     // the dead code is eliminated after building the blocks.
     /*
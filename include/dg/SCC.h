@@ -1,8 +1,11 @@
 #ifndef DG_SCC_H_
 #define DG_SCC_H_
 
-#include <vector>
+#include <algorithm>
+#include <cassert>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "dg/ADT/Queue.h"
 #include "dg/ADT/HashMap.h"
@@ -55,7 +58,33 @@ private:
     // container for the strongly connected components.
     SCC_t scc;
 
-    void _compute(NodeT *n)
+    void _finishNode(NodeInfo& info)
+    {
+        if (info.lowpt != info.dfs_id)
+            return;
+
+        SCC_component_t component;
+        size_t component_num = scc.size();
+
+        NodeT *w;
+        while (_info[stack.top()].dfs_id >= info.dfs_id) {
+            w = stack.pop();
+            auto& winfo = _info[w];
+            assert(winfo.on_stack == true);
+            winfo.on_stack = false;
+            component.push_back(w);
+            // the numbers scc_id give
+            // a reverse topological order
+            w->setSCCId(component_num);
+
+            if (stack.empty())
+                break;
+        }
+
+        scc.push_back(std::move(component));
+    }
+
+    void _visit(NodeT *n)
     {
         auto& info = _info[n];
         // here we using the fact that we are a friend class
@@ -64,38 +93,42 @@ private:
         info.dfs_id = info.lowpt = ++index;
         info.on_stack = true;
         stack.push(n);
+    }
 
-        for (auto *succ : n->successors()) {
-            auto& succ_info = _info[succ];
-            if (succ_info.dfs_id == 0) {
-                assert(!succ_info.on_stack);
-                _compute(succ);
-                info.lowpt = std::min(info.lowpt, succ_info.lowpt);
-            } else if (succ_info.on_stack) {
-                info.lowpt = std::min(info.lowpt, succ_info.dfs_id);
+    // the DFS is driven by an explicit stack of (node, index of the next
+    // successor) pairs, so that deep graphs do not overflow the call stack
+    void _compute(NodeT *start)
+    {
+        std::vector<std::pair<NodeT *, size_t>> dfs;
+        _visit(start);
+        dfs.emplace_back(start, 0);
+
+        while (!dfs.empty()) {
+            NodeT *n = dfs.back().first;
+            size_t& idx = dfs.back().second;
+            auto& info = _info[n];
+            const auto& succs = n->successors();
+
+            if (idx < succs.size()) {
+                auto *succ = *(succs.begin() + idx);
+                ++idx;
+                auto& succ_info = _info[succ];
+                if (succ_info.dfs_id == 0) {
+                    assert(!succ_info.on_stack);
+                    _visit(succ);
+                    dfs.emplace_back(succ, 0);
+                } else if (succ_info.on_stack) {
+                    info.lowpt = std::min(info.lowpt, succ_info.dfs_id);
+                }
+                continue;
             }
-        }
 
-        if (info.lowpt == info.dfs_id) {
-            SCC_component_t component;
-            size_t component_num = scc.size();
-
-            NodeT *w;
-            while (_info[stack.top()].dfs_id >= info.dfs_id) {
-                w = stack.pop();
-                auto& winfo = _info[w];
-                assert(winfo.on_stack == true);
-                winfo.on_stack = false;
-                component.push_back(w);
-                // the numbers scc_id give
-                // a reverse topological order
-                w->setSCCId(component_num);
-
-                if (stack.empty())
-                    break;
+            dfs.pop_back();
+            if (!dfs.empty()) {
+                auto& pred_info = _info[dfs.back().first];
+                pred_info.lowpt = std::min(pred_info.lowpt, info.lowpt);
             }
-
-            scc.push_back(std::move(component));
+            _finishNode(info);
         }
     }
 };
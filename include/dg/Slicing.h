@@ -2,6 +2,13 @@
 #define DG_SLICING_H_
 
 #include <set>
+#include <array>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
 
 #include "dg/legacy/Analysis.h"
 #include "dg/legacy/NodesWalk.h"
@@ -18,26 +25,36 @@ namespace dg {
 // this class will go through the nodes
 // and will mark the ones that should be in the slice
 template <typename NodeT>
-class WalkAndMark : public legacy::NodesWalk<NodeT, dg::ADT::QueueFIFO<NodeT *>>
+class WalkAndMark : public legacy::DenseNodesWalk<NodeT>
 {
-    using Queue = dg::ADT::QueueFIFO<NodeT *>;
-
 public:
+    using PrepareNodeT = std::function<void(NodeT *)>;
+
     ///
     // forward_slc makes searching the dependencies
-    // in forward direction instead of backward
-    WalkAndMark(bool forward_slc = false)
-        : legacy::NodesWalk<NodeT, Queue>(
+    // in forward direction instead of backward.
+    // prepare_node is called for every reached node before
+    // its edges are walked, so it can add the edges on demand.
+    // With more threads, the edges of the reached nodes
+    // are followed in parallel.
+    WalkAndMark(bool forward_slc = false,
+                PrepareNodeT prepare_node = nullptr,
+                unsigned threads = 1)
+        : legacy::DenseNodesWalk<NodeT>(
             forward_slc ?
                 (legacy::NODES_WALK_CD | legacy::NODES_WALK_DD |
                  legacy::NODES_WALK_USE | legacy::NODES_WALK_ID) :
                 (legacy::NODES_WALK_REV_CD | legacy::NODES_WALK_REV_DD |
                  legacy::NODES_WALK_USER | legacy::NODES_WALK_ID |
-                 legacy::NODES_WALK_REV_ID)
+                 legacy::NODES_WALK_REV_ID),
+            threads
           ),
-          forward_slice(forward_slc) {}
+          forward_slice(forward_slc),
+          prepareNode(std::move(prepare_node)) {}
 
-    void mark(const std::set<NodeT *>& start, uint32_t slice_id) {
+    // mark the nodes reachable from any of the nodes in 'start'
+    template <typename ContT>
+    void mark(const ContT& start, uint32_t slice_id) {
         WalkData data(slice_id, this, forward_slice ? &markedBlocks : nullptr);
         this->walk(start, markSlice, &data);
     }
@@ -51,8 +68,15 @@ public:
     // returns marked blocks, but only for forward slicing atm
     const std::set<BBlock<NodeT> *>& getMarkedBlocks() { return markedBlocks; }
 
+protected:
+    void prepare(NodeT *n) override {
+        if (prepareNode)
+            prepareNode(n);
+    }
+
 private:
     bool forward_slice{false};
+    PrepareNodeT prepareNode;
     std::set<BBlock<NodeT> *> markedBlocks;
 
 
@@ -105,6 +129,532 @@ private:
     }
 };
 
+///
+// The common part of ForwardWalkAndMark and ContextSensitiveWalkAndMark:
+// marking the nodes and two worklists, the edges of a node are followed
+// at most once for every worklist.
+template <typename NodeT>
+class TwoWayWalkAndMark
+{
+public:
+    using PrepareNodeT = std::function<void(NodeT *)>;
+
+protected:
+    // prepare_node has the same meaning as in WalkAndMark
+    TwoWayWalkAndMark(PrepareNodeT prepare_node)
+        : prepareNode(std::move(prepare_node)) {}
+
+    PrepareNodeT prepareNode;
+
+    std::vector<NodeT *> queues[2];
+    // nodes that were queued into the worklists (indexed by node IDs)
+    std::vector<bool> queued[2];
+    // nodes that were marked
+    std::vector<bool> marked;
+
+    static bool test(std::vector<bool>& bits, const NodeT *n)
+    {
+        if (n->getID() >= bits.size())
+            bits.resize(NodeT::getMaxID() + 1);
+        return bits[n->getID()];
+    }
+
+    void enqueue(NodeT *n, unsigned way)
+    {
+        if (test(queued[way], n))
+            return;
+
+        queued[way][n->getID()] = true;
+        queues[way].push_back(n);
+    }
+
+    void markSlice(NodeT *n, uint32_t slice_id)
+    {
+        if (test(marked, n))
+            return;
+
+        marked[n->getID()] = true;
+        if (prepareNode)
+            prepareNode(n);
+
+        n->setSlice(slice_id);
+#ifdef ENABLE_CFG
+        if (BBlock<NodeT> *B = n->getBBlock())
+            B->setSlice(slice_id);
+#endif
+        if (DependenceGraph<NodeT> *dg = n->getDG())
+            dg->setSlice(slice_id);
+    }
+};
+
+///
+// Mark the forward slice: the nodes that depend on the start nodes
+// and the branchings that the blocks of these nodes are control
+// dependent on, together with the backward slice of the branchings
+// (so that the marked nodes can be executed). Unlike WalkAndMark
+// followed by another WalkAndMark from the branchings, we extend
+// the forward and the backward closure in one worklist, the branchings
+// are queued once their blocks are reached. Every node is marked once
+// and its edges are followed at most once in every direction.
+template <typename NodeT>
+class ForwardWalkAndMark : TwoWayWalkAndMark<NodeT>
+{
+    using Base = TwoWayWalkAndMark<NodeT>;
+
+public:
+    using typename Base::PrepareNodeT;
+
+    ForwardWalkAndMark(PrepareNodeT prepare_node = nullptr)
+        : Base(std::move(prepare_node)) {}
+
+    template <typename ContT>
+    void mark(const ContT& start, uint32_t slice_id)
+    {
+        for (NodeT *n : start)
+            enqueue(n, FORWARD);
+
+        while (!queues[FORWARD].empty() || !queues[BACKWARD].empty()) {
+            Direction dir = queues[FORWARD].empty() ? BACKWARD : FORWARD;
+            NodeT *n = queues[dir].back();
+            queues[dir].pop_back();
+            process(n, dir, slice_id);
+        }
+    }
+
+private:
+    enum Direction { FORWARD = 0, BACKWARD = 1 };
+
+    using Base::queues;
+    using Base::enqueue;
+    using Base::markSlice;
+
+#ifdef ENABLE_CFG
+    // blocks whose branchings were queued
+    std::set<BBlock<NodeT> *> forwardBlocks;
+#endif
+
+    void process(NodeT *n, Direction dir, uint32_t slice_id)
+    {
+        markSlice(n, slice_id);
+
+        if (dir == BACKWARD) {
+            // keep the call-sites as WalkAndMark does
+            if (DependenceGraph<NodeT> *dg = n->getDG()) {
+                NodeT *entry = dg->getEntry();
+                assert(entry && "No entry node in dg");
+                enqueue(entry, BACKWARD);
+            }
+        }
+#ifdef ENABLE_CFG
+        else if (BBlock<NodeT> *B = n->getBBlock()) {
+            // the block is in the slice, so we need
+            // the branchings that decide whether it is executed
+            if (forwardBlocks.insert(B).second) {
+                for (auto cBB : B->revControlDependence()) {
+                    assert(cBB->successorsNum() > 1);
+                    enqueue(cBB->getLastNode(), BACKWARD);
+                }
+            }
+        }
+#endif
+
+        auto follow = [this, dir](NodeT *m) { enqueue(m, dir); };
+        legacy::forEachWalkedNode(n,
+                                  dir == FORWARD ?
+                                    (legacy::NODES_WALK_CD |
+                                     legacy::NODES_WALK_DD |
+                                     legacy::NODES_WALK_USE |
+                                     legacy::NODES_WALK_ID) :
+                                    (legacy::NODES_WALK_REV_CD |
+                                     legacy::NODES_WALK_REV_DD |
+                                     legacy::NODES_WALK_USER |
+                                     legacy::NODES_WALK_ID |
+                                     legacy::NODES_WALK_REV_ID),
+                                  follow);
+    }
+};
+
+///
+// Mark slices w.r.t. several independent slicing criteria at once.
+// Instead of walking the graph once for every criterion, we walk
+// (backwards) the nodes reachable from any of the criteria only once
+// and split them into strongly connected components. The nodes in one
+// component are in the same slices, so we keep a set of slices (a bit
+// for every criterion) per component and propagate these sets over
+// the components in topological order. Any slice can be then marked
+// with its own slice id without walking the graph again.
+template <typename NodeT>
+class BatchWalkAndMark
+{
+public:
+    using PrepareNodeT = std::function<void(NodeT *)>;
+
+    // prepare_node has the same meaning as in WalkAndMark
+    BatchWalkAndMark(PrepareNodeT prepare_node = nullptr)
+        : prepareNode(std::move(prepare_node)) {}
+
+    ///
+    // Compute the slices. The i-th slice is the slice w.r.t. the
+    // set of nodes criteria[i].
+    void compute(const std::vector<std::set<NodeT *>>& criteria)
+    {
+        _criteria_num = criteria.size();
+        _words = (_criteria_num + 63) / 64;
+
+        for (const auto& crit : criteria) {
+            for (NodeT *n : crit) {
+                if (_index.find(n) == _index.end())
+                    strongConnect(n);
+            }
+        }
+
+        assert(_stack.empty());
+        propagate(criteria);
+    }
+
+    size_t getCriteriaNum() const { return _criteria_num; }
+
+    // the nodes that were reached from some slicing criterion
+    const std::vector<NodeT *>& getNodes() const { return _nodes; }
+
+    bool isInSlice(NodeT *n, unsigned crit) const
+    {
+        assert(crit < _criteria_num);
+        auto it = _index.find(n);
+        if (it == _index.end())
+            return false;
+        return hasBit(_scc[it->second], crit);
+    }
+
+    // the criteria whose slices contain the node
+    std::vector<unsigned> getSlices(NodeT *n) const
+    {
+        std::vector<unsigned> ret;
+        auto it = _index.find(n);
+        if (it == _index.end())
+            return ret;
+
+        unsigned scc = _scc[it->second];
+        for (unsigned c = 0; c < _criteria_num; ++c) {
+            if (hasBit(scc, c))
+                ret.push_back(c);
+        }
+        return ret;
+    }
+
+    size_t getSliceSize(unsigned crit) const
+    {
+        assert(crit < _criteria_num);
+        size_t num = 0;
+        for (unsigned i = 0; i < _nodes.size(); ++i) {
+            if (hasBit(_scc[i], crit))
+                ++num;
+        }
+        return num;
+    }
+
+    ///
+    // Mark the nodes (and their blocks and graphs) from the slice
+    // w.r.t. the criterion 'crit' with the given slice id,
+    // the same way as WalkAndMark does.
+    void mark(unsigned crit, uint32_t slice_id) const
+    {
+        assert(crit < _criteria_num);
+        for (unsigned i = 0; i < _nodes.size(); ++i) {
+            if (!hasBit(_scc[i], crit))
+                continue;
+
+            NodeT *n = _nodes[i];
+            n->setSlice(slice_id);
+#ifdef ENABLE_CFG
+            if (BBlock<NodeT> *B = n->getBBlock())
+                B->setSlice(slice_id);
+#endif
+            if (DependenceGraph<NodeT> *dg = n->getDG())
+                dg->setSlice(slice_id);
+        }
+    }
+
+private:
+    enum : unsigned { UNDEFINED = ~0U };
+
+    // the nodes that a node in the slice brings to the slice,
+    // i.e., the nodes that WalkAndMark enqueues in backward slicing
+    template <typename FuncT>
+    static void forEachSuccessor(NodeT *n, FuncT func)
+    {
+        for (auto I = n->rev_control_begin(), E = n->rev_control_end(); I != E; ++I)
+            func(*I);
+#ifdef ENABLE_CFG
+        if (BBlock<NodeT> *BB = n->getBBlock()) {
+            for (BBlock<NodeT> *CD : BB->revControlDependence())
+                func(CD->getLastNode());
+        }
+#endif
+        for (auto I = n->rev_data_begin(), E = n->rev_data_end(); I != E; ++I)
+            func(*I);
+        for (auto I = n->user_begin(), E = n->user_end(); I != E; ++I)
+            func(*I);
+        for (auto I = n->interference_begin(), E = n->interference_end(); I != E; ++I)
+            func(*I);
+        for (auto I = n->rev_interference_begin(), E = n->rev_interference_end(); I != E; ++I)
+            func(*I);
+
+        // we keep the call-sites of the functions that are in the slice
+        if (DependenceGraph<NodeT> *dg = n->getDG()) {
+            NodeT *entry = dg->getEntry();
+            assert(entry && "No entry node in dg");
+            func(entry);
+        }
+    }
+
+    struct Frame {
+        unsigned node;
+        std::vector<NodeT *> succs;
+        size_t next{0};
+
+        Frame(unsigned n) : node(n) {}
+    };
+
+    void pushFrame(NodeT *n, std::vector<Frame>& frames)
+    {
+        unsigned idx = _nodes.size();
+        _index.emplace(n, idx);
+        _nodes.push_back(n);
+        _low.push_back(idx);
+        _scc.push_back(UNDEFINED);
+        _onstack.push_back(true);
+        _stack.push_back(idx);
+
+        if (prepareNode)
+            prepareNode(n);
+
+        frames.emplace_back(idx);
+        auto& succs = frames.back().succs;
+        forEachSuccessor(n, [&succs](NodeT *s) { succs.push_back(s); });
+    }
+
+    // Tarjan's algorithm without recursion. The nodes get indices
+    // in the order in which they are discovered, so the index of a
+    // node is also its DFS number.
+    void strongConnect(NodeT *root)
+    {
+        std::vector<Frame> frames;
+        pushFrame(root, frames);
+
+        while (!frames.empty()) {
+            Frame& fr = frames.back();
+            if (fr.next < fr.succs.size()) {
+                NodeT *s = fr.succs[fr.next++];
+                auto it = _index.find(s);
+                if (it == _index.end()) {
+                    // invalidates 'fr'
+                    pushFrame(s, frames);
+                } else if (_onstack[it->second]) {
+                    _low[fr.node] = std::min(_low[fr.node], it->second);
+                }
+                continue;
+            }
+
+            unsigned v = fr.node;
+            frames.pop_back();
+
+            if (_low[v] == v) {
+                unsigned w;
+                do {
+                    w = _stack.back();
+                    _stack.pop_back();
+                    _onstack[w] = false;
+                    _scc[w] = _scc_num;
+                } while (w != v);
+                ++_scc_num;
+            }
+
+            if (!frames.empty()) {
+                unsigned u = frames.back().node;
+                _low[u] = std::min(_low[u], _low[v]);
+            }
+        }
+    }
+
+    // Tarjan's algorithm finds a component only after finding all
+    // the components reachable from it, so the components with
+    // higher numbers go first in the topological order.
+    void propagate(const std::vector<std::set<NodeT *>>& criteria)
+    {
+        _bits.assign(_scc_num * _words, 0);
+        for (unsigned c = 0; c < criteria.size(); ++c) {
+            for (NodeT *n : criteria[c])
+                setBit(_scc[_index[n]], c);
+        }
+
+        // sort the nodes by the components (counting sort)
+        std::vector<unsigned> start(_scc_num + 1, 0);
+        for (unsigned s : _scc)
+            ++start[s + 1];
+        for (unsigned s = 0; s < _scc_num; ++s)
+            start[s + 1] += start[s];
+        std::vector<unsigned> order(_nodes.size());
+        auto pos = start;
+        for (unsigned i = 0; i < _nodes.size(); ++i)
+            order[pos[_scc[i]]++] = i;
+
+        for (unsigned s = _scc_num; s-- > 0;) {
+            const uint64_t *from = &_bits[s * _words];
+            for (unsigned i = start[s]; i < start[s + 1]; ++i) {
+                forEachSuccessor(_nodes[order[i]], [&](NodeT *succ) {
+                    unsigned t = _scc[_index[succ]];
+                    if (t == s)
+                        return;
+                    assert(t < s && "The components are not in topological order");
+                    uint64_t *to = &_bits[t * _words];
+                    for (size_t w = 0; w < _words; ++w)
+                        to[w] |= from[w];
+                });
+            }
+        }
+
+        _low.clear();
+        _low.shrink_to_fit();
+        _onstack.clear();
+        _onstack.shrink_to_fit();
+    }
+
+    bool hasBit(unsigned scc, unsigned crit) const
+    {
+        return _bits[scc * _words + crit / 64] & (uint64_t(1) << (crit % 64));
+    }
+
+    void setBit(unsigned scc, unsigned crit)
+    {
+        _bits[scc * _words + crit / 64] |= uint64_t(1) << (crit % 64);
+    }
+
+    PrepareNodeT prepareNode;
+    size_t _criteria_num{0};
+    // number of 64-bit words in a set of slices
+    size_t _words{0};
+
+    // the reached nodes and their indices
+    std::vector<NodeT *> _nodes;
+    std::unordered_map<NodeT *, unsigned> _index;
+    // node index -> its component
+    std::vector<unsigned> _scc;
+    unsigned _scc_num{0};
+    // component -> the set of slices
+    std::vector<uint64_t> _bits;
+
+    // auxiliary data of Tarjan's algorithm
+    std::vector<unsigned> _low;
+    std::vector<bool> _onstack;
+    std::vector<unsigned> _stack;
+};
+
+///
+// Mark the backward slice using the two-phase algorithm from
+//
+//  S. Horwitz, T. Reps, and D. Binkley. 1990.
+//  Interprocedural slicing using dependence graphs. TOPLAS 12, 1.
+//
+// The first phase does not descend into the called functions (it does
+// not follow parameter-out edges), it uses summary edges instead.
+// The second phase starts from the nodes found by the first phase and
+// does not ascend to callers (it does not follow parameter-in edges).
+// So, unlike WalkAndMark, we do not get all the callers of a function
+// only because a node from the function is in the slice.
+// Dependencies between functions that are not parameter edges
+// (e.g., memory dependencies that go directly between functions)
+// do not carry the calling context, so the nodes reached via
+// them are searched as in the first phase.
+//
+// SummaryEdgesT must provide getSources(n) (the nodes with a summary
+// edge to n or nullptr) and the predicates isParameterIn(from, to),
+// isParameterOut(from, to) and isInterprocedural(from, to).
+template <typename NodeT, typename SummaryEdgesT>
+class ContextSensitiveWalkAndMark : TwoWayWalkAndMark<NodeT>
+{
+    using Base = TwoWayWalkAndMark<NodeT>;
+
+public:
+    using typename Base::PrepareNodeT;
+
+    ContextSensitiveWalkAndMark(const SummaryEdgesT& summaries,
+                                PrepareNodeT prepare_node = nullptr)
+        : Base(std::move(prepare_node)), summaries(summaries) {}
+
+    template <typename ContT>
+    void mark(const ContT& start, uint32_t slice_id)
+    {
+        for (NodeT *n : start)
+            enqueue(n, ASCEND);
+
+        while (!queues[ASCEND].empty() || !queues[DESCEND].empty()) {
+            // finish the first phase before going on with the second
+            Phase phase = queues[ASCEND].empty() ? DESCEND : ASCEND;
+            NodeT *n = queues[phase].back();
+            queues[phase].pop_back();
+            process(n, phase, slice_id);
+        }
+    }
+
+private:
+    enum Phase { ASCEND = 0, DESCEND = 1 };
+
+    using Base::queues;
+    using Base::queued;
+    using Base::test;
+    using Base::enqueue;
+    using Base::markSlice;
+
+    const SummaryEdgesT& summaries;
+
+    void process(NodeT *n, Phase phase, uint32_t slice_id)
+    {
+        // the edges of the nodes from the first phase were followed
+        // in the way the second phase would follow them
+        if (phase == DESCEND && test(queued[ASCEND], n))
+            return;
+
+        markSlice(n, slice_id);
+
+        if (DependenceGraph<NodeT> *dg = n->getDG()) {
+            // the call-sites are control dependent on the entry node
+            // via parameter-in edges, so the callers are kept only
+            // in the first phase
+            NodeT *entry = dg->getEntry();
+            assert(entry && "No entry node in dg");
+            enqueue(entry, phase);
+        }
+
+        auto follow = [this, n, phase](NodeT *pred) {
+            if (summaries.isParameterOut(pred, n))
+                enqueue(pred, DESCEND);
+            else if (summaries.isParameterIn(pred, n)) {
+                if (phase == ASCEND)
+                    enqueue(pred, ASCEND);
+            } else if (summaries.isInterprocedural(pred, n))
+                enqueue(pred, ASCEND);
+            else
+                enqueue(pred, phase);
+        };
+
+        legacy::forEachWalkedNode(n,
+                                  legacy::NODES_WALK_REV_CD |
+                                  legacy::NODES_WALK_REV_DD |
+                                  legacy::NODES_WALK_USER |
+                                  legacy::NODES_WALK_ID |
+                                  legacy::NODES_WALK_REV_ID,
+                                  follow);
+
+        if (phase == ASCEND) {
+            if (auto *sources = summaries.getSources(n)) {
+                for (NodeT *src : *sources)
+                    enqueue(src, ASCEND);
+            }
+        }
+    }
+};
+
 struct SlicerStatistics
 {
     SlicerStatistics()
@@ -124,6 +674,8 @@ class Slicer : legacy::Analysis<NodeT>
 {
     uint32_t options;
     uint32_t slice_id;
+    // the number of threads used for walking the graph in mark()
+    unsigned walk_threads{1};
 
     std::set<DependenceGraph<NodeT> *> sliced_graphs;
 
@@ -175,45 +727,114 @@ public:
         :options(opt), slice_id(0) {}
 
     SlicerStatistics& getStatistics() { return statistics; }
+    // set the number of threads used for walking the graph in mark()
+    void setWalkThreads(unsigned threads) { walk_threads = threads; }
     const SlicerStatistics& getStatistics() const { return statistics; }
 
     ///
     // Mark nodes dependent on 'start' with 'sl_id'.
     // If 'forward_slice' is true, mark the nodes depending on 'start' instead.
     uint32_t mark(NodeT *start, uint32_t sl_id = 0, bool forward_slice = false)
+    {
+        return mark(std::array<NodeT *, 1>{{start}}, sl_id, forward_slice);
+    }
+
+    ///
+    // Mark nodes dependent on any of the nodes from 'start' with 'sl_id'.
+    // This is the same as marking the nodes one by one, but the graph
+    // is walked only once.
+    template <typename ContT>
+    uint32_t mark(const ContT& start, uint32_t sl_id = 0, bool forward_slice = false)
+    {
+        if (sl_id == 0)
+            sl_id = ++slice_id;
+
+        // the integrated forward slicing uses one thread,
+        // with more threads walk the graph twice in parallel
+        if (forward_slice) {
+            if (walk_threads > 1)
+                return markForwardTwoWalks(start, sl_id);
+
+            ForwardWalkAndMark<NodeT> wm([this](NodeT *n) { prepareNode(n); });
+            wm.mark(start, sl_id);
+            return sl_id;
+        }
+
+        auto prepare = [this](NodeT *n) { prepareNode(n); };
+        WalkAndMark<NodeT> wm(false, prepare, walk_threads);
+        wm.mark(start, sl_id);
+
+        return sl_id;
+    }
+
+    ///
+    // Mark the forward slice like mark() does, but walk the dependencies
+    // forward first and then walk backward from the branchings that
+    // we need for the marked nodes (see ForwardWalkAndMark).
+    template <typename ContT>
+    uint32_t markForwardTwoWalks(const ContT& start, uint32_t sl_id = 0)
     {
         if (sl_id == 0)
             sl_id = ++slice_id;
 
-        WalkAndMark<NodeT> wm(forward_slice);
+        auto prepare = [this](NodeT *n) { prepareNode(n); };
+        WalkAndMark<NodeT> wm(true, prepare, walk_threads);
         wm.mark(start, sl_id);
 
         ///
-        // If we are performing forward slicing,
-        // we are missing the control dependencies now.
+        // We are missing the control dependencies now.
         // So gather all control dependencies of the nodes that
         // we want to have in the slice and perform normal backward
         // slicing w.r.t these nodes.
-        if (forward_slice) {
-            std::set<NodeT *> branchings;
-            for (auto *BB : wm.getMarkedBlocks()) {
+        std::set<NodeT *> branchings;
+        for (auto *BB : wm.getMarkedBlocks()) {
 #if ENABLE_CFG
-               for (auto cBB : BB->revControlDependence()) {
-                   assert(cBB->successorsNum() > 1);
-                   branchings.insert(cBB->getLastNode());
-               }
+           for (auto cBB : BB->revControlDependence()) {
+               assert(cBB->successorsNum() > 1);
+               branchings.insert(cBB->getLastNode());
+           }
 #endif
-            }
+        }
 
-            if (!branchings.empty()) {
-                WalkAndMark<NodeT> wm2;
-                wm2.mark(branchings, sl_id);
-            }
+        if (!branchings.empty()) {
+            WalkAndMark<NodeT> wm2(false, prepare, walk_threads);
+            wm2.mark(branchings, sl_id);
         }
 
         return sl_id;
     }
 
+    ///
+    // Mark the backward slice w.r.t. the nodes from 'start' with 'sl_id'
+    // using the summary edges, so that the slice contains only
+    // the callers of functions that can influence the nodes in 'start'
+    // (see ContextSensitiveWalkAndMark).
+    template <typename ContT, typename SummaryEdgesT>
+    uint32_t markContextSensitive(const ContT& start,
+                                  const SummaryEdgesT& summaries,
+                                  uint32_t sl_id = 0)
+    {
+        if (sl_id == 0)
+            sl_id = ++slice_id;
+
+        ContextSensitiveWalkAndMark<NodeT, SummaryEdgesT>
+            wm(summaries, [this](NodeT *n) { prepareNode(n); });
+        wm.mark(start, sl_id);
+
+        return sl_id;
+    }
+
+    ///
+    // Compute the (backward) slices w.r.t. every set of nodes
+    // from 'criteria' in a single walk of the graph.
+    // The returned object is used to mark the particular slices.
+    BatchWalkAndMark<NodeT> markBatch(const std::vector<std::set<NodeT *>>& criteria)
+    {
+        BatchWalkAndMark<NodeT> bwm([this](NodeT *n) { prepareNode(n); });
+        bwm.compute(criteria);
+        return bwm;
+    }
+
     // slice the graph and its subgraphs. mark needs to be called
     // before this routine (otherwise everything is sliced)
     uint32_t slice(DependenceGraph<NodeT> *dg, uint32_t sl_id = 0)
@@ -237,6 +858,11 @@ public:
         return true;
     }
 
+    // called for every node that is reached while marking the slice,
+    // before its dependencies are followed. It allows the backend
+    // to compute the dependencies of the node only on demand.
+    virtual void prepareNode(NodeT *) {}
+
 #ifdef ENABLE_CFG
     virtual bool removeBlock(BBlock<NodeT> *) {
         return true;
@@ -1,8 +1,14 @@
 #ifndef DG_LEGACY_NODES_WALK_H_
 #define DG_LEGACY_NODES_WALK_H_
 
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
 #include "dg/DGParameters.h"
 #include "dg/legacy/Analysis.h"
+#include "dg/util/parallel.h"
 
 namespace dg {
 namespace legacy {
@@ -31,6 +37,93 @@ enum NodesWalkFlags {
     NODES_WALK_BB_POSTDOM_FRONTIERS     = 1 << 12,
 };
 
+///
+// Call 'func' on every node that is reached from the node 'n'
+// via the edges given by 'options' (NodesWalkFlags).
+template <typename NodeT, typename FuncT>
+void forEachWalkedNode(NodeT *n, uint32_t options, FuncT& func)
+{
+    if (options & NODES_WALK_CD) {
+        for (auto I = n->control_begin(), E = n->control_end(); I != E; ++I)
+            func(*I);
+#ifdef ENABLE_CFG
+        // we can have control dependencies in BBlocks
+        if (BBlock<NodeT> *BB = n->getBBlock()) {
+            for (BBlock<NodeT> *CD : BB->controlDependence())
+                func(CD->getFirstNode());
+        }
+#endif // ENABLE_CFG
+    }
+
+    if (options & NODES_WALK_REV_CD) {
+        for (auto I = n->rev_control_begin(), E = n->rev_control_end(); I != E; ++I)
+            func(*I);
+#ifdef ENABLE_CFG
+        // push terminator nodes of all blocks that are
+        // control dependent
+        if (BBlock<NodeT> *BB = n->getBBlock()) {
+            for (BBlock<NodeT> *CD : BB->revControlDependence())
+                func(CD->getLastNode());
+        }
+#endif // ENABLE_CFG
+    }
+
+    if (options & NODES_WALK_DD) {
+        for (auto I = n->data_begin(), E = n->data_end(); I != E; ++I)
+            func(*I);
+    }
+
+    if (options & NODES_WALK_REV_DD) {
+        for (auto I = n->rev_data_begin(), E = n->rev_data_end(); I != E; ++I)
+            func(*I);
+    }
+
+    if (options & NODES_WALK_USE) {
+        for (auto I = n->use_begin(), E = n->use_end(); I != E; ++I)
+            func(*I);
+    }
+
+    if (options & NODES_WALK_USER) {
+        for (auto I = n->user_begin(), E = n->user_end(); I != E; ++I)
+            func(*I);
+    }
+
+    if (options & NODES_WALK_ID) {
+        for (auto I = n->interference_begin(), E = n->interference_end(); I != E; ++I)
+            func(*I);
+    }
+
+    if (options & NODES_WALK_REV_ID) {
+        for (auto I = n->rev_interference_begin(), E = n->rev_interference_end(); I != E; ++I)
+            func(*I);
+    }
+
+#ifdef ENABLE_CFG
+    BBlock<NodeT> *BB = n->getBBlock();
+    if (!BB)
+        return;
+
+    // Add to queue all first nodes of node's BB successors
+    if (options & NODES_WALK_BB_CFG) {
+        for (auto& E : BB->successors())
+            func(E.target->getFirstNode());
+    }
+
+    // Add to queue all last nodes of node's BB predecessors
+    if (options & NODES_WALK_BB_REV_CFG) {
+        for (BBlock<NodeT> *S : BB->predecessors())
+            func(S->getLastNode());
+    }
+
+    if (options & NODES_WALK_BB_POSTDOM_FRONTIERS) {
+        for (BBlock<NodeT> *S : BB->getPostDomFrontiers())
+            func(S->getLastNode());
+    }
+#endif // ENABLE_CFG
+
+    // FIXME interprocedural
+}
+
 // this is a base class for nodes walk, it contains
 // counter. If we would add counter (even static) into
 // NodesWalk itself, we'd have counter for every
@@ -42,13 +135,14 @@ class NodesWalkBase : public Analysis<NodeT>
 protected:
     // this counter will increase each time we run
     // NodesWalk, so it can be used as an indicator
-    // that we queued a node in a particular run or not
-    static unsigned int walk_run_counter;
+    // that we queued a node in a particular run or not.
+    // It is atomic, so that walks can run in more threads
+    static std::atomic<unsigned int> walk_run_counter;
 };
 
 // counter definition
 template<typename NodeT>
-unsigned int NodesWalkBase<NodeT>::walk_run_counter = 0;
+std::atomic<unsigned int> NodesWalkBase<NodeT>::walk_run_counter{0};
 
 template <typename NodeT, typename QueueT>
 class NodesWalk : public NodesWalkBase<NodeT>
@@ -71,6 +165,8 @@ public:
         for (auto ent : entry)
             enqueue(ent);
 
+        auto enqueueNode = [this](NodeT *n) { enqueue(n); };
+
         while (!queue.empty()) {
             NodeT *n = queue.pop();
 
@@ -83,53 +179,7 @@ public:
                 continue;
 
             // add unprocessed vertices
-            if (options & NODES_WALK_CD) {
-                processEdges(n->control_begin(), n->control_end());
-#ifdef ENABLE_CFG
-                // we can have control dependencies in BBlocks
-                processBBlockCDs(n);
-#endif // ENABLE_CFG
-            }
-
-            if (options & NODES_WALK_REV_CD) {
-                processEdges(n->rev_control_begin(), n->rev_control_end());
-
-#ifdef ENABLE_CFG
-                // we can have control dependencies in BBlocks
-                processBBlockRevCDs(n);
-#endif // ENABLE_CFG
-            }
-
-            if (options & NODES_WALK_DD)
-                processEdges(n->data_begin(), n->data_end());
-
-            if (options & NODES_WALK_REV_DD)
-                processEdges(n->rev_data_begin(), n->rev_data_end());
-
-            if (options & NODES_WALK_USE)
-                processEdges(n->use_begin(), n->use_end());
-
-            if (options & NODES_WALK_USER)
-                processEdges(n->user_begin(), n->user_end());
-
-            if (options & NODES_WALK_ID)
-                processEdges(n->interference_begin(), n->interference_end());
-
-            if (options & NODES_WALK_REV_ID)
-                processEdges(n->rev_interference_begin(), n->rev_interference_end());
-
-#ifdef ENABLE_CFG
-            if (options & NODES_WALK_BB_CFG)
-                processBBlockCFG(n);
-
-            if (options & NODES_WALK_BB_REV_CFG)
-                processBBlockRevCFG(n);
-#endif // ENABLE_CFG
-
-            if (options & NODES_WALK_BB_POSTDOM_FRONTIERS)
-                processBBlockPostDomFrontieres(n);
-
-            // FIXME interprocedural
+            forEachWalkedNode(n, options, enqueueNode);
         }
     }
 
@@ -162,74 +212,166 @@ protected:
     }
 
 private:
-       template <typename IT>
-    void processEdges(IT begin, IT end)
-    {
-        for (IT I = begin; I != end; ++I) {
-            enqueue(*I);
-        }
+    QueueT queue;
+    // id of particular nodes walk
+    unsigned int run_id;
+    uint32_t options;
+};
+
+///
+// Breadth-first walk of nodes that follows the same edges as NodesWalk,
+// but remembers the visited nodes in its own bitset indexed by the IDs
+// of nodes instead of marking the nodes. Therefore, more walks (even
+// of the same graph) can run at once.
+// The walk is level-synchronous: first 'func' is called (in the calling
+// thread) on all nodes of one level of the BFS, then the edges of these
+// nodes are followed to get the next level. With more threads, the edges
+// are followed in parallel (the graph must not be modified by 'func'
+// in a way that would race with reading the edges of other nodes).
+template <typename NodeT>
+class DenseNodesWalk
+{
+public:
+    DenseNodesWalk(uint32_t opts = 0, unsigned thrds = 1)
+        : options(opts), threads(thrds == 0 ? 1 : thrds) {}
+
+    virtual ~DenseNodesWalk() = default;
+
+    template <typename FuncT, typename DataT>
+    void walk(NodeT *entry, FuncT func, DataT data) {
+        walk<std::vector<NodeT *>, FuncT, DataT>({entry}, func, data);
     }
 
-#ifdef ENABLE_CFG
-    // we can have control dependencies in BBlocks
-    void processBBlockRevCDs(NodeT *n)
+    template <typename ContT, typename FuncT, typename DataT>
+    void walk(const ContT& entry, FuncT func, DataT data)
     {
-        // push terminator nodes of all blocks that are
-        // control dependent
-        BBlock<NodeT> *BB = n->getBBlock();
-        if (!BB)
-            return;
+        // start a new walk
+        for (size_t i = 0; i < visited_size / 64; ++i)
+            visited_bits[i].store(0, std::memory_order_relaxed);
+        _resize(NodeT::getMaxID() + 1);
+
+        for (NodeT *ent : entry)
+            enqueue(ent);
+
+        assert(!next.empty() && "Need entry node for traversing nodes");
 
-        for (BBlock<NodeT> *CD : BB->revControlDependence())
-            enqueue(CD->getLastNode());
+        std::vector<NodeT *> current;
+        while (!next.empty()) {
+            current.swap(next);
+            next.clear();
+
+            for (NodeT *n : current) {
+                prepare(n);
+                func(n, data);
+            }
+
+            // do not try to process edges if we know
+            // we should not
+            if (options == 0)
+                continue;
+
+            // 'prepare' and 'func' may have created new nodes
+            _resize(NodeT::getMaxID() + 1);
+            if (threads > 1 && current.size() >= PARALLEL_THRESHOLD)
+                _followEdgesParallel(current);
+            else {
+                auto enqueueNode = [this](NodeT *n) { enqueue(n); };
+                for (NodeT *n : current)
+                    forEachWalkedNode(n, options, enqueueNode);
+            }
+        }
     }
 
-    void processBBlockCDs(NodeT *n)
+    // push a node into the next level of the walk. This method
+    // is public so that 'func' can push some extra nodes.
+    void enqueue(NodeT *n)
     {
-        BBlock<NodeT> *BB = n->getBBlock();
-        if (!BB)
-            return;
+        if (n->getID() >= visited_size)
+            _resize(NodeT::getMaxID() + 1);
+        if (_setVisited(n))
+            next.push_back(n);
+    }
 
-        for (BBlock<NodeT> *CD : BB->controlDependence())
-            enqueue(CD->getFirstNode());
+    bool visited(const NodeT *n) const
+    {
+        auto id = n->getID();
+        return id < visited_size &&
+               (visited_bits[id / 64].load(std::memory_order_relaxed) & _bit(id));
     }
 
+    unsigned getThreads() const { return threads; }
+    void setThreads(unsigned t) { threads = t == 0 ? 1 : t; }
 
-    void processBBlockCFG(NodeT *n)
+protected:
+    // the same as NodesWalk::prepare
+    virtual void prepare(NodeT *n)
     {
-        BBlock<NodeT> *BB = n->getBBlock();
-        if (!BB)
-            return;
+        (void) n;
+    }
 
-        for (auto& E : BB->successors())
-            enqueue(E.target->getFirstNode());
+private:
+    // the levels smaller than this are not worth splitting between threads
+    enum : size_t { PARALLEL_THRESHOLD = 4096, CHUNK_SIZE = 512 };
+
+    static uint64_t _bit(unsigned id) { return uint64_t(1) << (id % 64); }
+
+    // return true if the node was not visited before
+    bool _setVisited(NodeT *n)
+    {
+        auto id = n->getID();
+        assert(id < visited_size);
+        auto& word = visited_bits[id / 64];
+        uint64_t bit = _bit(id);
+        if (word.load(std::memory_order_relaxed) & bit)
+            return false;
+        return !(word.fetch_or(bit, std::memory_order_relaxed) & bit);
     }
 
-    void processBBlockRevCFG(NodeT *n)
+    // must not be called while more threads follow the edges
+    void _resize(size_t size)
     {
-        BBlock<NodeT> *BB = n->getBBlock();
-        if (!BB)
+        if (size <= visited_size)
             return;
 
-        for (BBlock<NodeT> *S : BB->predecessors())
-            enqueue(S->getLastNode());
+        size_t words = (size + 63) / 64;
+        std::unique_ptr<std::atomic<uint64_t>[]> tmp(new std::atomic<uint64_t>[words]);
+        size_t old_words = (visited_size + 63) / 64;
+        for (size_t i = 0; i < words; ++i)
+            tmp[i].store(i < old_words ? visited_bits[i].load() : 0,
+                         std::memory_order_relaxed);
+
+        visited_bits.swap(tmp);
+        visited_size = words * 64;
     }
 
-    void processBBlockPostDomFrontieres(NodeT *n)
+    void _followEdgesParallel(const std::vector<NodeT *>& current)
     {
-        BBlock<NodeT> *BB = n->getBBlock();
-        if (!BB)
-            return;
-
-        for (BBlock<NodeT> *S : BB->getPostDomFrontiers())
-            enqueue(S->getLastNode());
+        size_t chunks = (current.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::vector<std::vector<NodeT *>> found(std::min<size_t>(threads, chunks));
+
+        parallelFor(chunks, threads, [&](size_t chunk, unsigned t) {
+            auto& out = found[t];
+            auto enqueueNode = [this, &out](NodeT *n) {
+                if (_setVisited(n))
+                    out.push_back(n);
+            };
+
+            size_t b = chunk * CHUNK_SIZE;
+            size_t e = std::min<size_t>(b + CHUNK_SIZE, current.size());
+            for (size_t i = b; i < e; ++i)
+                forEachWalkedNode(current[i], options, enqueueNode);
+        });
+
+        for (auto& out : found)
+            next.insert(next.end(), out.begin(), out.end());
     }
-#endif // ENABLE_CFG
 
-    QueueT queue;
-    // id of particular nodes walk
-    unsigned int run_id;
+    // the nodes of the next level of the walk
+    std::vector<NodeT *> next;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited_bits;
+    size_t visited_size{0};
     uint32_t options;
+    unsigned threads;
 };
 
 enum BBlockWalkFlags {
@@ -260,13 +402,14 @@ class BBlockWalkBase : public BBlockAnalysis<NodeT>
 protected:
     // this counter will increase each time we run
     // NodesWalk, so it can be used as an indicator
-    // that we queued a node in a particular run or not
-    static unsigned int walk_run_counter;
+    // that we queued a node in a particular run or not.
+    // It is atomic, so that walks can run in more threads
+    static std::atomic<unsigned int> walk_run_counter;
 };
 
 // counter definition
 template<typename NodeT>
-unsigned int BBlockWalkBase<NodeT>::walk_run_counter = 0;
+std::atomic<unsigned int> BBlockWalkBase<NodeT>::walk_run_counter{0};
 
 #ifdef ENABLE_CFG
 template <typename NodeT, typename QueueT>
@@ -94,6 +94,31 @@ public:
         return {};
     }
 
+    /// Incremental updates: tell the analysis about the changes of the CFG
+    /// (e.g., after slicing removed some blocks). Call insertEdge() and
+    /// deleteEdge() after the edge has been added or removed from the CFG
+    /// and deleteBlock() when the block has no edges anymore, but before
+    /// it is erased. The dependencies of the changed functions are updated
+    /// on the next query, the other functions keep their dependencies.
+    /// Supported with the standard control dependencies.
+    void insertEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) {
+        _impl->insertEdge(from, to);
+        if (getOptions().interproceduralCD())
+            _interprocImpl->insertEdge(from, to);
+    }
+
+    void deleteEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) {
+        _impl->deleteEdge(from, to);
+        if (getOptions().interproceduralCD())
+            _interprocImpl->deleteEdge(from, to);
+    }
+
+    void deleteBlock(const llvm::BasicBlock *B) {
+        _impl->deleteBlock(B);
+        if (getOptions().interproceduralCD())
+            _interprocImpl->deleteBlock(B);
+    }
+
     // FIXME: add also API that return just iterators
 };
 
@@ -7,6 +7,7 @@ namespace llvm {
     class Module;
     class Value;
     class Function;
+    class BasicBlock;
 };
 
 namespace dg {
@@ -44,6 +45,17 @@ public:
     virtual ValVec getNoReturns(const llvm::Function *) const {
         assert(false && "Unsupported"); abort();
     }
+
+    /// Notifications about changes of the CFG (see LLVMControlDependenceAnalysis)
+    virtual void insertEdge(const llvm::BasicBlock *, const llvm::BasicBlock *) {
+        assert(false && "Unsupported"); abort();
+    }
+    virtual void deleteEdge(const llvm::BasicBlock *, const llvm::BasicBlock *) {
+        assert(false && "Unsupported"); abort();
+    }
+    virtual void deleteBlock(const llvm::BasicBlock *) {
+        assert(false && "Unsupported"); abort();
+    }
 };
 
 
@@ -9,6 +9,13 @@ namespace dg {
 struct LLVMControlDependenceAnalysisOptions :
     public LLVMAnalysisOptions, ControlDependenceAnalysisOptions
 {
+    // the number of threads that compute the intraprocedural
+    // dependencies of different functions at once
+    unsigned workers{1};
+    // keep the post-dominator trees of the functions, so that they
+    // can be updated after changes of the CFG instead of being
+    // computed again
+    bool incremental{false};
 };
 
 } // namespace dg
@@ -42,6 +42,10 @@ class LLVMDataDependenceAnalysis
     LLVMReadWriteGraphBuilder *builder{nullptr};
     std::unique_ptr<DataDependenceAnalysis> DDA{nullptr};
 
+    // persistent mod/ref summaries of functions
+    ModRefSummaries _modRefSummaries{};
+    unsigned _reusedModRefSummaries{0};
+
     LLVMReadWriteGraphBuilder *createBuilder();
     DataDependenceAnalysis *createDDA();
 
@@ -68,8 +72,28 @@ public:
 
         assert(DDA);
         DDA->run();
+
+        if (!_options.modRefSummaries.empty()) {
+            updateModRefSummaries();
+        }
     }
 
+    ///
+    // Reuse the mod/ref summaries from the file given in the options
+    // for functions whose memory accesses did not change since
+    // the summaries were stored and compute the summaries
+    // of the rest of functions. Called from run().
+    // Return the number of reused summaries.
+    unsigned updateModRefSummaries();
+
+    ///
+    // Store the mod/ref summaries into the file given in the options
+    // (the summaries of functions from other modules that were in the
+    // file are kept). Return false on I/O error.
+    bool storeModRefSummaries() const;
+
+    unsigned getReusedModRefSummaries() const { return _reusedModRefSummaries; }
+
     const LLVMDataDependenceAnalysisOptions& getOptions() const { return _options; }
 
     ReadWriteGraph *getGraph() { return DDA->getGraph(); }
@@ -11,6 +11,10 @@ struct LLVMDataDependenceAnalysisOptions :
 {
     bool threads{false};
 
+    // a file with mod/ref summaries of functions stored by previous runs
+    // of the analysis (empty if the summaries should not be reused)
+    std::string modRefSummaries{};
+
     LLVMDataDependenceAnalysisOptions() {
         // setup models for standard functions
 
@@ -93,13 +93,15 @@ static std::ostream& printLLVMVal(std::ostream& os, const llvm::Value *val)
 
 class LLVMDG2Dot : public debug::DG2Dot<LLVMNode>
 {
+    LLVMDependenceGraph *llvmDG;
+
 public:
 
     // FIXME: make dg const
     LLVMDG2Dot(LLVMDependenceGraph *dg,
                uint32_t opts = debug::PRINT_CFG | debug::PRINT_DD | debug::PRINT_CD,
                const char *file = NULL)
-        : debug::DG2Dot<LLVMNode>(dg, opts, file) {}
+        : debug::DG2Dot<LLVMNode>(dg, opts, file), llvmDG(dg) {}
 
     /* virtual */
     std::ostream& printKey(std::ostream& os, llvm::Value *val)
@@ -185,8 +187,7 @@ public:
         if (!ensureFile(new_file))
             return false;
 
-        const std::map<llvm::Value *,
-                       LLVMDependenceGraph *>& CF = getConstructedFunctions();
+        const LLVMConstructedFunctions& CF = llvmDG->getConstructedFunctions();
 
         start();
 
@@ -222,12 +223,14 @@ private:
 
 class LLVMDGDumpBlocks : public debug::DG2Dot<LLVMNode>
 {
+    LLVMDependenceGraph *llvmDG;
+
 public:
 
     LLVMDGDumpBlocks(LLVMDependenceGraph *dg,
                   uint32_t opts = debug::PRINT_CFG | debug::PRINT_DD | debug::PRINT_CD,
                   const char *file = NULL)
-        : debug::DG2Dot<LLVMNode>(dg, opts, file) {}
+        : debug::DG2Dot<LLVMNode>(dg, opts, file), llvmDG(dg) {}
 
     /* virtual
     std::ostream& printKey(std::ostream& os, llvm::Value *val)
@@ -249,8 +252,7 @@ public:
         if (!ensureFile(new_file))
             return false;
 
-        const std::map<llvm::Value *,
-                       LLVMDependenceGraph *>& CF = getConstructedFunctions();
+        const LLVMConstructedFunctions& CF = llvmDG->getConstructedFunctions();
 
         start();
 
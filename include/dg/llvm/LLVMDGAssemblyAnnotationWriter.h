@@ -60,11 +60,13 @@ public:
 
 private:
 
+    const LLVMConstructedFunctions& functions;
     AnnotationOptsT opts;
     LLVMPointerAnalysis *PTA;
     LLVMDataDependenceAnalysis *DDA;
     const std::set<LLVMNode *> *criteria;
     std::string module_comment{};
+    bool module_comment_emitted{false};
 
     void printValue(const llvm::Value *val,
                     llvm::formatted_raw_ostream& os,
@@ -279,11 +281,12 @@ private:
     }
 
 public:
-    LLVMDGAssemblyAnnotationWriter(AnnotationOptsT o = ANNOTATE_SLICE,
+    LLVMDGAssemblyAnnotationWriter(const LLVMConstructedFunctions& functions,
+                                   AnnotationOptsT o = ANNOTATE_SLICE,
                                    LLVMPointerAnalysis *pta = nullptr,
                                    LLVMDataDependenceAnalysis *dda = nullptr,
                                    const std::set<LLVMNode *>* criteria = nullptr)
-        : opts(o), PTA(pta), DDA(dda), criteria(criteria)
+        : functions(functions), opts(o), PTA(pta), DDA(dda), criteria(criteria)
     {
         assert(!(opts & ANNOTATE_PTR) || PTA);
         assert(!(opts & ANNOTATE_DU) || DDA);
@@ -302,9 +305,8 @@ public:
     {
         // dump the slicer's setting to the file
         // for easier comprehension
-        static bool didit = false;
-        if (!didit) {
-            didit = true;
+        if (!module_comment_emitted) {
+            module_comment_emitted = true;
             os << module_comment;
         }
     }
@@ -316,7 +318,7 @@ public:
             return;
 
         LLVMNode *node = nullptr;
-        for (auto& it : getConstructedFunctions()) {
+        for (auto& it : functions) {
             LLVMDependenceGraph *sub = it.second;
             node = sub->getNode(const_cast<llvm::Instruction *>(I));
             if (node)
@@ -335,7 +337,7 @@ public:
         if (opts == 0)
             return;
 
-        for (auto& it : getConstructedFunctions()) {
+        for (auto& it : functions) {
             LLVMDependenceGraph *sub = it.second;
             auto& cb = sub->getBlocks();
             auto I = cb.find(const_cast<llvm::BasicBlock *>(B));
@@ -10,6 +10,8 @@
 #endif
 
 #include <map>
+#include <memory>
+#include <set>
 #include <unordered_map>
 
 #include "dg/llvm/ThreadRegions/ControlFlowGraph.h"
@@ -45,6 +47,14 @@ using dda::LLVMDataDependenceAnalysis;
 
 using LLVMBBlock = dg::BBlock<LLVMNode>;
 
+class LLVMDependenceGraph;
+
+// Graphs of the functions that were built together (the graph
+// of the entry function and all its subgraphs). Every build
+// has its own map, so more modules can be processed at once.
+using LLVMConstructedFunctions
+    = std::unordered_map<llvm::Value *, LLVMDependenceGraph *>;
+
 /// ------------------------------------------------------------------
 //  -- LLVMDependenceGraph
 /// ------------------------------------------------------------------
@@ -53,9 +63,13 @@ class LLVMDependenceGraph : public DependenceGraph<LLVMNode>
     // our artificial unified exit block
     std::unique_ptr<LLVMBBlock> unifiedExitBB{};
     llvm::Function *entryFunction{nullptr};
+    // shared by all the graphs from one build
+    std::shared_ptr<LLVMConstructedFunctions> constructedFunctions;
 public:
     LLVMDependenceGraph(bool threads = false)
-        : gather_callsites(nullptr), threads(threads), module(nullptr), PTA(nullptr) {}
+        : constructedFunctions(std::make_shared<LLVMConstructedFunctions>()),
+          gather_callsites(nullptr), threads(threads), module(nullptr),
+          PTA(nullptr), DDA(nullptr) {}
 
     // free all allocated memory and unref subgraphs
     ~LLVMDependenceGraph();
@@ -88,6 +102,11 @@ public:
 
     llvm::Module *getModule() const { return module; }
 
+    // graphs of all functions that were built together with this graph
+    const LLVMConstructedFunctions& getConstructedFunctions() const {
+        return *constructedFunctions;
+    }
+
     // if we want to slice according some call-site(s),
     // we can gather the relevant call-sites while building
     // graph and do not need to recursively find in the graph
@@ -124,9 +143,9 @@ public:
 
     void computeControlDependencies(const LLVMControlDependenceAnalysisOptions& opts) {
         if (opts.standardCD()) {
-            computePostDominators(true);
-        } else if (opts.ntscdCD()) {
-            computeNonTerminationControlDependencies();
+            computePostDominators(true, opts.workers);
+        } else if (opts.ntscdCD() || opts.ntscd2CD()) {
+            computeNonTerminationControlDependencies(opts);
         } else
             abort();
 
@@ -155,16 +174,55 @@ public:
 
     LLVMNode *findNode(llvm::Value *value) const;
 
-    void addDefUseEdges();
+    // Add def-use edges to the graph and its subgraphs. If 'lazy' is set,
+    // the data dependencies of reads from memory are not computed here,
+    // but only when materializeDataDependencies() is called on the node.
+    void addDefUseEdges(bool lazy = false);
+
+    // Add data dependence edges of a node from this graph whose computation
+    // was postponed by addDefUseEdges(true). Does nothing if the edges
+    // have been added already.
+    void materializeDataDependencies(LLVMNode *node);
+
+    // Drop the postponed data dependencies of a node
+    // that is going to be removed from the graph.
+    void forgetDataDependencies(LLVMNode *node) {
+        lazyDataDependencies.erase(node);
+    }
+
     void computeInterferenceDependentEdges(ControlFlowGraph * controlFlowGraph);
     void computeForkJoinDependencies(ControlFlowGraph * controlFlowGraph);
     void computeCriticalSections(ControlFlowGraph * controlFlowGraph);
+
+    // Call 'F' on every node of all the constructed graphs, including
+    // the nodes of parameters and the global nodes.
+    template <typename FuncT>
+    void forEachNode(FuncT F) const;
+
+    // release the memory that the nodes reserved for adding new edges
+    void compactEdges() {
+        forEachNode([](LLVMNode *n) { n->compactEdges(); });
+    }
+
 private:
-    void computePostDominators(bool addPostDomFrontiers = false);
-    void computeNonTerminationControlDependencies();
+    template <typename FuncT>
+    static void forEachParameterNode(LLVMDGParameters *params, FuncT& F);
+
+    void computePostDominators(bool addPostDomFrontiers = false,
+                               unsigned workers = 1);
+    void computeNonTerminationControlDependencies(const LLVMControlDependenceAnalysisOptions& opts);
+
+    // the loads of a thread region with their points-to sets and the stores
+    // of the region indexed by the memory objects and offsets they write to
+    struct InterferenceAccesses;
+
+    void getInterferenceAccesses(const std::set<const llvm::Instruction *> &llvmInstructions,
+                                 InterferenceAccesses &accesses) const;
 
-    void computeInterferenceDependentEdges(const std::set<const llvm::Instruction *> &loads,
-                                           const std::set<const llvm::Instruction *> &stores);
+    // add interference edges from the stores of 'storesRegion'
+    // to the loads of 'loadsRegion' that may read what they write
+    void computeInterferenceDependentEdges(const InterferenceAccesses &loadsRegion,
+                                           const InterferenceAccesses &storesRegion);
 
     std::set<const llvm::Instruction *> getLoadInstructions(const std::set<const llvm::Instruction *> &llvmInstructions) const;
     std::set<const llvm::Instruction *> getStoreInstructions(const std::set<const llvm::Instruction *> &llvmInstructions) const;
@@ -207,16 +265,64 @@ private:
     LLVMDataDependenceAnalysis *DDA;
     //LLVMControlDependenceAnalysis *CDA;
 
+    // nodes of this graph whose data dependencies were not computed yet
+    std::set<LLVMNode *> lazyDataDependencies;
+
     // verifier needs access to private elements
     friend class LLVMDGVerifier;
+    friend class LLVMDefUseAnalysis;
 };
 
-const std::map<llvm::Value *,
-               LLVMDependenceGraph *>& getConstructedFunctions();
+template <typename FuncT>
+void LLVMDependenceGraph::forEachParameterNode(LLVMDGParameters *params,
+                                               FuncT& F) {
+    if (!params)
+        return;
+
+    auto pair = [&F](const DGParameterPair<LLVMNode> *p) {
+        if (p->in)
+            F(p->in);
+        if (p->out)
+            F(p->out);
+    };
+
+    for (auto& it : *params)
+        pair(&it.second);
+    for (auto I = params->global_begin(), E = params->global_end(); I != E; ++I)
+        pair(&I->second);
+    if (auto *vararg = params->getVarArg())
+        pair(vararg);
+    if (auto *noret = params->getNoReturn())
+        F(noret);
+}
+
+template <typename FuncT>
+void LLVMDependenceGraph::forEachNode(FuncT F) const {
+    for (auto& it : getConstructedFunctions()) {
+        LLVMDependenceGraph *graph = it.second;
+        for (auto& nit : *graph->getNodes()) {
+            F(nit.second);
+            forEachParameterNode(nit.second->getParameters(), F);
+        }
+
+        // the exit node may be artificial, then it is not in the nodes
+        LLVMNode *exit = graph->getExit();
+        if (exit && !graph->getNode(exit->getKey()))
+            F(exit);
+
+        forEachParameterNode(graph->getParameters(), F);
+    }
+
+    // entry nodes of the graphs are among the global nodes
+    if (auto globals = getGlobalNodes()) {
+        for (auto& it : *globals)
+            F(it.second);
+    }
+}
 
 LLVMNode *
-findInstruction(llvm::Instruction * instruction, 
-                const std::map<llvm::Value *, LLVMDependenceGraph *> & constructedFunctions);
+findInstruction(llvm::Instruction * instruction,
+                const LLVMConstructedFunctions& constructedFunctions);
 
 llvm::Instruction * castToLLVMInstruction(const llvm::Value * value);
 } // namespace dg
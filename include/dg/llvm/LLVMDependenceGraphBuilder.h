@@ -55,6 +55,9 @@ struct LLVMDependenceGraphOptions {
 
     bool verifyGraph{true};
     bool threads{false};
+    // compute data dependencies of reads from memory only for the nodes
+    // that are reached while marking a backward slice
+    bool lazyDataDependencies{false};
 
     std::string entryFunction{"main"};
 
@@ -102,6 +105,20 @@ class LLVMDependenceGraphBuilder {
         _timerStart();
         _DDA->run();
         _statistics.rdaTime = _timerEnd();
+
+        if (!_options.DDAOptions.modRefSummaries.empty() &&
+            !_DDA->storeModRefSummaries()) {
+            llvm::errs() << "Failed storing mod/ref summaries into "
+                         << _options.DDAOptions.modRefSummaries << "\n";
+        }
+    }
+
+    void _addDefUseEdges() {
+        // the data dependence analysis is demand-driven,
+        // so the most of its work is done here
+        _timerStart();
+        _dg->addDefUseEdges(_options.lazyDataDependencies);
+        _statistics.rdaTime += _timerEnd();
     }
 
     void _runControlDependenceAnalysis() {
@@ -165,6 +182,7 @@ public:
 
     LLVMPointerAnalysis *getPTA() { return _PTA.get(); }
     LLVMDataDependenceAnalysis *getDDA() { return _DDA.get(); }
+    LLVMControlDependenceAnalysis *getCDA() { return _CDA.get(); }
 
     const Statistics& getStatistics() const { return _statistics; }
 
@@ -178,7 +196,7 @@ public:
         _dg->build(_M, _PTA.get(), _DDA.get(), _entryFunction);
 
         // insert the data dependencies edges
-        _dg->addDefUseEdges();
+        _addDefUseEdges();
 
         // compute and fill-in control dependencies
         _runControlDependenceAnalysis();
@@ -194,6 +212,9 @@ public:
             _runCriticalSectionAnalysis();
         }
 
+        // no more edges are going to be added (but lazy data dependencies)
+        _dg->compactEdges();
+
         // verify if the graph is built correctly
         if (_options.verifyGraph && !_dg->verify()) {
             _dg.reset();
@@ -241,7 +262,7 @@ public:
 
         // data-dependence edges
         _runDataDependenceAnalysis();
-        _dg->addDefUseEdges();
+        _addDefUseEdges();
 
         // fill-in control dependencies
         _runControlDependenceAnalysis();
@@ -252,6 +273,8 @@ public:
             _runCriticalSectionAnalysis();
         }
 
+        _dg->compactEdges();
+
         return std::move(_dg);
     }
 
@@ -23,6 +23,8 @@
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
 
 #if (__clang__)
 #pragma clang diagnostic pop // ignore -Wunused-parameter
@@ -30,17 +32,20 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
 #include "dg/Slicing.h"
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMNode.h"
+#include "dg/llvm/ControlDependence/ControlDependence.h"
 
 namespace dg {
 
 class LLVMNode;
 
-extern std::map<const llvm::Value *,
-                LLVMDependenceGraph *> constructedFunctions;
-
 namespace llvmdg {
 
 template <typename Val>
@@ -69,31 +74,40 @@ public:
         dont_touch.insert(n);
     }
 
-    bool removeNode(LLVMNode *node) override
+    // tell the control dependence analysis about the changes
+    // of the CFG made by slicing (the in-place slicing only)
+    void setControlDependence(LLVMControlDependenceAnalysis *cda)
     {
-        using namespace llvm;
-
-        Value *val = node->getKey();
-        // if there are any other uses of this value,
-        // just replace them with undef
-        val->replaceAllUsesWith(UndefValue::get(val->getType()));
+        _cda = cda;
+    }
 
-        Instruction *Inst = dyn_cast<Instruction>(val);
-        if (Inst) {
-            Inst->eraseFromParent();
-        } else {
-            GlobalVariable *GV = dyn_cast<GlobalVariable>(val);
-            if (GV)
-                GV->eraseFromParent();
-        }
+    bool removeNode(LLVMNode *node) override
+    {
+        if (LLVMDependenceGraph *dg = node->getDG())
+            dg->forgetDataDependencies(node);
 
+        eraseValue(node->getKey());
         return true;
     }
 
+    // compute the data dependencies of the node if they were
+    // postponed while building the graph
+    void prepareNode(LLVMNode *node) override
+    {
+        if (LLVMDependenceGraph *dg = node->getDG())
+            dg->materializeDataDependencies(node);
+    }
+
     bool removeBlock(LLVMBBlock *block) override
     {
         assert(block);
 
+        // the nodes are deleted together with the block
+        for (LLVMNode *node : block->getNodes()) {
+            if (LLVMDependenceGraph *dg = node->getDG())
+                dg->forgetDataDependencies(node);
+        }
+
         llvm::Value *val = block->getKey();
         if (val == nullptr)
             return true;
@@ -112,19 +126,7 @@ public:
                 adjustPhiNodes(llvm::cast<llvm::BasicBlock>(sval), blk);
         }
 
-        // We need to drop the reference to this block in all
-        // braching instructions that jump to this block.
-        // See #99
-        dropAllUses(blk);
-
-        // we also must drop refrences to instructions that are in
-        // this block (or we would need to delete the blocks in
-        // post-dominator order), see #101
-        for (llvm::Instruction& Inst : *blk)
-            dropAllUses(&Inst);
-
-        // finally, erase the block per se
-        blk->eraseFromParent();
+        eraseBlock(blk);
         return true;
     }
 
@@ -138,7 +140,7 @@ public:
         return 0;
     }
 
-    uint32_t slice(LLVMDependenceGraph *,
+    uint32_t slice(LLVMDependenceGraph *dg,
                    LLVMNode *start, uint32_t sl_id = 0)
     {
         // mark nodes for slicing
@@ -148,7 +150,7 @@ public:
 
         // take every subgraph and slice it intraprocedurally
         // this includes the main graph
-        for (auto& it : constructedFunctions) {
+        for (auto& it : dg->getConstructedFunctions()) {
             if (dontTouch(it.first->getName()))
                 continue;
 
@@ -159,7 +161,166 @@ public:
         return sl_id;
     }
 
+    ///
+    // Write the slice into a new module. Unlike slice(), this method
+    // leaves the graph and the module untouched, so it can be called
+    // for several slices marked in the graph. The sliced functions
+    // are not copied as a whole, only the blocks and instructions
+    // from the slice are cloned into the new module.
+    // The nodes from the slice must be marked with 'sl_id' before.
+    std::unique_ptr<llvm::Module> sliceCopy(LLVMDependenceGraph *dg,
+                                            uint32_t sl_id)
+    {
+        assert(sl_id != 0 && "Slice id must be set");
+
+        std::set<const llvm::Value *> sliced;
+        for (auto& it : dg->getConstructedFunctions()) {
+            if (!dontTouch(it.first->getName()))
+                sliced.insert(it.first);
+        }
+
+        // copy the rest of the module and only
+        // the declarations of the sliced functions
+        llvm::ValueToValueMapTy VMap;
+        auto shouldClone = [&sliced](const llvm::GlobalValue *GV) {
+            return sliced.count(GV) == 0;
+        };
+#if LLVM_VERSION_MAJOR >= 7
+        auto M = llvm::CloneModule(*dg->getModule(), VMap, shouldClone);
+#elif LLVM_VERSION_MAJOR > 3 || LLVM_VERSION_MINOR >= 9
+        auto M = llvm::CloneModule(dg->getModule(), VMap, shouldClone);
+#else
+        // we can not skip the bodies, so throw them away
+        std::unique_ptr<llvm::Module> M(llvm::CloneModule(dg->getModule(), VMap));
+        for (const llvm::Value *F : sliced)
+            llvm::cast<llvm::Function>(VMap[F])->deleteBody();
+#endif
+
+        statistics = SlicerStatistics();
+        for (auto& it : dg->getConstructedFunctions()) {
+            if (sliced.count(it.first) > 0)
+                sliceGraphCopy(it.second, sl_id, VMap);
+        }
+
+        return M;
+    }
+
 private:
+    // the edges of the CFG of a function
+    using CFGEdges = std::set<std::pair<llvm::BasicBlock *, llvm::BasicBlock *>>;
+
+    static CFGEdges getCFGEdges(llvm::Function *F)
+    {
+        CFGEdges edges;
+        for (llvm::BasicBlock& B : *F) {
+            auto *tinst = B.getTerminator();
+            if (!tinst)
+                continue;
+            for (unsigned i = 0; i < tinst->getNumSuccessors(); ++i) {
+                if (llvm::BasicBlock *succ = tinst->getSuccessor(i))
+                    edges.emplace(&B, succ);
+            }
+        }
+        return edges;
+    }
+
+    // Tell the control dependence analysis how the CFG of the function
+    // changed, 'oldEdges' are the edges before slicing. The removed
+    // blocks lose their edges first, then the analysis is told about
+    // the changes and only then the blocks are erased.
+    void updateControlDependence(llvm::Function *F, const CFGEdges& oldEdges)
+    {
+        for (llvm::BasicBlock *blk : _erasedBlocks) {
+            auto *tinst = blk->getTerminator();
+            if (tinst && tinst->getNumSuccessors() > 0) {
+                tinst->eraseFromParent();
+                new llvm::UnreachableInst(blk->getContext(), blk);
+            }
+        }
+
+        auto newEdges = getCFGEdges(F);
+        for (const auto& edge : oldEdges) {
+            if (newEdges.count(edge) == 0)
+                _cda->deleteEdge(edge.first, edge.second);
+        }
+        for (const auto& edge : newEdges) {
+            if (oldEdges.count(edge) == 0)
+                _cda->insertEdge(edge.first, edge.second);
+        }
+
+        for (llvm::BasicBlock *blk : _erasedBlocks) {
+            _cda->deleteBlock(blk);
+            blk->eraseFromParent();
+        }
+        _erasedBlocks.clear();
+    }
+
+    static void eraseValue(llvm::Value *val)
+    {
+        using namespace llvm;
+
+        // if there are any other uses of this value,
+        // just replace them with undef
+        val->replaceAllUsesWith(UndefValue::get(val->getType()));
+
+        Instruction *Inst = dyn_cast<Instruction>(val);
+        if (Inst) {
+            Inst->eraseFromParent();
+        } else {
+            GlobalVariable *GV = dyn_cast<GlobalVariable>(val);
+            if (GV)
+                GV->eraseFromParent();
+        }
+    }
+
+    void eraseBlock(llvm::BasicBlock *blk)
+    {
+        // We need to drop the reference to this block in all
+        // braching instructions that jump to this block.
+        // See #99
+        dropAllUses(blk);
+
+        // we also must drop refrences to instructions that are in
+        // this block (or we would need to delete the blocks in
+        // post-dominator order), see #101
+        for (llvm::Instruction& Inst : *blk)
+            dropAllUses(&Inst);
+
+        // the control dependence analysis must see the block
+        // until we tell it about the changes of the CFG
+        if (_cda) {
+            // the new blocks may take the name of this block
+            blk->setName("");
+            _erasedBlocks.push_back(blk);
+            return;
+        }
+
+        // finally, erase the block per se
+        blk->eraseFromParent();
+    }
+
+    // fill in the block just with return from the function
+    static llvm::ReturnInst *createReturn(llvm::BasicBlock *block)
+    {
+        using namespace llvm;
+
+        LLVMContext& Ctx = block->getContext();
+        Function *F = block->getParent();
+
+        if (F->getReturnType()->isVoidTy())
+            return ReturnInst::Create(Ctx, block);
+        else if (F->getName().equals("main"))
+            // if this is main, than the safe exit equals to returning 0
+            // (it is just for convenience, we wouldn't need to do this)
+            return ReturnInst::Create(Ctx,
+                                      ConstantInt::get(Type::getInt32Ty(Ctx), 0),
+                                      block);
+        else
+            return ReturnInst::Create(Ctx,
+                                      UndefValue::get(F->getReturnType()),
+                                      block);
+    }
+
         /*
     void sliceCallNode(LLVMNode *callNode,
                        LLVMDependenceGraph *graph, uint32_t slice_id)
@@ -248,19 +409,7 @@ private:
         F->getBasicBlockList().push_back(block);
 
         // fill in basic block just with return value
-        ReturnInst *RI;
-        if (F->getReturnType()->isVoidTy())
-            RI = ReturnInst::Create(Ctx, block);
-        else if (F->getName().equals("main"))
-            // if this is main, than the safe exit equals to returning 0
-            // (it is just for convenience, we wouldn't need to do this)
-            RI = ReturnInst::Create(Ctx,
-                                    ConstantInt::get(Type::getInt32Ty(Ctx), 0),
-                                    block);
-        else
-            RI = ReturnInst::Create(Ctx,
-                                    UndefValue::get(F->getReturnType()),
-                                    block);
+        ReturnInst *RI = createReturn(block);
 
         LLVMNode *newRet = new LLVMNode(RI);
         graph->addNode(newRet);
@@ -279,149 +428,37 @@ private:
         LLVMBBlock *newExitBB = createNewExitBB(graph);
         graph->setExitBB(newExitBB);
         graph->setExit(newExitBB->getLastNode());
-        // do not add the block to the graph,
-        // we'll do it at the end of adjustBBlocksSucessors,
-        // because this function is called while iterating
-        // over blocks, so that we won't corrupt the iterator
+        // do not add the block to the graph, the caller
+        // does it once it reconnected the other blocks
 
         return newExitBB;
     }
 
-    // when we sliced away a branch of CFG, we need to reconnect it
-    // to exit block, since on this path we would silently terminate
-    // (this path won't have any effect on the property anymore)
-    void adjustBBlocksSucessors(LLVMDependenceGraph *graph, uint32_t slice_id)
+    void sliceGraph(LLVMDependenceGraph *graph, uint32_t slice_id)
     {
-        LLVMBBlock *oldExitBB = graph->getExitBB();
-        assert(oldExitBB && "Don't have exit BB");
-
-        LLVMBBlock *newExitBB = nullptr;
-
-        for (auto& it : graph->getBlocks()) {
-            const llvm::BasicBlock *llvmBB
-                = llvm::cast<llvm::BasicBlock>(it.first);
-            const auto tinst = llvmBB->getTerminator();
-            LLVMBBlock *BB = it.second;
-
-            // nothing to do
-            if (BB->successorsNum() == 0)
-                continue;
-
-            // if the BB has two successors and one is self-loop and
-            // the branch inst is going to be removed, then the brach
-            // that created the self-loop has no meaning to the sliced
-            // program and this is going to be an unconditional jump
-            // to the other branch
-            // NOTE: do this before the next action, to rename the label if needed
-            if (BB->successorsNum() == 2
-                && BB->getLastNode()->getSlice() != slice_id
-                && !BB->successorsAreSame()) {
-
-#ifndef NDEBUG
-                bool found =
-#endif
-                BB->removeSuccessorsTarget(BB);
-                // we have two different successors, none of them
-                // is self-loop and we're slicing away the brach inst?
-                // This should not happen...
-                assert(found && "This should not happen...");
-                assert(BB->successorsNum() == 1 && "Should have only one successor");
-
-                // continue here to rename the only label if needed
-            }
-
-            // if the BB has only one successor and the terminator
-            // instruction is going to be sliced away, it means that
-            // this is going to be an unconditional jump,
-            // so just make the label 0
-            if (BB->successorsNum() == 1
-                && BB->getLastNode()->getSlice() != slice_id) {
-                auto edge = *(BB->successors().begin());
-
-                // modify the edge
-                edge.label = 0;
-                if (edge.target == oldExitBB) {
-                     if (!newExitBB)
-                        newExitBB = addNewExitBB(graph);
-
-                    edge.target = newExitBB;
-                }
-
-                // replace the only edge
-                BB->removeSuccessors();
-                BB->addSuccessor(edge);
-
-                continue;
-            }
-
-            // when we have more successors, we need to fill in
-            // jumps under labels that we sliced away
-
-            DGContainer<uint8_t> labels;
-            // go through BBs successors and gather all labels
-            // from edges that go from this BB. Also if there's
-            // a jump to return block, replace it with new
-            // return block
-            for (const auto& succ : BB->successors()) {
-                // skip artificial return basic block.
-                if (succ.label == 255 || succ.target == oldExitBB)
-                    continue;
-
-                labels.insert(succ.label);
-            }
-
-            // replace missing labels. Label should be from 0 to some max,
-            // no gaps, so jump to safe exit under missing labels
-            for (uint8_t i = 0; i < tinst->getNumSuccessors(); ++i) {
-                if (!labels.contains(i)) {
-                     if (!newExitBB)
-                        newExitBB = addNewExitBB(graph);
+        auto *F = llvm::cast<llvm::Function>(graph->getEntry()->getKey());
+        CFGEdges oldEdges;
+        if (_cda)
+            oldEdges = getCFGEdges(F);
 
-#ifndef NDEBUG
-                    bool ret =
-#endif
-                    BB->addSuccessor(newExitBB, i);
-                    assert(ret && "Already had this CFG edge, that is wrong");
-                }
-            }
+        // compute the successors of the blocks that stay
+        // before we start removing the blocks
+        SlicedCFG cfg = getSlicedCFG(graph, slice_id);
 
-            // this BB is going to be removed
-            if (newExitBB)
-                BB->removeSuccessorsTarget(oldExitBB);
-
-            // if we have all successor edges pointing to the same
-            // block, replace them with one successor (thus making
-            // unconditional jump)
-            if (BB->successorsNum() > 1 && BB->successorsAreSame()) {
-                LLVMBBlock *succ = BB->successors().begin()->target;
-
-                BB->removeSuccessors();
-                BB->addSuccessor(succ, 0);
-#ifdef NDEBUG
-                assert(BB->successorsNum() == 1
-                       && "BUG: in removeSuccessors() or addSuccessor()");
-#endif
-            }
-
-#ifndef NDEBUG
-            // check the BB
-            labels.clear();
-            for (const auto& succ : BB->successors()) {
-                assert((!newExitBB || succ.target != oldExitBB)
-                        && "A block has the old BB as successor");
-                // we can have more labels with different targets,
-                // but we can not have one target with more labels
-                assert(labels.insert(succ.label) && "Already have a label");
-            }
+        // first slice away bblocks that should go away
+        for (LLVMBBlock *blk : cfg.removed) {
+            // call specific handlers and remove block from the graph
+            if (removeBlock(blk))
+                blk->remove();
+        }
 
-            // check that we have all labels without any gep
-            auto l = labels.begin();
-            for (unsigned i = 0; i < labels.size(); ++i) {
-                // set is ordered, so this must hold
-                // (as 255 is the last possible label)
-                assert((*l == 255 || i == *l++) && "Labels have a gap");
-            }
-#endif
+        // make graph complete
+        LLVMBBlock *newExitBB = cfg.newExitBB ? addNewExitBB(graph) : nullptr;
+        for (auto& it : cfg.edges) {
+            LLVMBBlock *BB = it.first;
+            BB->removeSuccessors();
+            for (const auto& edge : it.second)
+                BB->addSuccessor(edge.first ? edge.first : newExitBB, edge.second);
         }
 
         if (newExitBB) {
@@ -432,15 +469,6 @@ private:
             // unique_ptr, so it will be deleted later automatically.
             // Deleting it would lead to double-free
         }
-    }
-
-    void sliceGraph(LLVMDependenceGraph *graph, uint32_t slice_id)
-    {
-        // first slice away bblocks that should go away
-        sliceBBlocks(graph, slice_id);
-
-        // make graph complete
-        adjustBBlocksSucessors(graph, slice_id);
 
         // now slice away instructions from BBlocks that left
         for (auto I = graph->begin(), E = graph->end(); I != E;) {
@@ -479,12 +507,357 @@ private:
         // create new CFG edges between blocks after slicing
         reconnectLLLVMBasicBlocks(graph);
 
+        if (_cda)
+            updateControlDependence(F, oldEdges);
+
         // if we sliced away entry block, our new entry block
         // may have predecessors, which is not allowed in the
         // LLVM
         ensureEntryBlock(graph);
     }
 
+    // successors of blocks after slicing, with labels. nullptr as
+    // the target is the new exit block (see adjustSlicedEdges)
+    using SlicedEdges = std::set<std::pair<LLVMBBlock *, uint8_t>>;
+
+    // the CFG of the graph after slicing, shared by the slicer
+    // that slices the graph in place and by the copying one
+    struct SlicedCFG {
+        // the blocks that go away
+        std::set<LLVMBBlock *> removed;
+        // the successors of the blocks that stay
+        std::map<LLVMBBlock *, SlicedEdges> edges;
+        // do some edges go to the new exit block?
+        bool newExitBB{false};
+    };
+
+    // The blocks (or the exit block) that get to be the successors
+    // of a predecessor of the removed block 'block' once all the
+    // removed blocks are isolated (see BBlock::isolate).
+    static const std::vector<LLVMBBlock *>&
+    getKeptSuccessors(LLVMBBlock *block,
+                      const std::set<LLVMBBlock *>& removed,
+                      std::map<LLVMBBlock *, std::vector<LLVMBBlock *>>& cache)
+    {
+        auto it = cache.find(block);
+        if (it != cache.end())
+            return it->second;
+
+        auto& ret = cache[block];
+        std::set<LLVMBBlock *> visited{block};
+        std::vector<LLVMBBlock *> stack{block};
+        while (!stack.empty()) {
+            LLVMBBlock *cur = stack.back();
+            stack.pop_back();
+
+            for (const auto& succ : cur->successors()) {
+                if (!visited.insert(succ.target).second)
+                    continue;
+
+                if (removed.count(succ.target) > 0)
+                    stack.push_back(succ.target);
+                else
+                    ret.push_back(succ.target);
+            }
+        }
+
+        return ret;
+    }
+
+    static bool slicedEdgesAreSame(const SlicedEdges& edges)
+    {
+        for (const auto& edge : edges) {
+            if (edge.first != edges.begin()->first)
+                return false;
+        }
+        return true;
+    }
+
+    // when we sliced away a branch of CFG, we need to reconnect it
+    // to exit block, since on this path we would silently terminate
+    // (this path won't have any effect on the property anymore)
+    static void adjustSlicedEdges(LLVMBBlock *BB, SlicedEdges& edges,
+                                  const llvm::Instruction *tinst,
+                                  LLVMBBlock *oldExitBB, bool& newExitBB,
+                                  uint32_t slice_id)
+    {
+        // nothing to do
+        if (edges.empty())
+            return;
+
+        bool slicedTerminator = BB->getLastNode()->getSlice() != slice_id;
+        auto removeTarget = [&edges](LLVMBBlock *target) {
+            for (auto I = edges.begin(), E = edges.end(); I != E;) {
+                auto cur = I++;
+                if (cur->first == target)
+                    edges.erase(cur);
+            }
+        };
+
+        // if the BB has two successors and one is self-loop and
+        // the branch inst is going to be removed, then the brach
+        // that created the self-loop has no meaning to the sliced
+        // program and this is going to be an unconditional jump
+        // to the other branch
+        // NOTE: do this before the next action, to rename the label if needed
+        if (edges.size() == 2 && slicedTerminator
+            && !slicedEdgesAreSame(edges)) {
+            removeTarget(BB);
+            assert(edges.size() == 1 && "Should have only one successor");
+        }
+
+        // if the BB has only one successor and the terminator
+        // instruction is going to be sliced away, it means that
+        // this is going to be an unconditional jump,
+        // so just make the label 0
+        if (edges.size() == 1 && slicedTerminator) {
+            LLVMBBlock *target = edges.begin()->first;
+            if (target == oldExitBB) {
+                newExitBB = true;
+                target = nullptr;
+            }
+
+            edges.clear();
+            edges.emplace(target, 0);
+            return;
+        }
+
+        // when we have more successors, we need to fill in
+        // jumps under labels that we sliced away
+        std::set<uint8_t> labels;
+        for (const auto& edge : edges) {
+            // skip artificial return basic block.
+            if (edge.second == 255 || edge.first == oldExitBB)
+                continue;
+            labels.insert(edge.second);
+        }
+
+        // replace missing labels. Label should be from 0 to some max,
+        // no gaps, so jump to safe exit under missing labels
+        for (uint8_t i = 0; i < tinst->getNumSuccessors(); ++i) {
+            if (labels.count(i) == 0) {
+                newExitBB = true;
+                edges.emplace(nullptr, i);
+            }
+        }
+
+        // the old exit block is replaced by the new one
+        if (newExitBB)
+            removeTarget(oldExitBB);
+
+        // if we have all successor edges pointing to the same
+        // block, replace them with one successor (thus making
+        // unconditional jump)
+        if (edges.size() > 1 && slicedEdgesAreSame(edges)) {
+            LLVMBBlock *target = edges.begin()->first;
+            edges.clear();
+            edges.emplace(target, 0);
+        }
+    }
+
+    // Compute the blocks that are sliced away and the successors
+    // of the blocks that stay, without touching the graph
+    SlicedCFG getSlicedCFG(LLVMDependenceGraph *graph, uint32_t slice_id)
+    {
+        LLVMBBlock *oldExitBB = graph->getExitBB();
+        assert(oldExitBB && "Don't have exit BB");
+
+        // The blocks that are not in the slice. We remove also
+        // the marked blocks that have no node in the slice
+        // (the slicing criteria may have been unmarked)
+        SlicedCFG cfg;
+        for (auto& it : graph->getBlocks()) {
+            LLVMBBlock *BB = it.second;
+            if (BB->getSlice() == slice_id) {
+                bool hasSliceNode = false;
+                for (LLVMNode *n : BB->getNodes()) {
+                    if (n->getSlice() == slice_id) {
+                        hasSliceNode = true;
+                        break;
+                    }
+                }
+                if (hasSliceNode)
+                    continue;
+            }
+
+            cfg.removed.insert(BB);
+            statistics.nodesRemoved += BB->size();
+            statistics.nodesTotal += BB->size();
+            ++statistics.blocksRemoved;
+        }
+
+        // the successors of the remaining blocks, adjusted
+        // in the order of the blocks in the graph
+        std::map<LLVMBBlock *, std::vector<LLVMBBlock *>> cache;
+        for (auto& it : graph->getBlocks()) {
+            LLVMBBlock *BB = it.second;
+            if (cfg.removed.count(BB) > 0)
+                continue;
+
+            auto& E = cfg.edges[BB];
+            for (const auto& succ : BB->successors()) {
+                if (cfg.removed.count(succ.target) == 0) {
+                    E.emplace(succ.target, succ.label);
+                    continue;
+                }
+
+                for (LLVMBBlock *target : getKeptSuccessors(succ.target, cfg.removed, cache))
+                    E.emplace(target, succ.label);
+            }
+
+            const auto *blk = llvm::cast<llvm::BasicBlock>(it.first);
+            adjustSlicedEdges(BB, E, blk->getTerminator(),
+                              oldExitBB, cfg.newExitBB, slice_id);
+        }
+
+        return cfg;
+    }
+
+    ///
+    // Clone the sliced function of the graph into the declaration
+    // of the function in the new module, 'VMap' maps the values
+    // of the original module to the new module. We do the same
+    // as sliceGraph() does, but we only read the graph and we clone
+    // only the blocks and instructions that stay in the slice.
+    void sliceGraphCopy(LLVMDependenceGraph *graph, uint32_t slice_id,
+                        llvm::ValueToValueMapTy& VMap)
+    {
+        using namespace llvm;
+
+        auto mapBlock = [&VMap](const LLVMBBlock *block) {
+            assert(block->getKey() && "A block without a key");
+            return cast<BasicBlock>(VMap.lookup(block->getKey()));
+        };
+
+        const Function *origF = cast<Function>(graph->getEntry()->getKey());
+        Function *F = cast<Function>(VMap.lookup(origF));
+        assert(F->empty() && "The body of the function was cloned");
+
+        SlicedCFG cfg = getSlicedCFG(graph, slice_id);
+        const auto& removed = cfg.removed;
+        const auto& edges = cfg.edges;
+
+        // nothing from the function is in the slice,
+        // leave just the declaration
+        if (edges.empty())
+            return;
+
+        // the function was only declared in the new module
+        F->setLinkage(origF->getLinkage());
+        if (origF->hasPersonalityFn())
+            F->setPersonalityFn(MapValue(origF->getPersonalityFn(), VMap));
+
+        SmallVector<std::pair<unsigned, MDNode *>, 1> MDs;
+        origF->getAllMetadata(MDs);
+        for (auto& MD : MDs)
+            F->setMetadata(MD.first, MapMetadata(MD.second, VMap));
+
+        auto newArg = F->arg_begin();
+        for (const Argument& A : origF->args()) {
+            newArg->setName(A.getName());
+            VMap[&A] = &*newArg++;
+        }
+
+        // clone the instructions from the slice, the values that are
+        // sliced away are replaced with undef as in eraseValue()
+        const auto *nodes = graph->getNodes();
+        std::vector<Instruction *> cloned;
+        for (const BasicBlock& B : *origF) {
+            auto bit = graph->getBlocks().find(const_cast<BasicBlock *>(&B));
+            if (bit == graph->getBlocks().end() ||
+                removed.count(bit->second) > 0) {
+                for (const Instruction& I : B) {
+                    if (!I.getType()->isVoidTy())
+                        VMap[&I] = UndefValue::get(I.getType());
+                }
+                continue;
+            }
+
+            BasicBlock *newB = BasicBlock::Create(F->getContext(), B.getName(), F);
+            VMap[&B] = newB;
+
+            for (const Instruction& I : B) {
+                auto nit = nodes->find(const_cast<Instruction *>(&I));
+                if (nit != nodes->end() && nit->second != graph->getExit()) {
+                    ++statistics.nodesTotal;
+                    if (shouldSliceInst(&I) &&
+                        nit->second->getSlice() != slice_id) {
+                        if (!I.getType()->isVoidTy())
+                            VMap[&I] = UndefValue::get(I.getType());
+                        ++statistics.nodesRemoved;
+                        continue;
+                    }
+                }
+
+                Instruction *newI = I.clone();
+                if (I.hasName())
+                    newI->setName(I.getName());
+                newB->getInstList().push_back(newI);
+                VMap[&I] = newI;
+                cloned.push_back(newI);
+            }
+        }
+
+        for (Instruction *I : cloned) {
+            // the incoming blocks that were sliced away (see adjustPhiNodes)
+            if (PHINode *phi = dyn_cast<PHINode>(I)) {
+                for (unsigned i = phi->getNumIncomingValues(); i > 0; --i) {
+                    if (!VMap.count(phi->getIncomingBlock(i - 1)))
+                        phi->removeIncomingValue(i - 1, false);
+                }
+            }
+
+            // the successors of the terminators are set below
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 8))
+            RemapInstruction(I, VMap, RF_IgnoreMissingEntries);
+#else
+            RemapInstruction(I, VMap, RF_IgnoreMissingLocals);
+#endif
+        }
+
+        BasicBlock *newExit = nullptr;
+        if (cfg.newExitBB) {
+            newExit = BasicBlock::Create(F->getContext(), "safe_return", F);
+            createReturn(newExit);
+        }
+
+        // create new CFG edges between blocks after slicing
+        for (auto& it : edges) {
+            BasicBlock *llvmBB = mapBlock(it.first);
+            auto target = [&](LLVMBBlock *block) {
+                return block ? mapBlock(block) : newExit;
+            };
+
+            auto tinst = llvmBB->getTerminator();
+            if (!tinst) {
+                // see reconnectBBlock
+                if (it.second.size() == 1 && it.second.begin()->second != 255)
+                    BranchInst::Create(target(it.second.begin()->first), llvmBB);
+                else
+                    createReturn(llvmBB);
+                continue;
+            }
+
+            // all the successors were merged into one, but the
+            // terminator stays in the slice (it may have no dependent
+            // nodes if the slicing criteria were unmarked)
+            if (it.second.size() == 1 && it.second.begin()->second != 255) {
+                auto *succ = target(it.second.begin()->first);
+                for (unsigned i = 0; i < tinst->getNumSuccessors(); ++i)
+                    tinst->setSuccessor(i, succ);
+                continue;
+            }
+
+            for (const auto& edge : it.second) {
+                if (edge.second == 255)
+                    continue;
+                tinst->setSuccessor(edge.second, target(edge.first));
+            }
+        }
+
+        ensureEntryBlock(F);
+    }
+
     bool dontTouch(const llvm::StringRef& r)
     {
         for (const char *n : dont_touch)
@@ -515,8 +888,6 @@ private:
             //  unterminated. The same may happen if we remove unconditional
             //  branch inst
 
-            LLVMContext& Ctx = llvmBB->getContext();
-            Function *F = cast<Function>(llvmBB->getParent());
             bool create_return = true;
 
             if (BB->successorsNum() == 1) {
@@ -534,18 +905,7 @@ private:
                 assert(BB->successorsNum() == 0
                         && "Creating return to BBlock that has successors");
 
-                if (F->getReturnType()->isVoidTy())
-                    ReturnInst::Create(Ctx, llvmBB);
-                else if (F->getName().equals("main"))
-                    // if this is main, than the safe exit equals to returning 0
-                    // (it is just for convenience, we wouldn't need to do this)
-                    ReturnInst::Create(Ctx,
-                                       ConstantInt::get(Type::getInt32Ty(Ctx), 0),
-                                       llvmBB);
-                else
-                    ReturnInst::Create(Ctx,
-                                       UndefValue::get(F->getReturnType()), llvmBB);
-
+                createReturn(llvmBB);
             }
 
             // and that is all we can do here
@@ -579,26 +939,33 @@ private:
 
     void ensureEntryBlock(LLVMDependenceGraph *graph)
     {
-        using namespace llvm;
+        llvm::Value *val = graph->getEntry()->getKey();
+        llvm::BasicBlock *block = ensureEntryBlock(llvm::cast<llvm::Function>(val));
+        if (block && _cda)
+            _cda->insertEdge(block, block->getSingleSuccessor());
+
+        // FIXME: propagate this change to dependence graph
+    }
 
-        Value *val = graph->getEntry()->getKey();
-        Function *F = cast<Function>(val);
+    // returns the new entry block if it was created
+    static llvm::BasicBlock *ensureEntryBlock(llvm::Function *F)
+    {
+        using namespace llvm;
 
         // Function is empty, just bail out
         if(F->begin() == F->end())
-            return;
+            return nullptr;
 
         BasicBlock *entryBlock = &F->getEntryBlock();
 
         if (pred_begin(entryBlock) == pred_end(entryBlock)) {
             // entry block has no predecessor, we're ok
-            return;
+            return nullptr;
         }
 
         // it has some predecessor, create new one, that will just
         // jump on it
-        LLVMContext& Ctx = graph->getModule()->getContext();
-        BasicBlock *block = BasicBlock::Create(Ctx, "single_entry");
+        BasicBlock *block = BasicBlock::Create(F->getContext(), "single_entry");
 
         // jump to the old entry block
         BranchInst::Create(entryBlock, block);
@@ -606,12 +973,16 @@ private:
         // set it as a new entry by pusing the block to the front
         // of the list
         F->getBasicBlockList().push_front(block);
-
-        // FIXME: propagate this change to dependence graph
+        return block;
     }
 
     // do not slice these functions at all
     std::set<const char *> dont_touch;
+
+    LLVMControlDependenceAnalysis *_cda{nullptr};
+    // the blocks whose erasing is postponed until
+    // the control dependence analysis knows about the changes
+    std::vector<llvm::BasicBlock *> _erasedBlocks;
 };
 
 } // namespace llvmdg
@@ -0,0 +1,124 @@
+#ifndef LLVM_DG_SUMMARY_EDGES_H_
+#define LLVM_DG_SUMMARY_EDGES_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "dg/llvm/LLVMNode.h"
+
+namespace dg {
+
+class LLVMDependenceGraph;
+
+///
+// Summary edges of the graphs that were built together.
+// A summary edge goes from an actual-in parameter of a call-site
+// to an actual-out parameter of the call-site if the corresponding
+// formal-out parameter of the called function depends on the formal-in
+// parameter (via a path in the callee, possibly going over summary
+// edges of other call-sites). The call node plays the role of the
+// actual parameter for the entry node (a call edge) and for the exit
+// node (the returned value). The summary edges are stored here and not
+// in the nodes, as only the context-sensitive slicing needs them.
+class LLVMSummaryEdges
+{
+public:
+    // compute the summary edges of 'dg' and all the graphs
+    // that were built with it
+    void compute(const LLVMDependenceGraph& dg);
+
+    // the nodes that have a summary edge to 'n' (nullptr if there are none)
+    const std::vector<LLVMNode *> *getSources(const LLVMNode *n) const
+    {
+        auto it = _sources.find(n);
+        return it == _sources.end() ? nullptr : &it->second;
+    }
+
+    // is from -> to an edge from a call-site to the called function
+    // (from an actual-in parameter to a formal-in parameter or from
+    // the call node to the entry node)?
+    bool isParameterIn(const LLVMNode *from, const LLVMNode *to) const
+    {
+        return (_kind(to) & FORMAL_IN) && (_kind(from) & ACTUAL);
+    }
+
+    // is from -> to an edge from a called function back to the call-site
+    // (from a formal-out parameter, the noreturn node or the exit node)?
+    // The edges from the entry node to the users of the function
+    // (the calls and the instructions that take the address of the
+    // function) are treated the same way: the users need the function,
+    // but not its callers.
+    bool isParameterOut(const LLVMNode *from, const LLVMNode *to) const
+    {
+        return ((_kind(from) & FORMAL_OUT) && (_kind(to) & ACTUAL)) ||
+               ((_kind(from) & ENTRY) && isInterprocedural(from, to));
+    }
+
+    // do the nodes belong to different functions?
+    bool isInterprocedural(const LLVMNode *from, const LLVMNode *to) const
+    {
+        return _procedure(from) != _procedure(to);
+    }
+
+    // the number of summary edges
+    size_t size() const { return _edges.size(); }
+
+private:
+    enum : uint8_t { FORMAL_IN = 1, FORMAL_OUT = 2, ACTUAL = 4, ENTRY = 8 };
+    enum : unsigned { NONE = ~0U };
+
+    struct NodeInfo {
+        uint8_t kind{0};
+        // the function of the node
+        unsigned procedure{NONE};
+        // the index of the node among the nodes of its function and
+        // the index of the formal parameter among the formal parameters
+        // of the function (used when computing the summary edges)
+        unsigned local{NONE};
+        unsigned formal{NONE};
+    };
+
+    // the nodes of the graphs. They are not indexed by their IDs,
+    // because the IDs are shared with the nodes of other graphs.
+    std::unordered_map<const LLVMNode *, NodeInfo> _nodes;
+    // actual-out -> actual-ins
+    std::unordered_map<const LLVMNode *, std::vector<LLVMNode *>> _sources;
+    // the summary edges (pairs of node IDs) for removing duplicates
+    std::unordered_set<uint64_t> _edges;
+
+    const NodeInfo *_info(const LLVMNode *n) const
+    {
+        auto it = _nodes.find(n);
+        return it == _nodes.end() ? nullptr : &it->second;
+    }
+
+    uint8_t _kind(const LLVMNode *n) const
+    {
+        auto *info = _info(n);
+        return info ? info->kind : 0;
+    }
+
+    unsigned _procedure(const LLVMNode *n) const
+    {
+        auto *info = _info(n);
+        return info ? info->procedure : NONE;
+    }
+
+    bool addEdge(LLVMNode *from, LLVMNode *to)
+    {
+        uint64_t key = (uint64_t(from->getID()) << 32) | to->getID();
+        if (!_edges.insert(key).second)
+            return false;
+
+        _sources[to].push_back(from);
+        return true;
+    }
+
+    friend class SummaryEdgesComputation;
+};
+
+} // namespace dg
+
+#endif // LLVM_DG_SUMMARY_EDGES_H_
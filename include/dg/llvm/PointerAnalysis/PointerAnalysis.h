@@ -126,7 +126,7 @@ public:
                     return true;
                 }
             }
-            return callsite->getPairedNode()->addPointsTo(UnknownPointer);
+            return callsite->getPairedNode()->addPointsTo(this->PG->getUnknownPointer());
         }
 
         if (!LLVMPointerGraphBuilder::callIsCompatible(callsite, called)) {
@@ -187,6 +187,8 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
     PointerGraph *PS = nullptr;
     std::unique_ptr<pta::PointerAnalysis> PTA{}; // dg pointer analysis object
     std::unique_ptr<LLVMPointerGraphBuilder> _builder;
+    // the points-to set of the values that the analysis does not know
+    PointsToSetT _unknownPTSet;
 
     LLVMPointerAnalysisOptions createOptions(const char *entry_func,
                                              uint64_t field_sensitivity,
@@ -199,11 +201,7 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
         return opts;
     }
 
-    const PointsToSetT& getUnknownPTSet() const {
-        static const PointsToSetT _unknownPTSet
-            = PointsToSetT({Pointer{pta::UNKNOWN_MEMORY, 0}});
-        return _unknownPTSet;
-    }
+    const PointsToSetT& getUnknownPTSet() const { return _unknownPTSet; }
 
 public:
 
@@ -214,7 +212,8 @@ public:
         : DGLLVMPointerAnalysis(m, createOptions(entry_func, field_sensitivity, threads)) {}
 
     DGLLVMPointerAnalysis(const llvm::Module *m, const LLVMPointerAnalysisOptions opts)
-        : LLVMPointerAnalysis(opts), _builder(new LLVMPointerGraphBuilder(m, opts)) {}
+        : LLVMPointerAnalysis(opts), _builder(new LLVMPointerGraphBuilder(m, opts)),
+          _unknownPTSet({Pointer{_builder->getPS()->getUnknownMemory(), 0}}) {}
 
     ///
     // Get the node from pointer analysis that holds the points-to set.
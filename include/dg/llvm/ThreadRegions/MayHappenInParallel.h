@@ -1,18 +1,74 @@
 #ifndef MAYHAPPENINPARALLEL_H
 #define MAYHAPPENINPARALLEL_H
 
+#include <cstdint>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "ThreadRegion.h"
 
+class Node;
+class ForkNode;
+
+///
+// May-happen-in-parallel relation of thread regions. The regions of
+// a thread forked by a fork node may run in parallel with the regions
+// that follow the fork (including the regions of threads forked later)
+// up to the joins that can join only the forked thread. The joins stop
+// the search only if the fork cannot be executed again before them,
+// otherwise they may join the thread of another execution of the fork.
+// Locks do not order the regions, so the regions that run under the same
+// lock are still parallel. The relation is stored as a bit matrix.
 class MayHappenInParallel
 {
 private:
-    std::set<ThreadRegion *> threadRegions_;
+    using Bits = std::vector<uint64_t>;
+
+    std::vector<ThreadRegion *> threadRegions_;
+    std::unordered_map<const ThreadRegion *, size_t> index_;
+    std::unordered_map<const Node *, size_t> nodeToRegion_;
+
+    // the successors of the regions over the control flow (including
+    // calls and returns), the fork edges and the exit -> join edges
+    std::vector<std::vector<size_t>> successors_;
+    std::vector<std::vector<size_t>> forkSuccessors_;
+    std::vector<std::vector<size_t>> joinSuccessors_;
+
+    size_t words_{0};
+    Bits parallel_;
+    // the forks whose threads contain the region (sorted)
+    std::vector<std::vector<size_t>> forks_;
+
+    void buildRegionGraph();
+    void addFork(const ForkNode *fork, size_t forkIndex);
+
+    Bits reachable(const std::vector<size_t>& start, bool followJoins,
+                   const Bits *stop = nullptr) const;
+
+    static bool testBit(const Bits& bits, size_t i) {
+        return bits[i / 64] & (uint64_t(1) << (i % 64));
+    }
+    static void setBit(Bits& bits, size_t i) {
+        bits[i / 64] |= uint64_t(1) << (i % 64);
+    }
+    uint64_t *row(size_t i) { return parallel_.data() + i * words_; }
+    const uint64_t *row(size_t i) const { return parallel_.data() + i * words_; }
+
 public:
     MayHappenInParallel(std::set<ThreadRegion *> threadRegions);
 
     std::set<ThreadRegion *> parallelRegions(ThreadRegion * threadRegion);
+
+    bool mayHappenInParallel(const ThreadRegion *first,
+                             const ThreadRegion *second) const;
+
+    ///
+    // Do the regions run in the same threads? That is, are they (both or
+    // neither) in the threads created by the same forks? The regions that
+    // run in different threads can still be ordered by the forks and joins.
+    bool inSameThreads(const ThreadRegion *first,
+                       const ThreadRegion *second) const;
 };
 
 #endif // MAYHAPPENINPARALLEL_H
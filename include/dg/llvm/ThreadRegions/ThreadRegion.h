@@ -1,6 +1,7 @@
 #ifndef THREADREGION_H
 #define THREADREGION_H
 
+#include <atomic>
 #include <set>
 #include <iosfwd>
 
@@ -19,7 +20,7 @@ class ThreadRegion
     std::set<ThreadRegion *>    predecessors_;
     std::set<ThreadRegion *>    successors_;
 
-    static int lastId;
+    static std::atomic<int> lastId;
 
 public:
     ThreadRegion(Node * node);
@@ -0,0 +1,48 @@
+#ifndef DG_PARALLEL_UTILS_H_
+#define DG_PARALLEL_UTILS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace dg {
+
+///
+// Call func(i, t) for every i from [0, size) in at most 'threads'
+// threads. The threads take the indices one by one from a shared
+// counter (the items may take very different time, e.g., functions
+// of different sizes) and the calling thread works too. 't' is the
+// number of the thread that handles the item (less than 'threads'),
+// so that the threads can store the results into their own buffers.
+// The calls for different items must be independent.
+template <typename FuncT>
+void parallelFor(size_t size, unsigned threads, FuncT func)
+{
+    unsigned num = static_cast<unsigned>(std::min<size_t>(std::max(threads, 1U), size));
+    if (num <= 1) {
+        for (size_t i = 0; i < size; ++i)
+            func(i, 0U);
+        return;
+    }
+
+    std::atomic<size_t> pos{0};
+    auto worker = [&](unsigned t) {
+        size_t i;
+        while ((i = pos.fetch_add(1)) < size)
+            func(i, t);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num - 1);
+    for (unsigned t = 1; t < num; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& thr : workers)
+        thr.join();
+}
+
+} // namespace dg
+
+#endif
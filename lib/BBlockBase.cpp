@@ -2,6 +2,6 @@
 
 namespace dg {
 
-unsigned BBlockId::idcnt = 0;
+std::atomic<unsigned> BBlockId::idcnt{0};
 
 }
@@ -181,6 +181,28 @@ MemorySSATransformation::findDefinitionsInPredecessors(RWBBlock *block,
 
     std::vector<RWNode *> defs;
 
+    // with eager phi placement, the definitions from predecessors
+    // are the phi nodes at the beginning of this block or
+    // the definitions in the immediate dominator
+    if (options.eagerPhiPlacement) {
+        auto& si = getSubgraphInfo(block->getSubgraph());
+        auto *idom = si.dominators.getIDom(block);
+        if (idom && si.hasPhisFor(ds.target)) {
+            auto& phis = getBBlockInfo(block).getEntryPhis();
+            auto phidefs = phis.get(ds);
+            defs.insert(defs.end(), phidefs.begin(), phidefs.end());
+            for (auto& interval : phis.undefinedIntervals(ds)) {
+                auto idomdefs = findDefinitions(idom, {ds.target,
+                                                       interval.start,
+                                                       interval.length()});
+                defs.insert(defs.end(), idomdefs.begin(), idomdefs.end());
+            }
+            return defs;
+        }
+        // the entry block or no phis for this memory,
+        // fall-back to the on-demand search
+    }
+
     // if we have a unique predecessor,
     // we can find the definitions there and continue searching in the predecessor
     // if something is missing
@@ -264,7 +286,7 @@ bool MemorySSATransformation::callMayDefineTarget(RWNodeCall *C, RWNode *target)
             auto& si = getSubgraphInfo(subg);
             computeModRef(subg, si);
             assert(si.modref.isInitialized());
-            if (si.modref.mayDefineOrUnknown(target)) {
+            if (si.modref.mayDefineOrUnknown(target, graph.getUnknownMemory())) {
                 return true;
             }
         }
@@ -283,31 +305,43 @@ void MemorySSATransformation::findDefinitionsInSubgraph(RWNode *phi,
     computeModRef(subg, si);
     assert(si.modref.isInitialized());
 
-    // we must create a new phi for each subgraph inside the subgraph
-    // (these phis will be merged by the single 'phi'.
-    // Of course, we create them only when not already present.
-    for (auto& subginterval : summary.getUncoveredOutputs(ds)) {
-        auto subgds = DefSite{ds.target,
-                              subginterval.start,
-                              subginterval.length()};
-
-        // do not search the procedure if it cannot define the memory
-        // (this saves creating PHI nodes). If it may define only
-        // unknown memory, add that definitions directly and continue searching
-        // before the call.
-        if (!si.modref.mayDefine(ds.target)) {
-            if (si.modref.mayDefineUnknown()) {
+    // the outputs created by previous searches
+    // (e.g., from other call-sites)
+    phi->addDefUse(summary.getOutputs(ds));
+
+    // do not search the procedure if it cannot define the memory
+    // (this saves creating PHI nodes). If it may define only
+    // unknown memory, add that definitions directly and continue searching
+    // before the call. The outputs reused from other call-sites contain only
+    // the definitions of unknown memory, so we must continue the search
+    // before this call also for the intervals that they cover.
+    if (!si.modref.mayDefine(ds.target)) {
+        if (si.modref.mayDefine(graph.getUnknownMemory())) {
+            for (auto& subginterval : summary.getUncoveredOutputs(ds)) {
+                auto subgds = DefSite{ds.target,
+                                      subginterval.start,
+                                      subginterval.length()};
                 auto *subgphi = createPhi(subgds, /* type = */ RWNodeType::OUTARG);
                 summary.addOutput(subgds, subgphi);
-                for (auto& it : si.modref.getMayDef(UNKNOWN_MEMORY)) {
+                for (auto& it : si.modref.getMayDef(graph.getUnknownMemory())) {
                     subgphi->addDefUse(it);
                 }
                 phi->addDefUse(subgphi);
             }
-            // continue search before the call
-            phi->addDefUse(findDefinitions(C, subgds));
-            continue;
         }
+        // continue search before the call
+        phi->addDefUse(findDefinitions(C, ds));
+        DBG_SECTION_END(tmp, "Done searching definitions in subgraph " << subg->getName());
+        return;
+    }
+
+    // we must create a new phi for each subgraph inside the subgraph
+    // (these phis will be merged by the single 'phi'.
+    // Of course, we create them only when not already present.
+    for (auto& subginterval : summary.getUncoveredOutputs(ds)) {
+        auto subgds = DefSite{ds.target,
+                              subginterval.start,
+                              subginterval.length()};
 
         auto *subgphi = createPhi(subgds, /* type = */ RWNodeType::OUTARG);
         summary.addOutput(subgds, subgphi);
@@ -406,6 +440,8 @@ void MemorySSATransformation::findDefinitionsFromCalledFun(RWNode *phi,
 ///
 Definitions&
 MemorySSATransformation::getBBlockDefinitions(RWBBlock *b, const DefSite *ds) {
+    placePhis(b);
+
     auto& bi = getBBlockInfo(b);
     auto& D = bi.getDefinitions();
 
@@ -451,6 +487,7 @@ void MemorySSATransformation::performLvn(Definitions& D, RWBBlock *block) {
 Definitions
 MemorySSATransformation::findDefinitionsInBlock(RWNode *to, const RWNode *mem) {
     auto *block = to->getBBlock();
+    placePhis(block);
     // perform LVN up to the node
     Definitions D;
     for (RWNode *node : block->getNodes()) {
@@ -467,6 +504,7 @@ MemorySSATransformation::findDefinitionsInBlock(RWNode *to, const RWNode *mem) {
 Definitions
 MemorySSATransformation::findEscapingDefinitionsInBlock(RWNode *to) {
     auto *block = to->getBBlock();
+    placePhis(block);
     // perform LVN up to the node
     Definitions D;
     for (RWNode *node : block->getNodes()) {
@@ -616,8 +654,8 @@ MemorySSATransformation::collectAllDefinitionsInCallers(Definitions& defs,
 
     // create an input PHI node
     auto& summary = getSubgraphSummary(subg);
-    DefSite ds{UNKNOWN_MEMORY};
-    RWNode *phi = summary.getUnknownPhi();
+    DefSite ds{graph.getUnknownMemory()};
+    RWNode *phi = summary.getUnknownPhi(graph.getUnknownMemory());
     if (!phi) {
         phi = createPhi(ds, /* type = */ RWNodeType::INARG);
         summary.addInput(ds, phi);
@@ -739,19 +777,20 @@ void MemorySSATransformation::initialize() {
     // remove useless blocks and nodes
     graph.optimize();
 
-    // make sure we have a constant-time access to information
-    _subgraphs_info.reserve(graph.size());
+    // the information is indexed by the indices of subgraphs and blocks,
+    // which do not change from now on
+    _subgraphs_info.resize(graph.size());
 
     for (auto *subg : graph.subgraphs()) {
-        auto& si = _subgraphs_info[subg];
-        si._bblock_infos.reserve(subg->size());
+        auto& si = getSubgraphInfo(subg);
+        si._bblock_infos.resize(subg->size());
 
         // initialize information about basic blocks
         for (auto *bb : subg->bblocks()) {
             if (bb->size() == 1) {
                 if (auto *C = RWNodeCall::get(bb->getFirst())) {
                     if (C->callsDefined()) {
-                        si._bblock_infos[bb].setCallBlock(C);
+                        si.getBBlockInfo(bb).setCallBlock(C);
                     }
                 }
             }
@@ -1,3 +1,5 @@
+#include <set>
+
 #include "dg/MemorySSA/MemorySSA.h"
 #include "dg/util/debug.h"
 
@@ -72,5 +74,254 @@ void MemorySSATransformation::computeModRef(RWSubgraph *subg, SubgraphInfo& si)
     DBG_SECTION_END(dda, "Computing modref for subgraph " << subg->getName() << " done");
 }
 
+///
+// Persistent mod/ref summaries
+///
+
+// the unknown memory is not created by the front-end,
+// so it cannot name it
+static const char *UNKNOWN_MEMORY_NAME = "?unknown";
+
+static std::string getNodeName(const RWNode *node, const RWNodeNaming& naming) {
+    if (node->isUnknown())
+        return UNKNOWN_MEMORY_NAME;
+    return naming.getName(node);
+}
+
+static RWNode *getNamedNode(const std::string& name, RWNode *unknown,
+                            const RWNodeNaming& naming) {
+    if (name == UNKNOWN_MEMORY_NAME)
+        return unknown;
+    return naming.getNode(name);
+}
+
+// 64-bit FNV-1a hash, we need it to be stable across runs
+class Fingerprint {
+    uint64_t _hash{14695981039346656037ULL};
+
+    void addBytes(const void *data, size_t len) {
+        auto *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < len; ++i) {
+            _hash ^= bytes[i];
+            _hash *= 1099511628211ULL;
+        }
+    }
+
+public:
+    void add(const std::string& str) {
+        add(static_cast<uint64_t>(str.size()));
+        addBytes(str.data(), str.size());
+    }
+
+    void add(uint64_t num) { addBytes(&num, sizeof(num)); }
+
+    // 0 is reserved for "no fingerprint"
+    uint64_t get() const { return _hash == 0 ? 1 : _hash; }
+};
+
+static bool addDefSites(Fingerprint& fp, const DefSiteSetT& sites,
+                        RWSubgraph *subg, const RWNodeNaming& naming) {
+    fp.add(static_cast<uint64_t>(sites.size()));
+    for (const DefSite& ds : sites) {
+        auto name = getNodeName(ds.target, naming);
+        if (name.empty())
+            return false;
+        fp.add(name);
+        fp.add(static_cast<uint64_t>(canBeOutput(ds.target, subg)));
+        fp.add(*ds.offset);
+        fp.add(*ds.len);
+    }
+    return true;
+}
+
+static bool addAccesses(Fingerprint& fp, const RWNode *node,
+                        RWSubgraph *subg, const RWNodeNaming& naming) {
+    auto name = getNodeName(node, naming);
+    if (name.empty())
+        return false;
+    fp.add(name);
+    return addDefSites(fp, node->getDefines(), subg, naming) &&
+           addDefSites(fp, node->getOverwrites(), subg, naming) &&
+           addDefSites(fp, node->getUses(), subg, naming);
+}
+
+// fingerprint of the memory accesses of the subgraph itself,
+// the called subgraphs are just gathered into 'callees'
+static uint64_t localFingerprint(RWSubgraph *subg,
+                                 std::vector<RWSubgraph *>& callees,
+                                 const RWNodeNaming& naming) {
+    Fingerprint fp;
+    fp.add(subg->getName());
+    for (auto *b : subg->bblocks()) {
+        fp.add(static_cast<uint64_t>(b->size()));
+        for (auto *node : b->getNodes()) {
+            if (!addAccesses(fp, node, subg, naming))
+                return 0;
+
+            auto *C = RWNodeCall::get(node);
+            if (!C)
+                continue;
+
+            for (auto& callee : C->getCallees()) {
+                if (auto *csubg = callee.getSubgraph()) {
+                    fp.add(csubg->getName());
+                    callees.push_back(csubg);
+                } else if (!addAccesses(fp, callee.getCalledValue(),
+                                        subg, naming)) {
+                    return 0;
+                }
+            }
+        }
+    }
+    return fp.get();
+}
+
+std::unordered_map<const RWSubgraph *, uint64_t>
+MemorySSATransformation::computeModRefFingerprints(const RWNodeNaming& naming) {
+    struct Local {
+        uint64_t fingerprint{0};
+        std::vector<RWSubgraph *> callees;
+    };
+
+    std::unordered_map<const RWSubgraph *, Local> locals;
+    locals.reserve(graph.size());
+    for (auto *subg : graph.subgraphs()) {
+        auto& L = locals[subg];
+        L.fingerprint = localFingerprint(subg, L.callees, naming);
+    }
+
+    // the mod/ref information of a subgraph contains the information
+    // from all (transitively) called subgraphs, so combine their
+    // fingerprints too
+    std::unordered_map<const RWSubgraph *, uint64_t> fingerprints;
+    fingerprints.reserve(graph.size());
+    for (auto *subg : graph.subgraphs()) {
+        Fingerprint fp;
+        std::set<const RWSubgraph *> visited{subg};
+        std::vector<const RWSubgraph *> stack{subg};
+        bool valid = true;
+        while (!stack.empty() && valid) {
+            const auto& L = locals[stack.back()];
+            stack.pop_back();
+            if (L.fingerprint == 0) {
+                valid = false;
+                break;
+            }
+            fp.add(L.fingerprint);
+            for (auto *callee : L.callees) {
+                if (visited.insert(callee).second)
+                    stack.push_back(callee);
+            }
+        }
+        fingerprints[subg] = valid ? fp.get() : 0;
+    }
+
+    return fingerprints;
+}
+
+static bool storeEntries(const DefinitionsMap<RWNode>& M,
+                         std::vector<ModRefSummaries::Entry>& entries,
+                         const RWNodeNaming& naming) {
+    for (const auto& it : M) {
+        auto target = getNodeName(it.first, naming);
+        if (target.empty())
+            return false;
+
+        for (const auto& it2 : it.second) {
+            ModRefSummaries::Entry E;
+            E.target = target;
+            E.start = it2.first.start;
+            E.end = it2.first.end;
+            E.nodes.reserve(it2.second.size());
+            for (auto *nd : it2.second) {
+                E.nodes.push_back(getNodeName(nd, naming));
+                if (E.nodes.back().empty())
+                    return false;
+            }
+            entries.push_back(std::move(E));
+        }
+    }
+    return true;
+}
+
+static bool loadEntries(const std::vector<ModRefSummaries::Entry>& entries,
+                        DefinitionsMap<RWNode>& M, RWNode *unknown,
+                        const RWNodeNaming& naming) {
+    for (const auto& E : entries) {
+        auto *target = getNamedNode(E.target, unknown, naming);
+        if (!target)
+            return false;
+
+        DefinitionsMap<RWNode>::OffsetsT offsets;
+        for (const auto& name : E.nodes) {
+            auto *nd = getNamedNode(name, unknown, naming);
+            if (!nd)
+                return false;
+            offsets.add(E.start, E.end, nd);
+        }
+        M.add(target, offsets);
+    }
+    return true;
+}
+
+unsigned
+MemorySSATransformation::updateModRefSummaries(ModRefSummaries& summaries,
+                                               const RWNodeNaming& naming) {
+    DBG_SECTION_BEGIN(dda, "Updating modref summaries");
+
+    unsigned reused = 0;
+    auto fingerprints = computeModRefFingerprints(naming);
+
+    // first seed the valid summaries, so that they are not
+    // computed again when computing the summaries of callers
+    for (auto *subg : graph.subgraphs()) {
+        auto fp = fingerprints[subg];
+        if (fp == 0)
+            continue;
+
+        auto *S = summaries.get(subg->getName(), fp);
+        if (!S)
+            continue;
+
+        auto& si = getSubgraphInfo(subg);
+        if (si.modref.isInitialized())
+            continue;
+
+        ModRefInfo modref;
+        auto *unknown = graph.getUnknownMemory();
+        if (!loadEntries(S->maydef, modref.maydef, unknown, naming) ||
+            !loadEntries(S->mayref, modref.mayref, unknown, naming) ||
+            !loadEntries(S->mustdef, modref.mustdef, unknown, naming)) {
+            DBG(dda, "Failed mapping the stored modref of " << subg->getName());
+            continue;
+        }
+
+        si.modref = std::move(modref);
+        si.modref.setInitialized();
+        fingerprints[subg] = 0; // do not store it again
+        ++reused;
+    }
+
+    for (auto *subg : graph.subgraphs()) {
+        auto fp = fingerprints[subg];
+        if (fp == 0)
+            continue;
+
+        auto& si = getSubgraphInfo(subg);
+        computeModRef(subg, si);
+        assert(si.modref.isInitialized());
+
+        ModRefSummaries::Summary S;
+        if (storeEntries(si.modref.maydef, S.maydef, naming) &&
+            storeEntries(si.modref.mayref, S.mayref, naming) &&
+            storeEntries(si.modref.mustdef, S.mustdef, naming)) {
+            summaries.set(subg->getName(), fp, std::move(S));
+        }
+    }
+
+    DBG_SECTION_END(dda, "Reused " << reused << " modref summaries");
+    return reused;
+}
+
 } // namespace dda
 } // namespace dg
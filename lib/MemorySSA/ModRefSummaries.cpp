@@ -0,0 +1,106 @@
+#include <istream>
+#include <ostream>
+
+#include "dg/MemorySSA/ModRefSummaries.h"
+
+namespace dg {
+namespace dda {
+
+// The format is line-based:
+//
+//   fun <name> <fingerprint> <#maydef> <#mayref> <#mustdef>
+//   <target> <start> <end> <#nodes> <node> ... <node>
+//   ...
+//
+// where every name is written as <length>:<characters>,
+// so that names may contain any characters.
+
+static void writeName(std::ostream& out, const std::string& name) {
+    out << name.size() << ':' << name;
+}
+
+static bool readName(std::istream& in, std::string& name) {
+    size_t len;
+    char colon;
+    if (!(in >> len) || !in.get(colon) || colon != ':')
+        return false;
+
+    name.resize(len);
+    return len == 0 || in.read(&name[0], len);
+}
+
+static void writeEntries(std::ostream& out,
+                         const std::vector<ModRefSummaries::Entry>& entries) {
+    for (const auto& E : entries) {
+        writeName(out, E.target);
+        out << ' ' << *E.start << ' ' << *E.end << ' ' << E.nodes.size();
+        for (const auto& nd : E.nodes) {
+            out << ' ';
+            writeName(out, nd);
+        }
+        out << '\n';
+    }
+}
+
+static bool readEntries(std::istream& in, size_t num,
+                        std::vector<ModRefSummaries::Entry>& entries) {
+    entries.reserve(num);
+    for (size_t i = 0; i < num; ++i) {
+        ModRefSummaries::Entry E;
+        Offset::type start, end;
+        size_t nodesnum;
+        if (!readName(in, E.target) || !(in >> start >> end >> nodesnum))
+            return false;
+
+        E.start = start;
+        E.end = end;
+        E.nodes.resize(nodesnum);
+        for (auto& nd : E.nodes) {
+            if (!readName(in, nd))
+                return false;
+        }
+        entries.push_back(std::move(E));
+    }
+    return true;
+}
+
+void ModRefSummaries::write(std::ostream& out) const {
+    for (const auto& it : _summaries) {
+        const auto& S = it.second.second;
+        out << "fun ";
+        writeName(out, it.first);
+        out << ' ' << it.second.first << ' ' << S.maydef.size()
+            << ' ' << S.mayref.size() << ' ' << S.mustdef.size() << '\n';
+        writeEntries(out, S.maydef);
+        writeEntries(out, S.mayref);
+        writeEntries(out, S.mustdef);
+    }
+}
+
+bool ModRefSummaries::read(std::istream& in) {
+    std::string kw;
+    while (in >> kw) {
+        if (kw != "fun")
+            return false;
+
+        std::string name;
+        uint64_t fingerprint;
+        size_t maydefs, mayrefs, mustdefs;
+        if (!readName(in, name) ||
+            !(in >> fingerprint >> maydefs >> mayrefs >> mustdefs))
+            return false;
+
+        Summary S;
+        if (!readEntries(in, maydefs, S.maydef) ||
+            !readEntries(in, mayrefs, S.mayref) ||
+            !readEntries(in, mustdefs, S.mustdef))
+            return false;
+
+        set(name, fingerprint, std::move(S));
+    }
+
+    return in.eof();
+}
+
+} // namespace dda
+} // namespace dg
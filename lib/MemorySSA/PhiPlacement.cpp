@@ -0,0 +1,140 @@
+#include <map>
+#include <vector>
+
+#include "dg/MemorySSA/MemorySSA.h"
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace dda {
+
+namespace {
+// memory defined in a subgraph and the blocks that (may) define it
+struct SubgraphDefinitions {
+    DefinitionsMap<RWNode> defined;
+    std::map<RWNode *, std::vector<RWBBlock *>> blocks;
+    std::vector<RWBBlock *> unknownWriteBlocks;
+
+    template <typename C>
+    void add(const C& c, RWBBlock *block, RWNode *node) {
+        for (const DefSite& ds : c) {
+            if (ds.target->isUnknown()) {
+                unknownWriteBlocks.push_back(block);
+            } else {
+                defined.add(ds, node);
+                blocks[ds.target].push_back(block);
+            }
+        }
+    }
+};
+} // anonymous namespace
+
+void MemorySSATransformation::placePhis(RWSubgraph *subg, SubgraphInfo& si) {
+    if (si.phisPlaced) {
+        return;
+    }
+
+    // set it here, finding the operands of phis may get us
+    // back to this subgraph
+    si.phisPlaced = true;
+
+    if (subg->size() == 0) {
+        return;
+    }
+
+    DBG_SECTION_BEGIN(dda, "Placing phi nodes in subgraph " << subg->getName());
+
+    si.dominators.compute(*subg->bblocks().begin());
+
+    // gather the memory defined in the subgraph. Call blocks
+    // define what the called procedures may define.
+    SubgraphDefinitions SD;
+    for (auto *b : subg->bblocks()) {
+        auto& bi = si.getBBlockInfo(b);
+        if (bi.isCallBlock()) {
+            auto *C = bi.getCall();
+            for (auto& callee : C->getCallees()) {
+                auto *csubg = callee.getSubgraph();
+                if (!csubg) {
+                    auto *cv = callee.getCalledValue();
+                    SD.add(cv->getDefines(), b, C);
+                    SD.add(cv->getOverwrites(), b, C);
+                    continue;
+                }
+
+                auto& callsi = getSubgraphInfo(csubg);
+                computeModRef(csubg, callsi);
+                assert(callsi.modref.isInitialized());
+                for (auto& it : callsi.modref.maydef) {
+                    if (it.first->isUnknown()) {
+                        SD.unknownWriteBlocks.push_back(b);
+                    } else {
+                        SD.defined.add(it.first, it.second);
+                        SD.blocks[it.first].push_back(b);
+                    }
+                }
+            }
+        } else {
+            for (auto *node : b->getNodes()) {
+                SD.add(node->getDefines(), b, node);
+                SD.add(node->getOverwrites(), b, node);
+            }
+        }
+    }
+
+    si.hasUnknownWrites = !SD.unknownWriteBlocks.empty();
+
+    // place phi nodes for each memory into the iterated dominance
+    // frontiers of the blocks that define it. We split the defined
+    // bytes into disjunctive intervals, so that every phi node
+    // merges only definitions that define all of its bytes.
+    std::vector<RWNode *> phis;
+    for (auto& it : SD.defined) {
+        auto *target = it.first;
+        auto& blocks = SD.blocks[target];
+        si.phiTargets.insert(target);
+
+        if (si.hasUnknownWrites) {
+            // writes to unknown memory may define any byte
+            blocks.insert(blocks.end(), SD.unknownWriteBlocks.begin(),
+                                        SD.unknownWriteBlocks.end());
+        }
+
+        auto frontiers = si.dominators.getIteratedFrontiers(blocks);
+        if (frontiers.empty()) {
+            continue;
+        }
+
+        auto intervals = it.second;
+        if (si.hasUnknownWrites) {
+            intervals.add(0, Offset::UNKNOWN, nullptr);
+        }
+
+        for (auto& intervalit : intervals) {
+            auto& interval = intervalit.first;
+            DefSite ds{target, interval.start, interval.length()};
+            for (auto *block : frontiers) {
+                // the search from the entry block continues
+                // into callers, that is handled on demand
+                if (!si.dominators.getIDom(block))
+                    continue;
+
+                auto *phi = createPhi(ds);
+                block->prepend(phi);
+                si.getBBlockInfo(block).getEntryPhis().add(ds, phi);
+                phis.push_back(phi);
+            }
+        }
+    }
+
+    DBG(dda, "Placed " << phis.size() << " phi nodes");
+
+    // now, when all phi nodes are in place, find their operands
+    for (auto *phi : phis) {
+        findPhiDefinitions(phi, phi->getBBlock()->predecessors());
+    }
+
+    DBG_SECTION_END(dda, "Placing phi nodes in subgraph " << subg->getName() << " done");
+}
+
+} // namespace dda
+} // namespace dg
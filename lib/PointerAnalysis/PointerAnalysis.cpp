@@ -8,18 +8,18 @@
 namespace dg {
 namespace pta {
 
-// nodes representing NULL, unknown memory
-// and invalidated memory
-PSNode NULLPTR_LOC(PSNodeType::NULL_ADDR);
+// the deprecated process-wide nodes representing NULL, unknown memory
+// and invalidated memory (every PointerGraph has its own now)
+static PSNode NULLPTR_LOC(PSNodeType::NULL_ADDR);
 PSNode *NULLPTR = &NULLPTR_LOC;
-PSNode UNKNOWN_MEMLOC(PSNodeType::UNKNOWN_MEM);
+static PSNode UNKNOWN_MEMLOC(PSNodeType::UNKNOWN_MEM);
 PSNode *UNKNOWN_MEMORY = &UNKNOWN_MEMLOC;
-PSNode INVALIDATED_LOC(PSNodeType::INVALIDATED);
+static PSNode INVALIDATED_LOC(PSNodeType::INVALIDATED);
 PSNode *INVALIDATED = &INVALIDATED_LOC;
 
 // pointers to those memory
-const Pointer UnknownPointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
-const Pointer NullPointer(NULLPTR, 0);
+const Pointer UnknownPointer(&UNKNOWN_MEMLOC, Offset::UNKNOWN);
+const Pointer NullPointer(&NULLPTR_LOC, 0);
 
 // Return true if it makes sense to dereference this pointer.
 // PTA is over-approximation, so this is a filter.
@@ -46,7 +46,7 @@ bool PointerAnalysis::processLoad(PSNode *node)
     for (const Pointer& ptr : operand->pointsTo) {
         if (ptr.isUnknown()) {
             // load from unknown pointer yields unknown pointer
-            changed |= node->addPointsTo(UnknownPointer);
+            changed |= node->addPointsTo(PG->getUnknownPointer());
             continue;
         }
 
@@ -67,7 +67,7 @@ bool PointerAnalysis::processLoad(PSNode *node)
             if (target->isZeroInitialized())
                 // if the memory is zero initialized, then everything
                 // is fine, we add nullptr
-                changed |= node->addPointsTo(NullPointer);
+                changed |= node->addPointsTo(PG->getNullPointer());
             else
                 changed |= errorEmptyPointsTo(node, target);
 
@@ -84,7 +84,7 @@ bool PointerAnalysis::processLoad(PSNode *node)
                 // FIXME: don't duplicate the code
                 if (o->pointsTo.empty()) {
                     if (target->isZeroInitialized())
-                        changed |= node->addPointsTo(NullPointer);
+                        changed |= node->addPointsTo(PG->getNullPointer());
                     else if (objects.size() == 1)
                         changed |= errorEmptyPointsTo(node, target);
                 }
@@ -106,7 +106,7 @@ bool PointerAnalysis::processLoad(PSNode *node)
                 // if the memory is zero initialized, then everything
                 // is fine, we add nullptr
                 if (target->isZeroInitialized())
-                    changed |= node->addPointsTo(NullPointer);
+                    changed |= node->addPointsTo(PG->getNullPointer());
                 // if we don't have a definition even with unknown offset
                 // it is an error
                 // FIXME: don't triplicate the code!
@@ -217,7 +217,7 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *>& srcObjects,
 
     for (MemoryObject *destO : destObjects) {
         if (contains_null_somewhere)
-            changed |= destO->addPointsTo(Offset::UNKNOWN, NullPointer);
+            changed |= destO->addPointsTo(Offset::UNKNOWN, PG->getNullPointer());
 
         // copy every pointer from srcObjects that is in
         // the range to destination's objects
@@ -348,7 +348,7 @@ bool PointerAnalysis::processNode(PSNode *node)
                         PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
                         assert(target && "Target is not memory allocation");
                         if (!target->isHeap() && !target->isGlobal()) {
-                            changed |= node->addPointsTo(INVALIDATED, 0);
+                            changed |= node->addPointsTo(PG->getInvalidated(), 0);
                         }
                     }
                 }
@@ -441,15 +441,17 @@ bool PointerAnalysis::processNode(PSNode *node)
 
 void PointerAnalysis::sanityCheck() {
 #ifndef NDEBUG
-    assert(NULLPTR->pointsTo.size() == 1
+    auto *nullptrNode = PG->getNull();
+    auto *unknownNode = PG->getUnknownMemory();
+    assert(nullptrNode->pointsTo.size() == 1
            && "Null has been assigned a pointer");
-    assert(NULLPTR->doesPointsTo(NULLPTR)
+    assert(nullptrNode->doesPointsTo(nullptrNode)
            && "Null points to a different location");
-    assert(UNKNOWN_MEMORY->pointsTo.size() == 1
+    assert(unknownNode->pointsTo.size() == 1
            && "Unknown memory has been assigned a pointer");
-    assert(UNKNOWN_MEMORY->doesPointsTo(UNKNOWN_MEMORY, Offset::UNKNOWN)
+    assert(unknownNode->doesPointsTo(unknownNode, Offset::UNKNOWN)
            && "Unknown memory has been assigned a pointer");
-    assert(INVALIDATED->pointsTo.empty()
+    assert(PG->getInvalidated()->pointsTo.empty()
            && "Unknown memory has been assigned a pointer");
 
     auto nodes = PG->getNodes(PG->getEntry()->getRoot());
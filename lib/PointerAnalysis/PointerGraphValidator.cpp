@@ -111,7 +111,8 @@ bool PointerGraphValidator::checkOperands() {
 
         PSNode *nd = ndptr.get();
         for (const PSNode *op : nd->getOperands()) {
-            if (op != NULLPTR && op != UNKNOWN_MEMORY && op != INVALIDATED &&
+            if (op != PS->getNull() && op != PS->getUnknownMemory() &&
+                op != PS->getInvalidated() &&
                 known_nodes.count(op) == 0) {
                 invalid |= reportInvalOperands(nd, "Node has unknown (maybe dangling) operand");
             }
@@ -8,15 +8,15 @@
 
 namespace dg {
 namespace pta {
-    std::vector<PSNode*> SeparateOffsetsPointsToSet::idVector;
-    std::vector<Pointer> PointerIdPointsToSet::idVector;
-    std::vector<PSNode*> SmallOffsetsPointsToSet::idVector;
-    std::vector<PSNode*> AlignedSmallOffsetsPointsToSet::idVector;
-    std::vector<Pointer> AlignedPointerIdPointsToSet::idVector;
-    std::map<PSNode*,size_t> SeparateOffsetsPointsToSet::ids;
-    std::map<Pointer,size_t> PointerIdPointsToSet::ids;
-    std::map<PSNode*,size_t> SmallOffsetsPointsToSet::ids;
-    std::map<PSNode*,size_t> AlignedSmallOffsetsPointsToSet::ids;
-    std::map<Pointer,size_t> AlignedPointerIdPointsToSet::ids;
+    thread_local std::vector<PSNode*> SeparateOffsetsPointsToSet::idVector;
+    thread_local std::vector<Pointer> PointerIdPointsToSet::idVector;
+    thread_local std::vector<PSNode*> SmallOffsetsPointsToSet::idVector;
+    thread_local std::vector<PSNode*> AlignedSmallOffsetsPointsToSet::idVector;
+    thread_local std::vector<Pointer> AlignedPointerIdPointsToSet::idVector;
+    thread_local std::map<PSNode*,size_t> SeparateOffsetsPointsToSet::ids;
+    thread_local std::map<Pointer,size_t> PointerIdPointsToSet::ids;
+    thread_local std::map<PSNode*,size_t> SmallOffsetsPointsToSet::ids;
+    thread_local std::map<PSNode*,size_t> AlignedSmallOffsetsPointsToSet::ids;
+    thread_local std::map<Pointer,size_t> AlignedPointerIdPointsToSet::ids;
 } // namespace pta
 } // namespace debug
@@ -7,9 +7,6 @@
 namespace dg {
 namespace dda {
 
-RWNode UNKNOWN_MEMLOC;
-RWNode *UNKNOWN_MEMORY = &UNKNOWN_MEMLOC;
-
 #ifndef NDEBUG
 void RWNode::dump() const {
        std::cout << getID() << "\n";
@@ -78,6 +75,9 @@ void RWSubgraph::buildBBlocks(bool /*dce*/) {
 
     BBlocksBuilder<RWBBlock> builder;
     _bblocks = std::move(builder.buildAndGetBlocks(getRoot()));
+    for (unsigned i = 0; i < _bblocks.size(); ++i) {
+        _bblocks[i]->setIndex(i);
+    }
 
     assert(getRoot()->getBBlock() && "Root node has no BBlock");
 
@@ -146,7 +146,7 @@ void RWSubgraph::splitBBlocksOnCalls() {
     }
 
     for (auto& bblock : newblocks) {
-        _bblocks.push_back(std::move(bblock));
+        _addBBlock(std::move(bblock));
     }
 
     assert(entry == _bblocks[0].get()
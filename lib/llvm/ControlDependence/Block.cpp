@@ -2,6 +2,7 @@
 #include "Function.h"
 
 #include <sstream>
+#include <utility>
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -25,7 +26,7 @@
 namespace dg {
 namespace llvmdg {
 
-int Block::traversalCounter = 0;
+std::atomic<int> Block::traversalCounter{0};
 
 const std::set<Block *> &Block::predecessors() const{
     return predecessors_;
@@ -177,13 +178,28 @@ std::string Block::label() const {
 }
 
 void Block::visit() {
+    // DFS with an explicit stack, a block gets a new traversal ID
+    // when we enter it and again when we leave it
+    std::vector<std::pair<Block *, std::set<Block *>::const_iterator>> stack;
     this->traversalId();
-    for (auto successor : successors_) {
+    stack.emplace_back(this, successors_.begin());
+
+    while (!stack.empty()) {
+        Block *block = stack.back().first;
+        auto& iterator = stack.back().second;
+        if (iterator == block->successors_.end()) {
+            block->traversalId();
+            stack.pop_back();
+            continue;
+        }
+
+        Block *successor = *iterator;
+        ++iterator;
         if (successor->bfsId() == 0) {
-            successor->visit();
+            successor->traversalId();
+            stack.emplace_back(successor, successor->successors_.begin());
         }
     }
-    this->traversalId();
 }
 
 void Block::dumpNode(std::ostream &ostream) const {
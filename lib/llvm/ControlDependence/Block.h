@@ -1,6 +1,7 @@
 #ifndef DG_LLVM_BLOCK_H
 #define DG_LLVM_BLOCK_H
 
+#include <atomic>
 #include <vector>
 #include <set>
 #include <map>
@@ -58,6 +59,10 @@ public:
     bool isCallReturn() const;
     bool isExit() const;
 
+    // the index of the block in its function (dense, assigned by Function)
+    unsigned id() const { return id_; }
+    void setId(unsigned id) { id_ = id; }
+
     void traversalId() { traversalId_ = ++traversalCounter; }
     int bfsId() const { return traversalId_; }
 
@@ -74,7 +79,7 @@ public:
 
 
 private:
-    static int traversalCounter;
+    static std::atomic<int> traversalCounter;
 
     std::vector<const llvm::Instruction *> llvmInstructions_;
 
@@ -83,6 +88,7 @@ private:
 
     bool callReturn = false;
     int traversalId_       = 0;
+    unsigned id_           = 0;
 
     std::map<const llvm::Function *, Function *> callees_;
     std::map<const llvm::Function *, Function *> forks_;
@@ -7,6 +7,7 @@ namespace dg {
 namespace llvmdg {
 
 Function::Function(): lastBlock(new Block(nullptr)) {
+    lastBlock->setId(0);
     blocks.insert(lastBlock);
 }
 
@@ -31,7 +32,11 @@ bool Function::addBlock(Block *block) {
     if (!firstBlock) {
         firstBlock = block;
     }
-    return blocks.insert(block).second;
+    if (!blocks.insert(block).second) {
+        return false;
+    }
+    block->setId(blocks.size() - 1);
+    return true;
 }
 
 std::set<Block *> Function::nodes() const {
@@ -21,6 +21,7 @@ public:
     bool addBlock(Block *block);
 
     std::set<Block *> nodes() const;
+    std::size_t size() const { return blocks.size(); }
     std::set<Block *> condNodes() const;
     std::set<Block *> callReturnNodes() const;
 
@@ -114,7 +114,7 @@ Function *GraphBuilder::buildFunction(const llvm::Function *llvmFunction,
         }
     }
 
-    TarjanAnalysis<Block> tarjan(function->nodes().size());
+    TarjanAnalysis<Block> tarjan(function->size());
     tarjan.compute(function->entry());
     tarjan.computeCondensation();
     const auto & componentss = tarjan.components();
@@ -6,6 +6,7 @@
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #endif
 
+#include <llvm/Config/llvm-config.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
@@ -17,10 +18,15 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <algorithm>
+#include <utility>
+
 #include "dg/util/debug.h"
 #include "llvm/ControlDependence/InterproceduralCD.h"
 #include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
 #include "dg/ADT/Queue.h"
+#include "dg/CallGraph/CallGraph.h"
+#include "dg/SCC.h"
 
 using namespace std;
 
@@ -43,63 +49,125 @@ static inline bool hasNoSuccessors(const llvm::BasicBlock *bb) {
     return succ_begin(bb) == succ_end(bb);
 }
 
-void
-LLVMInterprocCD::computeFuncInfo(const llvm::Function *fun,
-                                 std::set<const llvm::Function *> stack) {
+void LLVMInterprocCD::computeFuncInfo(const llvm::Function *fun) {
     using namespace llvm;
+    using Clock = std::chrono::steady_clock;
 
     if (fun->isDeclaration() || hasFuncInfo(fun))
         return;
 
     DBG_SECTION_BEGIN(cda, "Computing no-return points for function " << fun->getName().str());
 
-    auto& info = _funcInfos[fun];
-    assert(hasFuncInfo(fun) && "Bug in hasFuncInfo");
+    // the functions without func info that are reachable from 'fun'
+    // together with the calls of defined functions that they contain
+    struct PendingFunc {
+        FuncInfo info;
+        std::vector<std::pair<const CallInst *,
+                              std::vector<const Function *>>> calls;
+    };
+
+    GenericCallGraph<const Function *> CG;
+    std::unordered_map<const Function *, PendingFunc> pending;
+    ADT::QueueLIFO<const Function *> queue;
 
-    stack.insert(fun);
+    CG.createNode(fun);
+    pending[fun];
+    queue.push(fun);
 
     //  compute nonreturning blocks (without successors
     //  and terminated with non-ret instruction
-    //  and find calls (and other noret points) inside blocks
-    for (auto& B : *fun) {
-        // no successors and does not return to caller
-        // -- this is a point of no return :)
-        if (hasNoSuccessors(&B) &&
-            !isa<ReturnInst>(B.getTerminator())) {
-            info.noret.insert(B.getTerminator());
-        }
-
-        // process the calls in basic blocks
-        for (auto& I : B) {
-            auto *C = dyn_cast<CallInst>(&I);
-            if (!C) {
-                continue;
+    //  and find calls inside blocks
+    while (!queue.empty()) {
+        auto *F = queue.pop();
+        auto start = Clock::now();
+        auto& pf = pending[F];
+
+        for (auto& B : *F) {
+            // no successors and does not return to caller
+            // -- this is a point of no return :)
+            if (hasNoSuccessors(&B) &&
+                !isa<ReturnInst>(B.getTerminator())) {
+                pf.info.noret.insert(B.getTerminator());
             }
 
-            for (auto *calledFun : getCalledFunctions(C->getCalledValue())) {
-                if (calledFun->isDeclaration())
+            for (auto& I : B) {
+                auto *C = dyn_cast<CallInst>(&I);
+                if (!C) {
                     continue;
+                }
+
+                std::vector<const Function *> called;
+                for (auto *calledFun : getCalledFunctions(C->getCalledValue())) {
+                    if (calledFun->isDeclaration())
+                        continue;
 
-                if (stack.count(calledFun) > 0) {
-                    // recursive call
-                    info.noret.insert(C);
-                } else {
-                    computeFuncInfo(calledFun, stack);
-                    auto *fi = getFuncInfo(calledFun);
-                    assert(fi && "Did not compute func info");
-                    if (!fi->noret.empty()) {
-                        info.noret.insert(C);
+                    called.push_back(calledFun);
+                    // the functions with func info are already summarized
+                    if (hasFuncInfo(calledFun))
+                        continue;
+
+                    CG.addCall(F, calledFun);
+                    if (pending.find(calledFun) == pending.end()) {
+                        pending[calledFun];
+                        queue.push(calledFun);
                     }
                 }
+
+                if (!called.empty())
+                    pf.calls.emplace_back(C, std::move(called));
             }
         }
+
+        // 'pending' may have been rehashed, but the references stay valid
+        pf.info.time += Clock::now() - start;
     }
 
-    llvm::errs() << "Noret points of " << fun->getName() << "\n";
-    for (auto *nr : info.noret) {
-        llvm::errs() << "  -> " << *nr << "\n";
+    // the components come in reverse topological order,
+    // so every function is summarized after the functions that it calls
+    // (in other components). A call inside a component is a (possibly
+    // infinite) recursion and therefore a point of no return, so the
+    // summaries of one component do not depend on each other and we
+    // get the fixpoint in one pass.
+    SCC<GenericCallGraph<const Function *>::FuncNode> SCCs;
+    for (auto& component : SCCs.compute(CG.get(fun))) {
+        for (auto *node : component) {
+            auto *F = node->getValue();
+            auto start = Clock::now();
+            auto& pf = pending[F];
+
+            for (auto& call : pf.calls) {
+                for (auto *calledFun : call.second) {
+                    auto *calledNode = CG.get(calledFun);
+                    bool noret;
+                    if (calledNode &&
+                        calledNode->getSCCId() == node->getSCCId()) {
+                        // recursive call
+                        noret = true;
+                    } else {
+                        auto *fi = getFuncInfo(calledFun);
+                        assert(fi && "Did not compute func info");
+                        noret = !fi->noret.empty();
+                    }
+
+                    if (noret) {
+                        pf.info.noret.insert(call.first);
+                        break;
+                    }
+                }
+            }
+
+            pf.info.time += Clock::now() - start;
+            auto& info = _funcInfos[F];
+            info = std::move(pf.info);
+
+            DBG(cda, "Function " << F->getName().str() << " has "
+                     << info.noret.size() << " no-return points, computed in "
+                     << std::chrono::duration_cast<std::chrono::microseconds>(info.time).count()
+                     << " us");
+        }
     }
 
+    assert(hasFuncInfo(fun) && "Did not compute func info");
     DBG_SECTION_END(cda, "Done computing no-return points for function " << fun->getName().str());
 }
 
@@ -182,30 +250,230 @@ void LLVMInterprocCD::computeCD(const llvm::Function *fun) {
         }
     }
 
-    // (3) compute control dependencies
-    for (auto& it : cds) {
-        _blockCD[it.first] = std::move(it.second);
+    // (3) store the control dependencies
+    for (auto& B : *fun) {
+        auto cit = cds.find(&B);
+        auto bit = blkInfos.find(&B);
+        bool hasCD = cit != cds.end() && !cit->second.empty();
+        if (!hasCD && bit == blkInfos.end())
+            continue;
+
+        _blockIndex[&B] = _noretOffsets.size();
+        if (hasCD) {
+            _cdValues.insert(_cdValues.end(),
+                             cit->second.begin(), cit->second.end());
+        }
+        _noretOffsets.push_back(_cdValues.size());
+        if (bit != blkInfos.end()) {
+            auto& norets = bit->second.noret;
+            _cdValues.insert(_cdValues.end(), norets.begin(), norets.end());
+        }
+        _cdOffsets.push_back(_cdValues.size());
     }
-    for (auto& it : blkInfos) {
-        unsigned noretsidx = 0;
-        auto& norets = it.second.noret;
 
-        for (auto& I : *it.first) {
-            for (unsigned i = 0; i < noretsidx; ++i) {
-                _instrCD[&I].insert(norets[i]);
+    auto *fi = getFuncInfo(fun);
+    assert(fi && "Whata?!");
+    fi->hasCD = true;
+
+    DBG_SECTION_END(cda, "Done computing interprocedural CD for function " << fun->getName().str());
+}
+
+void LLVMInterprocCD::forget() {
+    _funcInfos.clear();
+    _blockIndex.clear();
+    _cdOffsets.assign(1, 0);
+    _noretOffsets.clear();
+    _cdValues.clear();
+}
+
+void LLVMInterprocCD::compact() {
+    // keep the order of the blocks, so that the values
+    // are not moved around more than necessary
+    std::vector<std::pair<unsigned, const llvm::BasicBlock *>> blocks;
+    blocks.reserve(_blockIndex.size());
+    for (auto& it : _blockIndex)
+        blocks.emplace_back(it.second, it.first);
+    std::sort(blocks.begin(), blocks.end());
+
+    std::vector<unsigned> cdOffsets{0};
+    std::vector<unsigned> noretOffsets;
+    std::vector<llvm::Value *> cdValues;
+    cdOffsets.reserve(blocks.size() + 1);
+    noretOffsets.reserve(blocks.size());
+    for (auto& it : blocks) {
+        unsigned idx = it.first;
+        _blockIndex[it.second] = noretOffsets.size();
+        cdValues.insert(cdValues.end(),
+                        _cdValues.begin() + _cdOffsets[idx],
+                        _cdValues.begin() + _noretOffsets[idx]);
+        noretOffsets.push_back(cdValues.size());
+        cdValues.insert(cdValues.end(),
+                        _cdValues.begin() + _noretOffsets[idx],
+                        _cdValues.begin() + _cdOffsets[idx + 1]);
+        cdOffsets.push_back(cdValues.size());
+    }
+
+    _cdOffsets.swap(cdOffsets);
+    _noretOffsets.swap(noretOffsets);
+    _cdValues.swap(cdValues);
+}
+
+void LLVMInterprocCD::updateChanged() {
+    using namespace llvm;
+
+    DBG_SECTION_BEGIN(cda, "Updating interprocedural CD of changed functions");
+    bool summariesChanged = false;
+    for (auto& it : _changed) {
+        auto *F = it.first;
+        auto *fi = getFuncInfo(F);
+        assert(fi && "Do not have func info for a changed function");
+
+        for (auto& B : *F)
+            _blockIndex.erase(&B);
+        fi->hasCD = false;
+
+        // the summaries of the called functions did not change
+        // (the calls in a recursion have non-empty summaries)
+        std::set<const Value *> noret;
+        for (auto& B : *F) {
+            if (hasNoSuccessors(&B) &&
+                !isa<ReturnInst>(B.getTerminator())) {
+                noret.insert(B.getTerminator());
             }
-            if (noretsidx < norets.size() &&
-                &I == norets[noretsidx]) {
-                ++noretsidx;
+
+            for (auto& I : B) {
+                auto *C = dyn_cast<CallInst>(&I);
+                if (!C) {
+                    continue;
+                }
+
+                for (auto *calledFun : getCalledFunctions(C->getCalledValue())) {
+                    if (calledFun->isDeclaration())
+                        continue;
+                    computeFuncInfo(calledFun);
+                    if (!getFuncInfo(calledFun)->noret.empty()) {
+                        noret.insert(C);
+                        break;
+                    }
+                }
             }
         }
+
+        // 'fi' may have been invalidated by computeFuncInfo
+        fi = getFuncInfo(F);
+        summariesChanged |= it.second != !noret.empty();
+        fi->noret = std::move(noret);
+    }
+    _changed.clear();
+
+    if (summariesChanged) {
+        DBG(cda, "The summaries changed, computing everything again");
+        forget();
+    } else {
+        // the dependencies of the changed functions are computed
+        // again, do not keep their old ones
+        compact();
+    }
+    DBG_SECTION_END(cda, "Done updating interprocedural CD of changed functions");
+}
+
+void LLVMInterprocCD::setChanged(const llvm::Function *F) {
+    if (auto *fi = getFuncInfo(F))
+        _changed.emplace(F, !fi->noret.empty());
+}
+
+void LLVMInterprocCD::insertEdge(const llvm::BasicBlock *from,
+                                 const llvm::BasicBlock *) {
+    setChanged(from->getParent());
+}
+
+void LLVMInterprocCD::deleteEdge(const llvm::BasicBlock *from,
+                                 const llvm::BasicBlock *) {
+    setChanged(from->getParent());
+}
+
+void LLVMInterprocCD::deleteBlock(const llvm::BasicBlock *B) {
+    _blockIndex.erase(B);
+    setChanged(B->getParent());
+
+    // do not keep the pointers to the erased instructions
+    if (auto *fi = getFuncInfo(B->getParent())) {
+        for (auto& I : *B)
+            fi->noret.erase(&I);
     }
+}
+
+void LLVMInterprocCD::computeOnDemand(const llvm::Function *fun) {
+    if (!_changed.empty())
+        updateChanged();
 
     auto *fi = getFuncInfo(fun);
-    assert(fi && "Whata?!");
-    fi->hasCD = true;
+    if (!fi) {
+        computeFuncInfo(fun);
+        fi = getFuncInfo(fun);
+    }
 
-    DBG_SECTION_END(cda, "Done computing interprocedural CD for function " << fun->getName().str());
+    assert(fi && "BUG in computeFuncInfo");
+    if (!fi->hasCD) {
+        computeCD(fun);
+        assert(fi->hasCD && "BUG in computeCD");
+    }
+}
+
+// does A precede B in their basic block?
+static bool precedes(const llvm::Instruction *A, const llvm::Instruction *B) {
+    assert(A->getParent() == B->getParent());
+#if LLVM_VERSION_MAJOR >= 11
+    return A->comesBefore(B);
+#else
+    for (auto *I = A->getNextNode(); I; I = I->getNextNode()) {
+        if (I == B)
+            return true;
+    }
+    return false;
+#endif
+}
+
+llvm::ArrayRef<llvm::Value *>
+LLVMInterprocCD::getBlockDependencies(const llvm::BasicBlock *B) {
+    computeOnDemand(B->getParent());
+
+    auto it = _blockIndex.find(B);
+    if (it == _blockIndex.end())
+        return {};
+
+    return {_cdValues.data() + _cdOffsets[it->second],
+            _cdValues.data() + _noretOffsets[it->second]};
+}
+
+llvm::ArrayRef<llvm::Value *>
+LLVMInterprocCD::getInstructionDependencies(const llvm::Instruction *I) {
+    computeOnDemand(I->getParent()->getParent());
+
+    auto it = _blockIndex.find(I->getParent());
+    if (it == _blockIndex.end())
+        return {};
+
+    llvm::ArrayRef<llvm::Value *> norets(_cdValues.data() + _noretOffsets[it->second],
+                                         _cdValues.data() + _cdOffsets[it->second + 1]);
+    size_t num = 0;
+    while (num < norets.size() &&
+           precedes(llvm::cast<llvm::Instruction>(norets[num]), I)) {
+        ++num;
+    }
+    return norets.slice(0, num);
+}
+
+LLVMInterprocCD::ValVec
+LLVMInterprocCD::getDependencies(const llvm::Instruction *I) {
+    auto instrDeps = getInstructionDependencies(I);
+    auto blockDeps = getBlockDependencies(I->getParent());
+
+    ValVec ret;
+    ret.reserve(instrDeps.size() + blockDeps.size());
+    ret.insert(ret.end(), instrDeps.begin(), instrDeps.end());
+    ret.insert(ret.end(), blockDeps.begin(), blockDeps.end());
+    return ret;
 }
 
 } // namespace llvmdg
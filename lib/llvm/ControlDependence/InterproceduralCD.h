@@ -3,13 +3,34 @@
 
 #include "dg/llvm/ControlDependence/LLVMControlDependenceAnalysisImpl.h"
 
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/ADT/ArrayRef.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include <chrono>
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 
 namespace llvm {
 class Function;
+class BasicBlock;
+class Instruction;
 }
 
 namespace dg {
@@ -29,11 +50,25 @@ class LLVMInterprocCD : public LLVMControlDependenceAnalysisImpl {
         // to its caller
         std::set<const llvm::Value *> noret;
         bool hasCD = false;
+        // time spent in computing the no-return points of the function
+        std::chrono::steady_clock::duration time{0};
     };
 
-    std::unordered_map<const llvm::Instruction *, std::set<llvm::Value *>> _instrCD;
-    std::unordered_map<const llvm::BasicBlock *, std::set<llvm::Value *>> _blockCD;
+    // Control dependencies of blocks in the CSR format. The block with
+    // index i depends on the values _cdValues[_cdOffsets[i] .. _noretOffsets[i])
+    // and contains the no-return points _cdValues[_noretOffsets[i] .. _cdOffsets[i + 1]).
+    // Instructions in a block depend on the no-return points of the block
+    // that precede them, so the first instruction with interprocedural CD
+    // is the one after the first no-return point. Only the blocks that
+    // have some dependencies or no-return points are indexed.
+    std::unordered_map<const llvm::BasicBlock *, unsigned> _blockIndex;
+    std::vector<unsigned> _cdOffsets{0};
+    std::vector<unsigned> _noretOffsets;
+    std::vector<llvm::Value *> _cdValues;
     std::unordered_map<const llvm::Function *, FuncInfo> _funcInfos;
+    // the functions whose CFG changed after we computed their info,
+    // mapped to whether they had some no-return points before the change
+    std::map<const llvm::Function *, bool> _changed;
 
     FuncInfo *getFuncInfo(const llvm::Function *F) {
         auto it = _funcInfos.find(F);
@@ -50,10 +85,19 @@ class LLVMInterprocCD : public LLVMControlDependenceAnalysisImpl {
        return _funcInfos.find(fun) != _funcInfos.end();
     }
 
-    // recursively compute function info, 'stack' is there to detect recursive calls
-    void computeFuncInfo(const llvm::Function *fun,
-                         std::set<const llvm::Function *> stack = {});
+    // compute function info for 'fun' and all the (transitively) called
+    // functions that do not have it yet. The functions are processed
+    // bottom-up in the strongly connected components of the call graph.
+    void computeFuncInfo(const llvm::Function *fun);
     void computeCD(const llvm::Function *fun);
+    // compute func info and CD of the function if we do not have them yet
+    void computeOnDemand(const llvm::Function *fun);
+    // compute again the info and CD of the functions whose CFG changed
+    void updateChanged();
+    // drop the dependencies of the blocks that are not indexed anymore
+    void compact();
+    void setChanged(const llvm::Function *F);
+    void forget();
 
     std::vector<const llvm::Function *> getCalledFunctions(const llvm::Value *v);
 
@@ -75,41 +119,38 @@ public:
     }
 
     /// Getters of dependencies for a value
-    ValVec getDependencies(const llvm::Instruction *I) override {
-        auto *fun = I->getParent()->getParent();
-        auto *fi = getFuncInfo(fun);
-        if (!fi) {
-            computeFuncInfo(fun);
-        }
-
-        fi = getFuncInfo(fun);
-        assert(fi && "BUG in computeFuncInfo");
-        if (!fi->hasCD) {
-            computeCD(fun);
-            assert(fi->hasCD && "BUG in computeCD");
-        }
+    ValVec getDependencies(const llvm::Instruction *I) override;
 
-        ValVec ret;
-        auto instrIt = _instrCD.find(I);
-        if (instrIt != _instrCD.end()) {
-            ret.insert(ret.end(), instrIt->second.begin(), instrIt->second.end());
-        }
-
-        auto blkIt = _blockCD.find(I->getParent());
-        if (blkIt != _blockCD.end()) {
-            ret.insert(ret.end(), blkIt->second.begin(), blkIt->second.end());
-        }
+    ValVec getDependent(const llvm::Instruction *) override { return {}; }
 
-        return ret;
+    /// Getters that do not copy the dependencies. The returned arrays are
+    /// valid until dependencies of another function are computed.
+    // the no-return points that the whole block depends on
+    llvm::ArrayRef<llvm::Value *> getBlockDependencies(const llvm::BasicBlock *B);
+    // the no-return points in the block of the instruction that precede it
+    // (the instruction depends also on the dependencies of its block)
+    llvm::ArrayRef<llvm::Value *> getInstructionDependencies(const llvm::Instruction *I);
+
+    // time spent in computing the no-return points of the function
+    // (zero if they have not been computed yet)
+    std::chrono::steady_clock::duration getFuncInfoTime(const llvm::Function *F) const {
+        auto *fi = getFuncInfo(F);
+        return fi ? fi->time : std::chrono::steady_clock::duration{0};
     }
 
-    ValVec getDependent(const llvm::Instruction *) override { return {}; }
-
     /// Getters of dependencies for a basic block
     ValVec getDependencies(const llvm::BasicBlock *b) override { return {}; }
     ValVec getDependent(const llvm::BasicBlock *) override { return {}; }
 
     void run() override { /* we run on demand */ }
+
+    // The dependencies of the changed functions are computed again
+    // on the next query. If the change adds or removes all no-return
+    // points of a function, the summaries of its callers may change too,
+    // so then we compute everything again.
+    void insertEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *) override;
+    void deleteEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *) override;
+    void deleteBlock(const llvm::BasicBlock *B) override;
 };
 
 } // namespace llvmdg
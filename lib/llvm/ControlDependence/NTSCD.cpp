@@ -26,9 +26,11 @@ namespace llvm {
 #include <functional>
 #include <queue>
 #include <unordered_set>
+#include <vector>
 #include <ostream>
 
 #include "dg/util/debug.h"
+#include "dg/util/parallel.h"
 
 using namespace std;
 
@@ -47,6 +49,12 @@ void NTSCD::addControlDependence(Block *a, Block *b) {
     revControlDependency[a].insert(b);
 }
 
+void NTSCD::addControlDependencies(const Dependencies& deps) {
+    for (const auto& dep : deps) {
+        addControlDependence(dep.first, dep.second);
+    }
+}
+
 // FIXME: make it working on-demand
 void NTSCD::computeInterprocDependencies(Function *function) {
     DBG_SECTION_BEGIN(cda, "Computing interprocedural CD");
@@ -95,38 +103,115 @@ void NTSCD::computeInterprocDependencies(Function *function) {
 }
 
 void NTSCD::computeIntraprocDependencies(Function *function) {
-    const auto& nodes = function->nodes();
     DBG_SECTION_BEGIN(cda, "Computing intraprocedural CD");
+    Dependencies deps;
+    computeIntraprocDependencies(function, deps);
+    addControlDependencies(deps);
+    DBG_SECTION_END(cda, "Finished computing intraprocedural CD");
+}
+
+void NTSCD::computeIntraprocDependencies(Function *function, Dependencies& deps) const {
+    if (getOptions().ntscd2CD()) {
+        computeIntraprocDependencies2(function, deps);
+        return;
+    }
+
+    const auto& nodes = function->nodes();
+    std::vector<NodeInfo> nodeInfo(function->size());
     for (auto node : nodes) {
         // (1) initialize
-        nodeInfo.clear();
-        nodeInfo.reserve(nodes.size());
         for (auto node1 : nodes) {
-            nodeInfo[node1].outDegreeCounter = node1->successors().size();
+            nodeInfo[node1->id()] = NodeInfo();
+            nodeInfo[node1->id()].outDegreeCounter = node1->successors().size();
         }
         // (2) traverse
-        visitInitialNode(node);
+        visitInitialNode(node, nodeInfo);
         // (3) find out dependencies
         for (auto node1 : nodes) {
-            if (hasRedAndNonRedSuccessor(node1)) {
+            if (hasRedAndNonRedSuccessor(node1, nodeInfo)) {
                 // node is CD on node1
-                addControlDependence(node, node1);
+                deps.emplace_back(node, node1);
             }
         }
     }
-    DBG_SECTION_END(cda, "Finished computing intraprocedural CD");
 }
 
-void NTSCD::computeDependencies(Function *function) {
-    DBG_SECTION_BEGIN(cda, "Computing CD for a function");
-
-    computeIntraprocDependencies(function);
+///
+// Compute the same dependencies as computeIntraprocDependencies(),
+// that is, for every block 'n' we color red the blocks from which all
+// maximal paths go through 'n' and 'n' depends on the blocks that have
+// both red and non-red successors. The state is indexed by the IDs of
+// blocks and the coloring is a worklist algorithm that touches only
+// the blocks that have a red successor. These are also the only candidates for the
+// dependencies, so handling a block takes time linear in the part of
+// the function that is backward-reachable from the block and not
+// in the size of the whole function.
+void NTSCD::computeIntraprocDependencies2(Function *function, Dependencies& deps) const {
+    std::vector<Block *> blocks(function->size());
+    for (auto *block : function->nodes()) {
+        blocks[block->id()] = block;
+    }
 
-    if (getOptions().interproceduralCD()) {
-        computeInterprocDependencies(function);
+    std::vector<std::vector<unsigned>> predecessors(blocks.size());
+    for (unsigned i = 0; i < blocks.size(); ++i) {
+        for (auto *predecessor : blocks[i]->predecessors()) {
+            predecessors[i].push_back(predecessor->id());
+        }
     }
 
-    DBG_SECTION_END(cda, "Finished computing CD for a function");
+    // the node for which we colored a block or initialized its counter
+    // the last time (+ 1), so that we do not need to reset the arrays
+    std::vector<unsigned> red(blocks.size(), 0);
+    std::vector<unsigned> touched(blocks.size(), 0);
+    std::vector<size_t> outDegreeCounter(blocks.size());
+    std::vector<unsigned> candidates;
+    std::vector<unsigned> queue;
+
+    for (unsigned n = 0; n < blocks.size(); ++n) {
+        const unsigned color = n + 1;
+        candidates.clear();
+        red[n] = color;
+        queue.push_back(n);
+
+        while (!queue.empty()) {
+            unsigned node = queue.back();
+            queue.pop_back();
+
+            for (unsigned predecessor : predecessors[node]) {
+                if (red[predecessor] == color) {
+                    continue;
+                }
+                if (touched[predecessor] != color) {
+                    touched[predecessor] = color;
+                    outDegreeCounter[predecessor] = blocks[predecessor]->successors().size();
+                    candidates.push_back(predecessor);
+                }
+                if (--outDegreeCounter[predecessor] == 0) {
+                    red[predecessor] = color;
+                    queue.push_back(predecessor);
+                }
+            }
+        }
+
+        // the blocks that were not colored have some red
+        // and some non-red successor
+        for (unsigned candidate : candidates) {
+            if (red[candidate] != color) {
+                deps.emplace_back(blocks[n], blocks[candidate]);
+            }
+        }
+
+        // 'n' itself was colored without looking at its successors
+        size_t redCounter = 0;
+        for (auto *successor : blocks[n]->successors()) {
+            if (red[successor->id()] == color) {
+                ++redCounter;
+            }
+        }
+        if (redCounter > 0 && blocks[n]->successors().size() > redCounter) {
+            deps.emplace_back(blocks[n], blocks[n]);
+        }
+    }
 }
 
 ///
@@ -150,8 +235,27 @@ void NTSCD::computeDependencies() {
 
     entryFunc->entry()->visit();
 
+    std::vector<Function *> functions;
     for (auto& it : graphBuilder.functions()) {
-        computeDependencies(it.second);
+        functions.push_back(it.second);
+    }
+
+    // the intraprocedural dependencies of functions are independent,
+    // every thread stores them into its own buffer
+    std::vector<Dependencies> found(std::max(getOptions().workers, 1U));
+    parallelFor(functions.size(), getOptions().workers,
+                [this, &functions, &found](size_t i, unsigned thread) {
+        computeIntraprocDependencies(functions[i], found[thread]);
+    });
+
+    for (auto& deps : found) {
+        addControlDependencies(deps);
+    }
+
+    if (getOptions().interproceduralCD()) {
+        for (auto *function : functions) {
+            computeInterprocDependencies(function);
+        }
     }
     DBG_SECTION_END(cda, "Finished computing CD for the whole module");
 }
@@ -188,30 +292,36 @@ void NTSCD::dumpDependencies(ostream &ostream) const {
     }
 }
 
-void NTSCD::visitInitialNode(Block *node) {
-    nodeInfo[node].red = true;
-    for (auto predecessor : node->predecessors()) {
-        visit(predecessor);
-    }
-}
-
-void NTSCD::visit(Block *node) {
-    if (nodeInfo[node].outDegreeCounter == 0) {
-        return;
-    }
-    nodeInfo[node].outDegreeCounter--;
-    if (nodeInfo[node].outDegreeCounter == 0) {
-        nodeInfo[node].red = true;
-        for (auto predecessor : node->predecessors()) {
-            visit(predecessor);
+void NTSCD::visitInitialNode(Block *node, std::vector<NodeInfo>& nodeInfo) {
+    nodeInfo[node->id()].red = true;
+    // the node is red regardless of its successors, do not let
+    // the search color it again and visit its predecessors twice
+    nodeInfo[node->id()].outDegreeCounter = 0;
+
+    // go backwards from the red nodes, a node becomes red
+    // when all its successors are red
+    std::vector<Block *> stack{node};
+    while (!stack.empty()) {
+        Block *red = stack.back();
+        stack.pop_back();
+
+        for (auto predecessor : red->predecessors()) {
+            auto& info = nodeInfo[predecessor->id()];
+            if (info.outDegreeCounter == 0) {
+                continue;
+            }
+            if (--info.outDegreeCounter == 0) {
+                info.red = true;
+                stack.push_back(predecessor);
+            }
         }
     }
 }
 
-bool NTSCD::hasRedAndNonRedSuccessor(Block *node) {
+bool NTSCD::hasRedAndNonRedSuccessor(Block *node, const std::vector<NodeInfo>& nodeInfo) {
     size_t redCounter = 0;
     for (auto successor : node->successors()) {
-        if (nodeInfo[successor].red) {
+        if (nodeInfo[successor->id()].red) {
             ++redCounter;
         }
     }
@@ -7,6 +7,8 @@
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Block.h"
 
@@ -87,22 +89,30 @@ private:
     std::map<Block *, std::set<Block *>> controlDependency;
     // reverse edges (from dependent blocks to branchings)
     std::map<Block *, std::set<Block *>> revControlDependency;
-    std::unordered_map<Block *, NodeInfo> nodeInfo;
     std::set<const llvm::Function *> _computed; // for on-demand
 
-    void computeDependencies(Function *);
+    // pairs (a, b) such that a is CD on b
+    using Dependencies = std::vector<std::pair<Block *, Block *>>;
+
     void computeOnDemand(llvm::Function *F);
 
     void computeInterprocDependencies(Function *function);
     void computeIntraprocDependencies(Function *function);
 
+    // these two do not change the state of the analysis, they only
+    // store the found dependencies into 'deps', so they can run
+    // for more functions at once
+    void computeIntraprocDependencies(Function *function, Dependencies& deps) const;
+    void computeIntraprocDependencies2(Function *function, Dependencies& deps) const;
+
     // a is CD on b
     void addControlDependence(Block *a, Block *b);
+    void addControlDependencies(const Dependencies& deps);
 
-    void visitInitialNode(Block * node);
-    void visit(Block * node);
+    // the state is indexed by the IDs of blocks
+    static void visitInitialNode(Block * node, std::vector<NodeInfo>& nodeInfo);
 
-    bool hasRedAndNonRedSuccessor(Block * node);
+    static bool hasRedAndNonRedSuccessor(Block * node, const std::vector<NodeInfo>& nodeInfo);
 };
 
 } // namespace llvmdg
@@ -10,12 +10,8 @@
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/Analysis/PostDominators.h>
-#include "llvm/Analysis/IteratedDominanceFrontier.h"
-
-#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-#include "llvm/Analysis/DominanceFrontier.h"
-#endif
 
 #if (__clang__)
 #pragma clang diagnostic pop // ignore -Wunused-parameter
@@ -23,125 +19,278 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-#include "dg/BFS.h"
-#endif
-
-#include "dg/ADT/Queue.h"
 #include "dg/util/debug.h"
+#include "dg/util/parallel.h"
 
 using namespace std;
 
 namespace dg {
 namespace llvmdg {
 
+///
+// Compute the post-dominance frontiers of all blocks of the function
+// in one pass over the post-dominator tree. The algorithm is due:
+//
+// R. Cytron, J. Ferrante, B. K. Rosen, M. N. Wegman, and F. K. Zadeck. 1991.
+// Efficiently computing static single assignment form and the control
+// dependence graph. ACM Trans. Program. Lang. Syst. 13, 4, 451-490.
+//
+// The post-dominance frontier of a block are the blocks that the block
+// is control dependent on. We go over the tree in post-order using
+// an explicit stack, so that the frontiers of the children are computed
+// before the frontier of their parent (and deep trees do not overflow
+// the stack).
+void SCD::computePostDominators(llvm::Function& F, FunctionDependencies& deps,
+                                bool keepTree) {
+    using namespace llvm;
+
+    PostDominatorTree *pdtree = deps.pdtree.get();
+
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
+    (void) keepTree;
+    pdtree = new PostDominatorTree();
+    // compute post-dominator tree for this function
+    pdtree->runOnFunction(F);
+#else // LLVM >= 3.9
+    PostDominatorTreeWrapperPass wrapper;
+#if LLVM_VERSION_MAJOR >= 9
+    // we keep the trees for incremental updates (this needs LLVM
+    // that removes the nodes of post-dominator trees correctly)
+    if (!pdtree && keepTree) {
+        deps.pdtree.reset(new PostDominatorTree());
+        deps.pdtree->recalculate(F);
+    }
+    pdtree = deps.pdtree.get();
+#else
+    (void) keepTree;
+#endif
 
-/// LLVM < 3.9 does not have post-dominance frontiers computation...
-class PostDominanceFrontiers {
-    using BBlockT = llvm::BasicBlock;
-    using DomSetMapType = typename llvm::DominanceFrontierBase<llvm::BasicBlock>::DomSetMapType;
-    using DomSetType = typename llvm::DominanceFrontierBase<llvm::BasicBlock>::DomSetType;
-
-    DomSetMapType frontiers;
-
-public:
-    // based on the code from giri project by @liuml07,
-    // https://github.com/liuml07/giri
-    DomSetType& calculate(const llvm::PostDominatorTree &DT,
-                          const llvm::DomTreeNode *Node) {
-
-        llvm::BasicBlock *BB = Node->getBlock();
-        DomSetType &S = frontiers[BB];
-        if (DT.getRoots().empty())
-            return S;
-
-        // calculate DFlocal[Node]
-        if (BB) {
-          for (auto *P : predecessors(BB)) {
-            // Does Node immediately dominate this predecessor?
-            auto *SINode = DT[P];
-            if (SINode && SINode->getIDom() != Node)
-              S.insert(P);
-          }
-        }
+    if (!pdtree) {
+        wrapper.runOnFunction(F);
+        pdtree = &wrapper.getPostDomTree();
 
-        // At this point, S is DFlocal.  Now we union in DFup's of our children.
-        // Loop through and visit the nodes that Node immediately dominates (Node's
-        // children in the IDomTree)
-        for (auto IDominee : *Node) {
-          const auto &ChildDF = calculate(DT, IDominee);
+#ifndef NDEBUG
+        wrapper.verifyAnalysis();
+#endif
+    }
+#endif // LLVM < 3.9
 
-          for (auto *cdfi : ChildDF) {
-            if (!DT.properlyDominates(Node, DT[cdfi]))
-              S.insert(cdfi);
-          }
+    // number the blocks of the function
+    std::unordered_map<const BasicBlock *, unsigned> index;
+    for (auto& B : F) {
+        index.emplace(&B, deps.blocks.size());
+        deps.blocks.push_back(&B);
+    }
+    deps.dependencies.resize(deps.blocks.size());
+    deps.dependentBlocks.resize(deps.blocks.size());
+
+    // the block for whose frontier we added the block the last time,
+    // so that we do not add a block to a frontier twice
+    std::vector<unsigned> added(deps.blocks.size(), ~0U);
+
+    auto computeFrontier = [&](const DomTreeNode *node) {
+        BasicBlock *B = node->getBlock();
+        // the virtual root of the tree (more exit points)
+        if (!B)
+            return;
+
+        unsigned idx = index[B];
+        auto add = [&](BasicBlock *dep) {
+            unsigned depIdx = index[dep];
+            if (added[depIdx] == idx)
+                return;
+            added[depIdx] = idx;
+            deps.dependencies[idx].push_back(dep);
+            deps.dependentBlocks[depIdx].push_back(B);
+        };
+
+        // DF_local: the predecessors that the block
+        // does not immediately post-dominate
+        for (auto *pred : predecessors(B)) {
+            auto *predNode = pdtree->getNode(pred);
+            if (predNode && predNode->getIDom() != node)
+                add(pred);
         }
 
-        return S;
+        // DF_up: the frontiers of the children that the block
+        // does not immediately post-dominate
+        for (auto *child : *node) {
+            for (auto *dep : deps.dependencies[index[child->getBlock()]]) {
+                if (pdtree->getNode(dep)->getIDom() != node)
+                    add(dep);
+            }
+        }
+    };
+
+    if (const DomTreeNode *root = pdtree->getRootNode()) {
+        using ChildIterator = decltype(root->begin());
+        std::vector<std::pair<const DomTreeNode *, ChildIterator>> stack;
+        stack.emplace_back(root, root->begin());
+
+        while (!stack.empty()) {
+            const DomTreeNode *node = stack.back().first;
+            auto& iterator = stack.back().second;
+            if (iterator != node->end()) {
+                const DomTreeNode *child = *iterator;
+                ++iterator;
+                stack.emplace_back(child, child->begin());
+                continue;
+            }
+
+            stack.pop_back();
+            computeFrontier(node);
+        }
     }
-};
 
-#endif // LLVM < 3.9
+#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
+    delete pdtree;
+#endif
+}
+
+void SCD::addDependencies(const llvm::Function& F, FunctionDependencies& deps) {
+    // the blocks of a function whose dependencies
+    // are computed again keep their indices
+    for (unsigned i = 0; i < deps.blocks.size(); ++i) {
+        auto it = blockIndex.emplace(deps.blocks[i], dependencies.size());
+        if (it.second) {
+            // take the index of a deleted block if there is one
+            if (!freeIndices.empty()) {
+                it.first->second = freeIndices.back();
+                freeIndices.pop_back();
+            } else {
+                dependencies.emplace_back();
+                dependentBlocks.emplace_back();
+            }
+        }
+        dependencies[it.first->second] = std::move(deps.dependencies[i]);
+        dependentBlocks[it.first->second] = std::move(deps.dependentBlocks[i]);
+    }
+
+    if (deps.pdtree)
+        _pdtrees[&F] = std::move(deps.pdtree);
+}
 
 void SCD::computePostDominators(llvm::Function& F) {
     DBG_SECTION_BEGIN(cda, "Computing post dominators for function "
                            << F.getName().str());
-    using namespace llvm;
-
-    PostDominatorTree *pdtree = nullptr;
+    FunctionDependencies deps;
+    applyUpdates(&F);
+    auto it = _pdtrees.find(&F);
+    if (it != _pdtrees.end())
+        deps.pdtree = std::move(it->second);
+    computePostDominators(F, deps, getOptions().incremental);
+    addDependencies(F, deps);
+    DBG_SECTION_END(cda, "Done computing post dominators for function " << F.getName().str());
+}
 
-    DBG(cda, "Computing post dominator tree");
-#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-    pdtree = new PostDominatorTree();
-    // compute post-dominator tree for this function
-    pdtree->runOnFunction(F);
+void SCD::applyUpdates(const llvm::Function *F) {
+#if LLVM_VERSION_MAJOR >= 9
+    auto it = _updates.find(F);
+    if (it == _updates.end())
+        return;
 
-    DBG(cda, "Computing post dominator frontiers and adding CD");
+    auto tree = _pdtrees.find(F);
+    if (tree != _pdtrees.end())
+        tree->second->applyUpdates(it->second);
+    _updates.erase(it);
+#else
+    (void) F;
+#endif
+}
 
-    PostDominanceFrontiers PDF;
+void SCD::insertEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) {
+    auto *F = from->getParent();
+    if (_computed.count(F) == 0)
+        return;
 
-    for (auto& B : F) {
-        auto *pdtreenode = pdtree->getNode(&B);
-        assert(pdtreenode && "Do not have a node in post-dom tree");
-        auto& pdfrontiers = PDF.calculate(*pdtree, pdtreenode);
-        for (auto *pdf : pdfrontiers) {
-            dependencies[&B].insert(pdf);
-            dependentBlocks[pdf].insert(&B);
-        }
+#if LLVM_VERSION_MAJOR >= 9
+    if (_pdtrees.count(F) > 0) {
+        _updates[F].push_back({llvm::PostDominatorTree::Insert,
+                               const_cast<llvm::BasicBlock *>(from),
+                               const_cast<llvm::BasicBlock *>(to)});
     }
+#else
+    (void) to;
+#endif
+    _changed.insert(F);
+}
 
-    delete pdtree;
-#else // LLVM >= 3.9
-
-    PostDominatorTreeWrapperPass wrapper;
-    wrapper.runOnFunction(F);
-    pdtree = &wrapper.getPostDomTree();
+void SCD::deleteEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) {
+    auto *F = from->getParent();
+    if (_computed.count(F) == 0)
+        return;
 
-#ifndef NDEBUG
-    wrapper.verifyAnalysis();
+#if LLVM_VERSION_MAJOR >= 9
+    if (_pdtrees.count(F) > 0) {
+        _updates[F].push_back({llvm::PostDominatorTree::Delete,
+                               const_cast<llvm::BasicBlock *>(from),
+                               const_cast<llvm::BasicBlock *>(to)});
+    }
+#else
+    (void) to;
 #endif
+    _changed.insert(F);
+}
 
-    DBG(cda, "Computing post dominator frontiers and adding CD");
-    llvm::ReverseIDFCalculator PDF(*pdtree);
-    for (auto& B : F) {
-        llvm::SmallPtrSet<llvm::BasicBlock *, 1> blocks;
-        blocks.insert(&B);
-        PDF.setDefiningBlocks(blocks);
+void SCD::deleteBlock(const llvm::BasicBlock *B) {
+    auto *F = B->getParent();
+    auto idx = blockIndex.find(B);
+    if (idx != blockIndex.end()) {
+        dependencies[idx->second].clear();
+        dependentBlocks[idx->second].clear();
+        freeIndices.push_back(idx->second);
+        blockIndex.erase(idx);
+    }
+
+    if (_computed.count(F) == 0)
+        return;
+
+#if LLVM_VERSION_MAJOR >= 9
+    // the block is going to be erased, so the tree
+    // must not refer to it in the pending updates
+    applyUpdates(F);
+    auto it = _pdtrees.find(F);
+    if (it != _pdtrees.end()) {
+        auto *node = it->second->getNode(B);
+        if (node && node->getNumChildren() == 0) {
+            it->second->eraseNode(const_cast<llvm::BasicBlock *>(B));
+        } else if (node) {
+            // the block still has some edges, compute the tree again
+            _pdtrees.erase(it);
+        }
+    }
+#endif
+    _changed.insert(F);
+}
 
-        SmallVector<BasicBlock *, 8> pdfrontiers;
-        PDF.calculate(pdfrontiers);
+void SCD::run() {
+    if (getOptions().workers <= 1)
+        return;
 
-        // FIXME: reserve the memory
-        for (auto *pdf : pdfrontiers) {
-            dependencies[&B].insert(pdf);
-            dependentBlocks[pdf].insert(&B);
+    DBG_SECTION_BEGIN(cda, "Computing post dominators for all functions");
+    std::vector<llvm::Function *> functions;
+    for (auto& F : *getModule()) {
+        if (!F.isDeclaration() && _computed.insert(&F).second) {
+            /// FIXME: get rid of the const cast
+            functions.push_back(const_cast<llvm::Function *>(&F));
         }
     }
-#endif // LLVM < 3.9
 
-    DBG_SECTION_END(cda, "Done computing post dominators for function " << F.getName().str());
+    // every function has its own result, we add them all at the end
+    std::vector<FunctionDependencies> results(functions.size());
+    bool keepTrees = getOptions().incremental;
+    parallelFor(functions.size(), getOptions().workers,
+                [&functions, &results, keepTrees](size_t i, unsigned) {
+        computePostDominators(*functions[i], results[i], keepTrees);
+    });
+
+    for (size_t i = 0; i < functions.size(); ++i)
+        addDependencies(*functions[i], results[i]);
+    DBG_SECTION_END(cda, "Done computing post dominators for all functions");
 }
 
 
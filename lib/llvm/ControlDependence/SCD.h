@@ -3,9 +3,27 @@
 
 #include "dg/llvm/ControlDependence/ControlDependence.h"
 
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Analysis/PostDominators.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include <memory>
 #include <set>
-#include <map>
 #include <unordered_map>
+#include <vector>
 
 
 namespace llvm {
@@ -22,11 +40,62 @@ namespace llvmdg {
 // of post-dominance frontiers
 class SCD : public LLVMControlDependenceAnalysisImpl {
 
+    // the dependencies of the blocks of one function,
+    // indexed by the position of the block in the function
+    struct FunctionDependencies {
+        std::vector<llvm::BasicBlock *> blocks;
+        std::vector<std::vector<llvm::BasicBlock *>> dependentBlocks;
+        std::vector<std::vector<llvm::BasicBlock *>> dependencies;
+        // the post-dominator tree of the function if we keep it
+        // for incremental updates (or if it has been kept before)
+        std::unique_ptr<llvm::PostDominatorTree> pdtree;
+    };
+
+    // this one does not change the state of the analysis,
+    // so it can run for more functions at once
+    static void computePostDominators(llvm::Function& F, FunctionDependencies& deps,
+                                      bool keepTree);
+    void addDependencies(const llvm::Function& F, FunctionDependencies& deps);
     void computePostDominators(llvm::Function& F);
-
-    std::unordered_map<const llvm::BasicBlock *, std::set<llvm::BasicBlock *>> dependentBlocks;
-    std::unordered_map<const llvm::BasicBlock *, std::set<llvm::BasicBlock *>> dependencies;
+    // apply the pending updates of the kept post-dominator tree
+    void applyUpdates(const llvm::Function *F);
+
+    // index of the block to the vectors below
+    std::unordered_map<const llvm::BasicBlock *, unsigned> blockIndex;
+    // the blocks that are control dependent on the block
+    std::vector<std::vector<llvm::BasicBlock *>> dependentBlocks;
+    // the blocks that the block is control dependent on
+    // (the post-dominance frontier of the block)
+    std::vector<std::vector<llvm::BasicBlock *>> dependencies;
+    // the indices of the deleted blocks, reused by new blocks
+    std::vector<unsigned> freeIndices;
     std::set<const llvm::Function *> _computed;
+    // the functions whose CFG changed after we computed their dependencies
+    std::set<const llvm::Function *> _changed;
+    // the post-dominator trees kept for incremental updates
+    std::unordered_map<const llvm::Function *,
+                       std::unique_ptr<llvm::PostDominatorTree>> _pdtrees;
+#if LLVM_VERSION_MAJOR >= 9
+    // the changes of the CFG that were not applied to the kept trees yet,
+    // they are applied in one batch when the tree is needed
+    std::unordered_map<const llvm::Function *,
+                       std::vector<llvm::PostDominatorTree::UpdateType>> _updates;
+#endif
+
+    ValVec getBlocks(const std::vector<std::vector<llvm::BasicBlock *>>& blocks,
+                     const llvm::BasicBlock *b) {
+        if (_computed.insert(b->getParent()).second ||
+            (!_changed.empty() && _changed.erase(b->getParent()) > 0)) {
+            /// FIXME: get rid of the const cast
+            computePostDominators(*const_cast<llvm::Function*>(b->getParent()));
+        }
+
+        auto it = blockIndex.find(b);
+        if (it == blockIndex.end())
+            return {};
+        auto& V = blocks[it->second];
+        return ValVec{V.begin(), V.end()};
+    }
 
 public:
     using ValVec = LLVMControlDependenceAnalysis::ValVec;
@@ -41,24 +110,26 @@ public:
 
     /// Getters of dependencies for a basic block
     ValVec getDependencies(const llvm::BasicBlock *b) override {
-        if (_computed.insert(b->getParent()).second) {
-            /// FIXME: get rid of the const cast
-            computePostDominators(*const_cast<llvm::Function*>(b->getParent()));
-        }
-
-        auto &S = dependencies[b];
-        return ValVec{S.begin(), S.end()};
+        return getBlocks(dependencies, b);
     }
 
     ValVec getDependent(const llvm::BasicBlock *b) override {
-        if (_computed.insert(b->getParent()).second) {
-            computePostDominators(*const_cast<llvm::Function*>(b->getParent()));
-        }
-        auto &S = dependentBlocks[b];
-        return ValVec{S.begin(), S.end()};
+        return getBlocks(dependentBlocks, b);
     }
 
-    void run() override { /* we work on-demand */ }
+    // We work on-demand. With more workers in the options,
+    // run() computes all the functions in parallel.
+    void run() override;
+
+    // The dependencies of the changed functions are computed again on
+    // the next query. With the incremental option, the kept post-dominator
+    // trees are updated instead of being computed from scratch. The changes
+    // of the edges are collected and applied to a tree at once, on the next
+    // query or when a block of the function is deleted (the block must be
+    // in the CFG while the updates that remove its edges are applied).
+    void insertEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) override;
+    void deleteEdge(const llvm::BasicBlock *from, const llvm::BasicBlock *to) override;
+    void deleteBlock(const llvm::BasicBlock *B) override;
 };
 
 } // namespace llvmdg
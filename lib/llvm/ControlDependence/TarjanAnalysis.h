@@ -1,10 +1,11 @@
 #ifndef DG_LLVM_TARJANANALYSIS_H
 #define DG_LLVM_TARJANANALYSIS_H
 
+#include <atomic>
 #include <vector>
 #include <set>
 #include <unordered_set>
-#include <unordered_map>
+#include <utility>
 #include <stack>
 #include <queue>
 #include <algorithm>
@@ -20,7 +21,7 @@ public:
     class StronglyConnectedComponent
     {
     private:
-        static int idCounter;
+        static std::atomic<int> idCounter;
     public:
         StronglyConnectedComponent():id_(++idCounter) {}
 
@@ -72,40 +73,39 @@ public:
         }
     }
 
-    void compute(T * currentNode) {
-        ++index;
-        nodeInfo[currentNode].dfsId = index;
-        nodeInfo[currentNode].lowLink = index;
-
-        stack.push(currentNode);
-        nodeInfo[currentNode].onStack = true;
-
-        for (auto successor : currentNode->successors()) {
-            if (!visited(successor)) {
-                compute(successor);
-                nodeInfo[currentNode].lowLink = std::min(nodeInfo[currentNode].lowLink,
-                                                         nodeInfo[successor].lowLink);
-            } else if (nodeInfo[successor].onStack) {
-                nodeInfo[currentNode].lowLink = std::min(nodeInfo[currentNode].lowLink,
-                                                         nodeInfo[successor].dfsId);
+    // the recursive algorithm with an explicit stack of frames, every
+    // frame remembers the successor of the node that comes next
+    void compute(T * root) {
+        using SuccessorIterator = decltype(root->successors().begin());
+        std::vector<std::pair<T *, SuccessorIterator>> frames;
+
+        enter(root);
+        frames.emplace_back(root, root->successors().begin());
+
+        while (!frames.empty()) {
+            T * currentNode = frames.back().first;
+            auto& iterator = frames.back().second;
+
+            if (iterator != currentNode->successors().end()) {
+                T * successor = *iterator;
+                ++iterator;
+                if (!visited(successor)) {
+                    enter(successor);
+                    frames.emplace_back(successor, successor->successors().begin());
+                } else if (info(successor).onStack) {
+                    info(currentNode).lowLink = std::min(info(currentNode).lowLink,
+                                                         info(successor).dfsId);
+                }
+                continue;
             }
-        }
 
-        if (nodeInfo[currentNode].lowLink == nodeInfo[currentNode].dfsId) {
-            auto component = new StronglyConnectedComponent();
-            components_.insert(component);
+            frames.pop_back();
+            leave(currentNode);
 
-            T * node;
-            while (nodeInfo[stack.top()].dfsId >= nodeInfo[currentNode].dfsId) {
-                node = stack.top();
-                stack.pop();
-                nodeInfo[node].onStack = false;
-                component->addNode(node);
-                nodeInfo[node].component = component;
-
-                if (stack.empty()) {
-                    break;
-                }
+            if (!frames.empty()) {
+                T * parent = frames.back().first;
+                info(parent).lowLink = std::min(info(parent).lowLink,
+                                                info(currentNode).lowLink);
             }
         }
     }
@@ -114,8 +114,8 @@ public:
         for (auto component : components_) {
             for (auto node : component->nodes()) {
                 for (auto successor : node->successors()) {
-                    if (nodeInfo[node].component != nodeInfo[successor].component) {
-                        nodeInfo[node].component->addSuccessor(nodeInfo[successor].component);
+                    if (info(node).component != info(successor).component) {
+                        info(node).component->addSuccessor(info(successor).component);
                     }
                 }
             }
@@ -126,11 +126,10 @@ public:
         std::set<StronglyConnectedComponent *> visitedComponents;
         std::queue<StronglyConnectedComponent *> queue;
 
-        auto iterator = nodeInfo.find(node);
-        if (iterator == nodeInfo.end()) {
+        if (!visited(node)) {
             return visitedComponents;
         }
-        auto initialComponent = iterator.second;
+        auto initialComponent = info(node).component;
         visitedComponents.insert(initialComponent);
         queue.push(initialComponent);
 
@@ -155,17 +154,57 @@ public:
 
     std::stack<T *> stack;
 
-    std::unordered_map<T *, Node> nodeInfo;
+    // indexed by the IDs of nodes
+    std::vector<Node> nodeInfo;
 
     std::set<StronglyConnectedComponent *> components_;
 
     private:
 
-    bool visited(T * node) { return nodeInfo[node].dfsId > 0; }
+    Node& info(T * node) {
+        if (node->id() >= nodeInfo.size()) {
+            nodeInfo.resize(node->id() + 1);
+        }
+        return nodeInfo[node->id()];
+    }
+
+    bool visited(T * node) { return info(node).dfsId > 0; }
+
+    void enter(T * node) {
+        ++index;
+        info(node).dfsId = index;
+        info(node).lowLink = index;
+
+        stack.push(node);
+        info(node).onStack = true;
+    }
+
+    // pop the component if the node is its root
+    void leave(T * node) {
+        if (info(node).lowLink != info(node).dfsId) {
+            return;
+        }
+
+        auto component = new StronglyConnectedComponent();
+        components_.insert(component);
+
+        T * top;
+        while (info(stack.top()).dfsId >= info(node).dfsId) {
+            top = stack.top();
+            stack.pop();
+            info(top).onStack = false;
+            component->addNode(top);
+            info(top).component = component;
+
+            if (stack.empty()) {
+                break;
+            }
+        }
+    }
 };
 
 template <typename T>
-int TarjanAnalysis<T>::StronglyConnectedComponent::idCounter = 0;
+std::atomic<int> TarjanAnalysis<T>::StronglyConnectedComponent::idCounter{0};
 
 }
 }
@@ -1,3 +1,7 @@
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -8,6 +12,7 @@
 #endif
 
 #include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Module.h>
 
 #if (__clang__)
 #pragma clang diagnostic pop // ignore -Wunused-parameter
@@ -76,7 +81,7 @@ LLVMDataDependenceAnalysis::getLLVMDefinitions(llvm::Instruction *where,
         auto *GV = llvm::dyn_cast<llvm::GlobalVariable>(mem);
         if (!GV || GV->isExternallyInitialized()) {
             // the memory is global and initialised, no need to worry
-            static std::set<std::pair<const llvm::Value *, const llvm::Value *>> reported;
+            static thread_local std::set<std::pair<const llvm::Value *, const llvm::Value *>> reported;
             if (reported.insert({where, mem}).second) {
                 llvm::errs() << "[DDA] warn: no definition for: "
                              << *mem << "at " << *where << "\n";
@@ -96,6 +101,92 @@ LLVMDataDependenceAnalysis::getLLVMDefinitions(llvm::Instruction *where,
     return defs;
 }
 
+///
+// Names RWNodes by the LLVM values they were created from: globals
+// by their name and arguments and instructions by the name
+// of the function and their position in the function.
+class LLVMRWNodeNaming : public RWNodeNaming {
+    std::unordered_map<const RWNode *, std::string> _names;
+    std::unordered_map<std::string, RWNode *> _nodes;
+
+    void add(RWNode *node, std::string&& name) {
+        _nodes.emplace(name, node);
+        _names.emplace(node, std::move(name));
+    }
+
+public:
+    LLVMRWNodeNaming(const llvm::Module *m,
+                     const LLVMReadWriteGraphBuilder *builder) {
+        unsigned idx = 0;
+        for (auto& G : m->globals()) {
+            if (auto *nd = builder->getNode(&G)) {
+                add(const_cast<RWNode *>(nd),
+                    G.hasName() ? "@" + G.getName().str()
+                                : "@#" + std::to_string(idx));
+            }
+            ++idx;
+        }
+
+        for (auto& F : *m) {
+            const auto fun = F.getName().str();
+            idx = 0;
+            for (auto& A : F.args()) {
+                if (auto *nd = builder->getNode(&A)) {
+                    add(const_cast<RWNode *>(nd), fun + "%" + std::to_string(idx));
+                }
+                ++idx;
+            }
+
+            idx = 0;
+            for (auto& B : F) {
+                for (auto& I : B) {
+                    if (auto *nd = builder->getNode(&I)) {
+                        add(const_cast<RWNode *>(nd), fun + "#" + std::to_string(idx));
+                    }
+                    ++idx;
+                }
+            }
+        }
+    }
+
+    std::string getName(const RWNode *node) const override {
+        auto it = _names.find(node);
+        return it == _names.end() ? std::string() : it->second;
+    }
+
+    RWNode *getNode(const std::string& name) const override {
+        auto it = _nodes.find(name);
+        return it == _nodes.end() ? nullptr : it->second;
+    }
+};
+
+unsigned LLVMDataDependenceAnalysis::updateModRefSummaries() {
+    assert(DDA && "The analysis has not been run");
+    assert(_options.isSSA() && "Mod/ref summaries need MemorySSA");
+
+    std::ifstream in(_options.modRefSummaries);
+    // the file does not exist if no summaries were stored yet
+    if (in.is_open() && !_modRefSummaries.read(in)) {
+        llvm::errs() << "[DDA] warn: ignoring malformed mod/ref summaries in "
+                     << _options.modRefSummaries << "\n";
+        _modRefSummaries.clear();
+    }
+
+    const LLVMReadWriteGraphBuilder *cbuilder = builder;
+    LLVMRWNodeNaming naming(m, cbuilder);
+    auto *SSA = static_cast<MemorySSATransformation *>(DDA->getImpl());
+    _reusedModRefSummaries = SSA->updateModRefSummaries(_modRefSummaries, naming);
+    return _reusedModRefSummaries;
+}
+
+bool LLVMDataDependenceAnalysis::storeModRefSummaries() const {
+    assert(!_options.modRefSummaries.empty() && "No file for summaries given");
+
+    std::ofstream out(_options.modRefSummaries);
+    _modRefSummaries.write(out);
+    return out.good();
+}
+
 // the value 'use' must be an instruction that reads from memory
 std::vector<llvm::Value *>
 LLVMDataDependenceAnalysis::getLLVMDefinitions(llvm::Value *use) {
@@ -123,7 +214,7 @@ LLVMDataDependenceAnalysis::getLLVMDefinitions(llvm::Value *use) {
 #ifndef NDEBUG
     if (rdDefs.empty()) {
         if (!loc->usesOnlyGlobals()) {
-            static std::set<const llvm::Value *> reported;
+            static thread_local std::set<const llvm::Value *> reported;
             if (reported.insert(use).second) {
                 llvm::errs() << "[DDA] warn: no definitions for: "
                              << *use << "\n";
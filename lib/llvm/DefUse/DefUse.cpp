@@ -69,10 +69,10 @@ static void addReturnEdge(LLVMNode *callNode, LLVMDependenceGraph *subgraph)
 
 LLVMDefUseAnalysis::LLVMDefUseAnalysis(LLVMDependenceGraph *dg,
                                        LLVMDataDependenceAnalysis *rd,
-                                       LLVMPointerAnalysis *pta)
-    : legacy::DataFlowAnalysis<LLVMNode>(dg->getEntryBB(),
-                                                   legacy::DATAFLOW_INTERPROCEDURAL),
-      dg(dg), RD(rd), PTA(pta), DL(new DataLayout(dg->getModule())) {
+                                       LLVMPointerAnalysis *pta,
+                                       bool lazy)
+    : dg(dg), RD(rd), PTA(pta), DL(new DataLayout(dg->getModule())),
+      lazy(lazy) {
     assert(PTA && "Need points-to information");
     assert(RD && "Need reaching definitions");
 }
@@ -86,57 +86,130 @@ void LLVMDefUseAnalysis::handleCallInst(LLVMNode *node)
         addReturnEdge(node, subgraph);
 }
 
-void LLVMDefUseAnalysis::addDataDependencies(LLVMNode *node) {
-    static std::set<const llvm::Value *> reported_mappings;
+static LLVMNode *findNode(LLVMDependenceGraph *dg, llvm::Value *val) {
+    if (LLVMNode *node = dg->getNode(val))
+        return node;
 
-    auto val = node->getValue();
-    auto defs = RD->getLLVMDefinitions(val);
+    // the value is not from this graph
+    llvm::Function *F
+        = llvm::cast<llvm::Instruction>(val)->getParent()->getParent();
+    LLVMNode *entryNode = dg->getGlobalNode(F);
+    assert(entryNode && "Don't have built function");
+    return entryNode->getDG()->getNode(val);
+}
 
-    // add data dependence
-    for (auto def : defs) {
-        LLVMNode *rdnode = dg->getNode(def);
-        if (!rdnode) {
-            // that means that the value is not from this graph.
-            // We need to add interprocedural edge
-            llvm::Function *F
-                = llvm::cast<llvm::Instruction>(def)->getParent()->getParent();
-            LLVMNode *entryNode = dg->getGlobalNode(F);
-            assert(entryNode && "Don't have built function");
-
-            // get the graph where the node lives
-            LLVMDependenceGraph *graph = entryNode->getDG();
-            assert(graph != dg && "Cannot find a node");
-            rdnode = graph->getNode(def);
-            if (!rdnode) {
-                llvmutils::printerr("[DU] error: DG doesn't have val: ", def);
-                abort();
-                return;
-            }
+void LLVMDefUseAnalysis::runBatched()
+{
+    // nodes of the read-write graph mapped to our nodes (indexed by ID)
+    std::vector<LLVMNode *> rwnodes(RD->getGraph()->getNodesNum() + 1);
+    std::vector<std::pair<LLVMNode *, RWNode *>> uses;
+
+    auto mapNode = [&](LLVMNode *node) -> RWNode * {
+        RWNode *rwnode = RD->getNode(node->getValue());
+        if (rwnode) {
+            assert(rwnode->getID() < rwnodes.size());
+            rwnodes[rwnode->getID()] = node;
         }
+        return rwnode;
+    };
 
-        assert(rdnode);
-        rdnode->addDataDependence(node);
+    if (const auto& globals = dg->getGlobalNodes()) {
+        for (auto& it : *globals)
+            mapNode(it.second);
     }
-}
-
-bool LLVMDefUseAnalysis::runOnNode(LLVMNode *node, LLVMNode *)
-{
-    Value *val = node->getKey();
 
-    // just add direct def-use edges to every instruction
-    if (auto I = dyn_cast<Instruction>(val))
-        handleOperands(I, node);
+    // go over the nodes in the blocks that are reachable from the entry
+    // of this graph and of all graphs called from these blocks
+    std::set<LLVMDependenceGraph *> graphs{dg};
+    std::vector<LLVMDependenceGraph *> queue{dg};
+    std::set<LLVMBBlock *> visited;
+    std::vector<LLVMBBlock *> blocks;
+    while (!queue.empty()) {
+        LLVMDependenceGraph *graph = queue.back();
+        queue.pop_back();
+
+        LLVMBBlock *entry = graph->getEntryBB();
+        if (!entry)
+            continue;
+
+        visited.insert(entry);
+        blocks.push_back(entry);
+        while (!blocks.empty()) {
+            LLVMBBlock *block = blocks.back();
+            blocks.pop_back();
+
+            for (auto& E : block->successors()) {
+                if (visited.insert(E.target).second)
+                    blocks.push_back(E.target);
+            }
 
-    if (isa<CallInst>(val)) {
-        handleCallInst(node); // return edges and so...
+            for (LLVMNode *node : block->getNodes()) {
+                Value *val = node->getKey();
+                if (auto I = dyn_cast<Instruction>(val))
+                    handleOperands(I, node);
+
+                if (isa<CallInst>(val)) {
+                    handleCallInst(node);
+                    for (LLVMDependenceGraph *sub : node->getSubgraphs()) {
+                        if (graphs.insert(sub).second)
+                            queue.push_back(sub);
+                    }
+                }
+
+                RWNode *rwnode = mapNode(node);
+                if (!rwnode || !rwnode->isUse())
+                    continue;
+
+                if (lazy)
+                    graph->lazyDataDependencies.insert(node);
+                else
+                    uses.emplace_back(node, rwnode);
+            }
+        }
     }
 
-    if (RD->isUse(val)) {
-        addDataDependencies(node);
+    // we have mapped all nodes, now we can emit the edges
+    std::vector<std::pair<LLVMNode *, LLVMNode *>> edges;
+    edges.reserve(uses.size());
+    for (auto& use : uses) {
+        for (RWNode *def : RD->getDefinitions(use.second)) {
+            LLVMNode *defnode = def->getID() < rwnodes.size() ?
+                                    rwnodes[def->getID()] : nullptr;
+            if (!defnode) {
+                // the definition is not in any block that we
+                // have visited
+                auto *defval = const_cast<llvm::Value *>(RD->getValue(def));
+                assert(defval && "Have no value for a node");
+                defnode = findNode(use.first->getDG(), defval);
+                if (!defnode) {
+                    llvmutils::printerr("[DU] error: DG doesn't have val: ", defval);
+                    abort();
+                }
+            }
+
+            edges.emplace_back(defnode, use.first);
+        }
     }
 
-    // we will run only once
-    return false;
+    LLVMNode::addDataDependencies(edges);
+}
+
+void LLVMDefUseAnalysis::addDataDependencies(LLVMDataDependenceAnalysis *RD,
+                                             LLVMNode *node) {
+    auto val = node->getValue();
+    auto defs = RD->getLLVMDefinitions(val);
+
+    // add data dependence
+    for (auto def : defs) {
+        LLVMNode *rdnode = findNode(node->getDG(), def);
+        if (!rdnode) {
+            llvmutils::printerr("[DU] error: DG doesn't have val: ", def);
+            abort();
+            return;
+        }
+
+        rdnode->addDataDependence(node);
+    }
 }
 
 } // namespace dg
@@ -22,10 +22,10 @@
 #pragma GCC diagnostic pop
 #endif
 
-#include "dg/legacy/DataFlowAnalysis.h"
 #include "dg/llvm/DataDependence/DataDependence.h"
 
 using dg::dda::LLVMDataDependenceAnalysis;
+using dg::dda::RWNode;
 
 namespace llvm {
     class DataLayout;
@@ -37,24 +37,34 @@ namespace dg {
 class LLVMDependenceGraph;
 class LLVMNode;
 
-class LLVMDefUseAnalysis : public legacy::DataFlowAnalysis<LLVMNode>
+class LLVMDefUseAnalysis
 {
     LLVMDependenceGraph *dg;
     LLVMDataDependenceAnalysis *RD;
     LLVMPointerAnalysis *PTA;
     const llvm::DataLayout *DL;
+    // do not compute data dependencies of reads from memory,
+    // just remember the nodes in their graphs
+    bool lazy;
 
 public:
     LLVMDefUseAnalysis(LLVMDependenceGraph *dg,
                        LLVMDataDependenceAnalysis *rd,
-                       LLVMPointerAnalysis *pta);
+                       LLVMPointerAnalysis *pta,
+                       bool lazy = false);
 
     ~LLVMDefUseAnalysis() { delete DL; }
 
-    /* virtual */
-    bool runOnNode(LLVMNode *node, LLVMNode *prev);
+    // Add the def-use edges to all nodes at once. This goes over the nodes
+    // in the blocks reachable from the entry (also through calls) and emits
+    // the data dependencies of all uses in bulk. The nodes in unreachable
+    // blocks get no def-use edges.
+    void runBatched();
+
+    // add edges from the definitions of the memory read by 'node'
+    static void addDataDependencies(LLVMDataDependenceAnalysis *RD,
+                                    LLVMNode *node);
 private:
-    void addDataDependencies(LLVMNode *node);
 
     void handleLoadInst(llvm::LoadInst *, LLVMNode *);
     void handleCallInst(LLVMNode *);
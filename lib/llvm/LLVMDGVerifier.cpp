@@ -44,9 +44,7 @@ bool LLVMDGVerifier::verify()
 {
     checkMainProc();
 
-    extern std::map<llvm::Value *,
-                    LLVMDependenceGraph *> constructedFunctions;
-    for (auto& it : constructedFunctions)
+    for (auto& it : dg->getConstructedFunctions())
         checkGraph(llvm::cast<llvm::Function>(it.first), it.second);
 
     fflush(stderr);
@@ -59,9 +57,7 @@ void LLVMDGVerifier::checkMainProc()
         fault("has no module set");
 
     // all the subgraphs must have the same global nodes
-    extern std::map<llvm::Value *,
-                    LLVMDependenceGraph *> constructedFunctions;
-    for (auto& it : constructedFunctions) {
+    for (auto& it : dg->getConstructedFunctions()) {
         if (it.second->global_nodes != dg->global_nodes)
             fault("subgraph has different global nodes than main proc");
     }
@@ -6,9 +6,11 @@
  #error "Need CFG enabled for building LLVM Dependence Graph"
 #endif
 
+#include <map>
 #include <utility>
 #include <unordered_map>
 #include <set>
+#include <vector>
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -66,15 +68,6 @@ namespace dg {
 //  -- LLVMDependenceGraph
 /// ------------------------------------------------------------------
 
-// map of all constructed functions
-std::map<llvm::Value *, LLVMDependenceGraph *> constructedFunctions;
-
-const std::map<llvm::Value *,
-               LLVMDependenceGraph *>& getConstructedFunctions()
-{
-    return constructedFunctions;
-}
-
 LLVMDependenceGraph::~LLVMDependenceGraph()
 {
     // delete nodes
@@ -273,7 +266,7 @@ LLVMDependenceGraph::buildSubgraph(LLVMNode *node, llvm::Function *callFunc, boo
 
     // if we don't have this subgraph constructed, construct it
     // else just add call edge
-    LLVMDependenceGraph *&subgraph = constructedFunctions[callFunc];
+    LLVMDependenceGraph *&subgraph = (*constructedFunctions)[callFunc];
     if (!subgraph) {
         // since we have reference the the pointer in
         // constructedFunctions, we can assing to it
@@ -281,8 +274,10 @@ LLVMDependenceGraph::buildSubgraph(LLVMNode *node, llvm::Function *callFunc, boo
         // set global nodes to this one, so that
         // we'll share them
         subgraph->setGlobalNodes(getGlobalNodes());
+        subgraph->constructedFunctions = constructedFunctions;
         subgraph->module = module;
         subgraph->PTA = PTA;
+        subgraph->DDA = DDA;
         subgraph->threads = this->threads;
         // make subgraphs gather the call-sites too
         subgraph->gatherCallsites(gather_callsites, gatheredCallsites);
@@ -700,7 +695,7 @@ bool LLVMDependenceGraph::build(llvm::Function *func)
     if (func->size() == 0)
         return false;
 
-    constructedFunctions.insert(make_pair(func, this));
+    constructedFunctions->emplace(func, this);
 
     // create entry node
     LLVMNode *entry = new LLVMNode(func);
@@ -926,7 +921,7 @@ bool LLVMDependenceGraph::getCallSites(const char *name, std::set<LLVMNode *> *c
 bool LLVMDependenceGraph::getCallSites(const char *names[],
                                        std::set<LLVMNode *> *callsites)
 {
-    for (auto& F : constructedFunctions) {
+    for (auto& F : *constructedFunctions) {
         for (auto& I : F.second->getBlocks()) {
             LLVMBBlock *BB = I.second;
             for (LLVMNode *n : BB->getNodes()) {
@@ -944,7 +939,7 @@ bool LLVMDependenceGraph::getCallSites(const char *names[],
 bool LLVMDependenceGraph::getCallSites(const std::vector<std::string>& names,
                                        std::set<LLVMNode *> *callsites)
 {
-    for (const auto& F : constructedFunctions) {
+    for (const auto& F : *constructedFunctions) {
         for (const auto& I : F.second->getBlocks()) {
             LLVMBBlock *BB = I.second;
             for (LLVMNode *n : BB->getNodes()) {
@@ -959,9 +954,9 @@ bool LLVMDependenceGraph::getCallSites(const std::vector<std::string>& names,
     return callsites->size() != 0;
 }
 
-void LLVMDependenceGraph::computeNonTerminationControlDependencies() {
+void LLVMDependenceGraph::computeNonTerminationControlDependencies(const LLVMControlDependenceAnalysisOptions& opts) {
     DBG_SECTION_BEGIN(llvmdg, "Computing NTSCD");
-    llvmdg::NTSCD ntscdAnalysis(this->module, {}, PTA);
+    llvmdg::NTSCD ntscdAnalysis(this->module, opts, PTA);
     ntscdAnalysis.computeDependencies();
     auto& dependencies = ntscdAnalysis.controlDependencies();
 
@@ -972,23 +967,49 @@ void LLVMDependenceGraph::computeNonTerminationControlDependencies() {
 
         auto lastInstruction = findInstruction(castToLLVMInstruction(dep.first->lastInstruction()),
                                                getConstructedFunctions());
+        // the dependencies can be added between basic blocks only if the
+        // block ends with a branching of its basic block (the blocks
+        // split at calls and the blocks that depend on a call that may
+        // not return keep the edges between instructions)
+        LLVMBBlock *lastBlock = nullptr;
+        if (opts.blockEdgesCD() && lastInstruction &&
+            dep.first->lastInstruction() == dep.first->llvmBlock()->getTerminator()) {
+            lastBlock = lastInstruction->getBBlock();
+            if (lastBlock && lastBlock->successorsNum() < 2)
+                lastBlock = nullptr;
+        }
+
         for (const auto dependant : dep.second) {
-            for (const auto instruction : dependant->llvmInstructions()) {
-                auto dgInstruction = findInstruction(castToLLVMInstruction(instruction), getConstructedFunctions());
-                if (lastInstruction && dgInstruction) {
-                    lastInstruction->addControlDependence(dgInstruction);
-                } else {
-                    static std::set<std::pair<LLVMNode *, LLVMNode *>> reported;
-                    if (reported.insert({lastInstruction, dgInstruction}).second) {
-                        llvm::errs() << "[CD] error: CD could not be set up, some instruction was not found:\n";
-                        if (lastInstruction)
-                            llvm::errs() << "[CD] last instruction: " << *lastInstruction->getValue() << "\n";
-                        else
-                            llvm::errs() << "[CD] No last instruction\n";
-                        if (dgInstruction)
-                            llvm::errs() << "[CD] current instruction: " << *dgInstruction->getValue() << "\n";
-                        else
-                            llvm::errs() << "[CD] No current instruction\n";
+            // all the parts of a basic block split at calls have the same
+            // dependencies, so we can add the dependence to the whole block
+            LLVMBBlock *dependantBlock = nullptr;
+            if (lastBlock && !dependant->llvmInstructions().empty()) {
+                auto first = findInstruction(castToLLVMInstruction(dependant->llvmInstructions().front()),
+                                             getConstructedFunctions());
+                if (first)
+                    dependantBlock = first->getBBlock();
+            }
+
+            if (dependantBlock) {
+                lastBlock->addControlDependence(dependantBlock);
+            } else {
+                for (const auto instruction : dependant->llvmInstructions()) {
+                    auto dgInstruction = findInstruction(castToLLVMInstruction(instruction), getConstructedFunctions());
+                    if (lastInstruction && dgInstruction) {
+                        lastInstruction->addControlDependence(dgInstruction);
+                    } else {
+                        static thread_local std::set<std::pair<LLVMNode *, LLVMNode *>> reported;
+                        if (reported.insert({lastInstruction, dgInstruction}).second) {
+                            llvm::errs() << "[CD] error: CD could not be set up, some instruction was not found:\n";
+                            if (lastInstruction)
+                                llvm::errs() << "[CD] last instruction: " << *lastInstruction->getValue() << "\n";
+                            else
+                                llvm::errs() << "[CD] No last instruction\n";
+                            if (dgInstruction)
+                                llvm::errs() << "[CD] current instruction: " << *dgInstruction->getValue() << "\n";
+                            else
+                                llvm::errs() << "[CD] No current instruction\n";
+                        }
                     }
                 }
             }
@@ -1015,17 +1036,27 @@ void LLVMDependenceGraph::computeInterferenceDependentEdges(ControlFlowGraph * c
     auto regions = controlFlowGraph->threadRegions();
     MayHappenInParallel mayHappenInParallel(regions);
 
-    for (const auto &currentRegion : regions) {
-        auto llvmValuesForCurrentRegion     = currentRegion->llvmInstructions();
-        auto currentRegionLoads             = getLoadInstructions(llvmValuesForCurrentRegion);
-        auto currentRegionStores            = getStoreInstructions(llvmValuesForCurrentRegion);
-        auto parallelRegions                = mayHappenInParallel.parallelRegions(currentRegion);
-        for (const auto &parallelRegion : parallelRegions) {
-            auto llvmInstructionsForParallelRegion      = parallelRegion->llvmInstructions();
-            auto parallelRegionLoads                    = getLoadInstructions(llvmInstructionsForParallelRegion);
-            auto parallelRegionStores                   = getStoreInstructions(llvmInstructionsForParallelRegion);
-                computeInterferenceDependentEdges(currentRegionLoads, parallelRegionStores);
-                computeInterferenceDependentEdges(parallelRegionLoads, currentRegionStores);
+    // the loads and stores of the regions, the pairs of regions
+    // are then handled only once (the relation is symmetric)
+    std::map<ThreadRegion *, InterferenceAccesses> accesses;
+    for (const auto &region : regions)
+        getInterferenceAccesses(region->llvmInstructions(), accesses[region]);
+
+    // The data dependence analysis does not follow the forks and joins,
+    // so we must compare also the regions of different threads that are
+    // ordered by them (e.g., the code after a join with the joined thread).
+    // Only the regions of the same threads that cannot run in parallel are
+    // left to the data dependence analysis.
+    for (auto currentIt = regions.begin(); currentIt != regions.end(); ++currentIt) {
+        const auto& current = accesses[*currentIt];
+        for (auto otherIt = currentIt; otherIt != regions.end(); ++otherIt) {
+            if (!mayHappenInParallel.mayHappenInParallel(*currentIt, *otherIt) &&
+                mayHappenInParallel.inSameThreads(*currentIt, *otherIt))
+                continue;
+            const auto& other = accesses[*otherIt];
+            computeInterferenceDependentEdges(current, other);
+            if (otherIt != currentIt)
+                computeInterferenceDependentEdges(other, current);
         }
     }
 }
@@ -1033,9 +1064,9 @@ void LLVMDependenceGraph::computeInterferenceDependentEdges(ControlFlowGraph * c
 void LLVMDependenceGraph::computeForkJoinDependencies(ControlFlowGraph *controlFlowGraph) {
     auto joins = controlFlowGraph->getJoins();
     for (const auto &join : joins) {
-        auto joinNode = findInstruction(castToLLVMInstruction(join), constructedFunctions);
+        auto joinNode = findInstruction(castToLLVMInstruction(join), *constructedFunctions);
         for (const auto &fork : controlFlowGraph->getCorrespondingForks(join)) {
-            auto forkNode = findInstruction(castToLLVMInstruction(fork), constructedFunctions);
+            auto forkNode = findInstruction(castToLLVMInstruction(fork), *constructedFunctions);
             joinNode->addControlDependence(forkNode);
         }
     }
@@ -1045,11 +1076,11 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
     auto locks = controlFlowGraph->getLocks();
     for (auto lock : locks) {
         auto callLockInst = castToLLVMInstruction(lock);
-        auto lockNode = findInstruction(callLockInst, constructedFunctions);
+        auto lockNode = findInstruction(callLockInst, *constructedFunctions);
         auto correspondingNodes = controlFlowGraph->getCorrespondingCriticalSection(lock);
         for (auto correspondingNode : correspondingNodes) {
             auto node = castToLLVMInstruction(correspondingNode);
-            auto dependentNode = findInstruction(node, constructedFunctions);
+            auto dependentNode = findInstruction(node, *constructedFunctions);
             if (dependentNode) {
                 lockNode->addControlDependence(dependentNode);
             } else {
@@ -1063,7 +1094,7 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
         auto correspondingUnlocks = controlFlowGraph->getCorrespongingUnlocks(lock);
         for (auto unlock : correspondingUnlocks) {
             auto node = castToLLVMInstruction(unlock);
-            auto unlockNode = findInstruction(node, constructedFunctions);
+            auto unlockNode = findInstruction(node, *constructedFunctions);
             if (unlockNode) {
                 unlockNode->addControlDependence(lockNode);
             }
@@ -1071,44 +1102,98 @@ void LLVMDependenceGraph::computeCriticalSections(ControlFlowGraph *controlFlowG
     }
 }
 
-void LLVMDependenceGraph::computeInterferenceDependentEdges(const std::set<const llvm::Instruction *> &loads,
-                                                            const std::set<const llvm::Instruction *> &stores) {
+struct LLVMDependenceGraph::InterferenceAccesses {
+    struct Load {
+        LLVMNode *node;
+        std::vector<LLVMPointer> pointers;
+        bool unknown;
+    };
+
+    // the stores that write to a memory object
+    struct Object {
+        std::unordered_map<Offset::type, std::vector<LLVMNode *>> offsets;
+        std::vector<LLVMNode *> unknownOffset;
+        std::vector<LLVMNode *> all;
+    };
+
+    std::vector<Load> loads;
+    std::unordered_map<const llvm::Value *, Object> objects;
+    // the stores through unknown pointers
+    std::vector<LLVMNode *> unknownStores;
+    std::vector<LLVMNode *> stores;
+};
 
-    for (const auto &load :loads) {
-        auto *loadInst = const_cast<llvm::Instruction *>(load);
-        auto loadFunction = constructedFunctions.find(const_cast<llvm::Function *>(load->getParent()->getParent()));
-        if (loadFunction == constructedFunctions.end())
-            continue;
-        auto loadNode = loadFunction->second->findNode(loadInst);
+void LLVMDependenceGraph::getInterferenceAccesses(const std::set<const llvm::Instruction *> &llvmInstructions,
+                                                  InterferenceAccesses &accesses) const {
+    auto getNode = [this](const llvm::Instruction *inst) -> LLVMNode * {
+        auto function = constructedFunctions->find(const_cast<llvm::Function *>(inst->getParent()->getParent()));
+        if (function == constructedFunctions->end())
+            return nullptr;
+        return function->second->findNode(const_cast<llvm::Instruction *>(inst));
+    };
+
+    for (const auto &load : getLoadInstructions(llvmInstructions)) {
+        auto loadNode = getNode(load);
         if (!loadNode)
             continue;
 
-        for (const auto &store : stores) {
-            auto *storeInst = const_cast<llvm::Instruction *>(store);
-            auto storeFunction = constructedFunctions.find(const_cast<llvm::Function *>(store->getParent()->getParent()));
-            if (storeFunction == constructedFunctions.end())
-                continue;
-            auto storeNode = storeFunction->second->findNode(storeInst);
-            if (!storeNode)
-                continue;
+        auto loadPts = PTA->getLLVMPointsTo(load->getOperand(0));
+        accesses.loads.push_back({loadNode, {}, loadPts.hasUnknown()});
+        for (const auto& pointer : loadPts)
+            accesses.loads.back().pointers.push_back(pointer);
+    }
 
-            auto loadPts = PTA->getLLVMPointsTo(load->getOperand(0));
-            auto storePts = PTA->getLLVMPointsTo(store->getOperand(1));
-            for (const auto& pointerLoad : loadPts) {
-                for (const auto& pointerStore : storePts) {
-                    if (pointerLoad.value == pointerStore.value &&
-                        (pointerLoad.offset.isUnknown()  ||
-                         pointerStore.offset.isUnknown() ||
-                         pointerLoad.offset == pointerStore.offset)) {
+    for (const auto &store : getStoreInstructions(llvmInstructions)) {
+        auto storeNode = getNode(store);
+        if (!storeNode)
+            continue;
 
-                        storeNode->addInterferenceDependence(loadNode);
-                    }
-                }
+        accesses.stores.push_back(storeNode);
+        auto storePts = PTA->getLLVMPointsTo(store->getOperand(1));
+        if (storePts.hasUnknown())
+            accesses.unknownStores.push_back(storeNode);
+        for (const auto& pointer : storePts) {
+            auto& object = accesses.objects[pointer.value];
+            if (pointer.offset.isUnknown())
+                object.unknownOffset.push_back(storeNode);
+            else
+                object.offsets[*pointer.offset].push_back(storeNode);
+            // the pointers to the same object are next to each other
+            if (object.all.empty() || object.all.back() != storeNode)
+                object.all.push_back(storeNode);
+        }
+    }
+}
+
+void LLVMDependenceGraph::computeInterferenceDependentEdges(const InterferenceAccesses &loadsRegion,
+                                                            const InterferenceAccesses &storesRegion) {
+    auto addEdges = [](const std::vector<LLVMNode *>& stores, LLVMNode *loadNode) {
+        for (auto *storeNode : stores)
+            storeNode->addInterferenceDependence(loadNode);
+    };
+
+    for (const auto &load : loadsRegion.loads) {
+        // a load from an unknown pointer may read what any store writes
+        if (load.unknown) {
+            addEdges(storesRegion.stores, load.node);
+            continue;
+        }
+
+        addEdges(storesRegion.unknownStores, load.node);
+        for (const auto& pointer : load.pointers) {
+            auto object = storesRegion.objects.find(pointer.value);
+            if (object == storesRegion.objects.end())
+                continue;
+
+            if (pointer.offset.isUnknown()) {
+                addEdges(object->second.all, load.node);
+                continue;
             }
 
-            // handle the unknown pointer
-            if (loadPts.hasUnknown() || storePts.hasUnknown())
-                storeNode->addInterferenceDependence(loadNode);
+            addEdges(object->second.unknownOffset, load.node);
+            auto offset = object->second.offsets.find(*pointer.offset);
+            if (offset != object->second.offsets.end())
+                addEdges(offset->second, load.node);
         }
     }
 }
@@ -1190,12 +1275,18 @@ void LLVMDependenceGraph::addNoreturnDependencies()
     }
 }
 
-void LLVMDependenceGraph::addDefUseEdges() {
-    LLVMDefUseAnalysis DUA(this, DDA, PTA);
-    DUA.run();
+void LLVMDependenceGraph::addDefUseEdges(bool lazy) {
+    LLVMDefUseAnalysis DUA(this, DDA, PTA, lazy);
+    DUA.runBatched();
+}
+
+void LLVMDependenceGraph::materializeDataDependencies(LLVMNode *node) {
+    assert(node->getDG() == this && "The node is not from this graph");
+    if (lazyDataDependencies.erase(node) > 0)
+        LLVMDefUseAnalysis::addDataDependencies(DDA, node);
 }
 
-LLVMNode *findInstruction(llvm::Instruction * instruction, const std::map<llvm::Value *, LLVMDependenceGraph *> & constructedFunctions) {
+LLVMNode *findInstruction(llvm::Instruction * instruction, const LLVMConstructedFunctions& constructedFunctions) {
     auto valueKey = constructedFunctions.find(instruction->getParent()->getParent());
     if (valueKey != constructedFunctions.end()) {
         return valueKey->second->findNode(instruction);
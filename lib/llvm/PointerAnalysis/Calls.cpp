@@ -91,7 +91,7 @@ LLVMPointerGraphBuilder::createUnknownCall(const llvm::CallInst *CInst) {
     call->setPairedNode(call);
 
     // the only thing that the node will point at
-    call->addPointsTo(UnknownPointer);
+    call->addPointsTo(PS.getUnknownPointer());
 
     return addNode(CInst, call);
 }
@@ -126,11 +126,11 @@ LLVMPointerGraphBuilder::PSNodesSeq&
 LLVMPointerGraphBuilder::createMemSet(const llvm::Instruction *Inst) {
     PSNode *val;
     if (llvmutils::memsetIsZeroInitialization(llvm::cast<llvm::IntrinsicInst>(Inst)))
-        val = NULLPTR;
+        val = PS.getNull();
     else
         // if the memset is not 0-initialized, it does some
         // garbage into the pointer
-        val = UNKNOWN_MEMORY;
+        val = PS.getUnknownMemory();
 
     PSNode *op = getOperand(Inst->getOperand(0)->stripInBoundsOffsets());
     // we need to make unknown offsets
@@ -227,13 +227,13 @@ LLVMPointerGraphBuilder::createAsm(const llvm::Instruction *Inst) {
     // we are here, then we got here because this
     // is undefined call that returns pointer.
     // In this case return an unknown pointer
-    static bool warned = false;
+    static thread_local bool warned = false;
     if (!warned) {
         llvm::errs() << "PTA: Inline assembly found, analysis  may be unsound\n";
         warned = true;
     }
 
-    PSNode *n = PS.create(PSNodeType::CONSTANT, UNKNOWN_MEMORY, Offset::UNKNOWN);
+    PSNode *n = PS.create(PSNodeType::CONSTANT, PS.getUnknownMemory(), Offset::UNKNOWN);
     // it is call that returns pointer, so we'd like to have
     // a 'return' node that contains that pointer
     n->setPairedNode(n);
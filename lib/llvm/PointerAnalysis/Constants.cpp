@@ -4,8 +4,6 @@
 namespace dg {
 namespace pta {
 
-extern const Pointer UnknownPointer;
-
 Pointer LLVMPointerGraphBuilder::handleConstantPtrToInt(const llvm::PtrToIntInst *P2I)
 {
     using namespace llvm;
@@ -26,7 +24,7 @@ Pointer LLVMPointerGraphBuilder::handleConstantIntToPtr(const llvm::IntToPtrInst
     const Value *llvmOp = I2P->getOperand(0);
     if (isa<ConstantInt>(llvmOp)) {
         llvm::errs() << "IntToPtr with constant: " << *I2P << "\n";
-        return UnknownPointer;
+        return PS.getUnknownPointer();
     }
 
     // (possibly recursively) get the operand of this bit-cast
@@ -112,7 +110,7 @@ Pointer LLVMPointerGraphBuilder::handleConstantBitCast(const llvm::BitCastInst *
         errs() << "WARN: Not a loss less cast unhandled ConstExpr"
                << *BC << "\n";
         abort();
-        return UnknownPointer;
+        return PS.getUnknownPointer();
     }
 
     const Value *llvmOp = BC->stripPointerCasts();
@@ -129,7 +127,7 @@ Pointer LLVMPointerGraphBuilder::handleConstantGep(const llvm::GetElementPtrInst
     using namespace llvm;
 
     const Value *op = GEP->getPointerOperand();
-    Pointer pointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
+    Pointer pointer = PS.getUnknownPointer();
 
     // get operand PSNode (this may result in recursive call,
     // if this gep is recursively defined)
@@ -157,7 +155,7 @@ Pointer LLVMPointerGraphBuilder::getConstantExprPointer(const llvm::ConstantExpr
 {
     using namespace llvm;
 
-    Pointer pointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
+    Pointer pointer = PS.getUnknownPointer();
     Instruction *Inst = const_cast<ConstantExpr*>(CE)->getAsInstruction();
 
     switch(Inst->getOpcode()) {
@@ -187,7 +185,7 @@ Pointer LLVMPointerGraphBuilder::getConstantExprPointer(const llvm::ConstantExpr
         case Instruction::Shl:
         case Instruction::LShr:
         case Instruction::AShr:
-            pointer = UnknownPointer;
+            pointer = PS.getUnknownPointer();
             break;
         case Instruction::Sub:
         case Instruction::Mul:
@@ -222,7 +220,7 @@ LLVMPointerGraphBuilder::createUnknown(const llvm::Value *val) {
     // completely change the value of pointer...
 
     // FIXME: or there's enough unknown offset? Check it out!
-    PSNode *node = PS.create(PSNodeType::CONSTANT, UNKNOWN_MEMORY, Offset::UNKNOWN);
+    PSNode *node = PS.create(PSNodeType::CONSTANT, PS.getUnknownMemory(), Offset::UNKNOWN);
     assert(node);
 
     return addNode(val, node);
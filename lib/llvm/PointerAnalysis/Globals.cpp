@@ -84,7 +84,7 @@ LLVMPointerGraphBuilder::handleGlobalVariableInitializer(const llvm::Constant *C
     } else if (isa<UndefValue>(C)) {
         // undef value means unknown memory
         PSNode *target = PS.createGlobal(PSNodeType::CONSTANT, node, offset);
-        PS.createGlobal(PSNodeType::STORE, UNKNOWN_MEMORY, target);
+        PS.createGlobal(PSNodeType::STORE, PS.getUnknownMemory(), target);
     } else if (!isa<ConstantInt>(C) && !isa<ConstantFP>(C)) {
         llvm::errs() << *C << "\n";
         llvm::errs() << "ERROR: ^^^ global variable initializer not handled\n";
@@ -130,7 +130,7 @@ void LLVMPointerGraphBuilder::buildGlobals()
         } else {
             // without initializer we can not do anything else than
             // assume that it can point everywhere
-            PS.createGlobal(PSNodeType::STORE, UNKNOWN_MEMORY, node);
+            PS.createGlobal(PSNodeType::STORE, PS.getUnknownMemory(), node);
         }
     }
 }
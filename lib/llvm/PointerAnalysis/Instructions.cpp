@@ -192,7 +192,7 @@ LLVMPointerGraphBuilder::createIntToPtr(const llvm::Instruction *Inst) {
                      << *Inst << "\n";
         // if this is inttoptr with constant, just make the pointer
         // unknown
-        op1 = UNKNOWN_MEMORY;
+        op1 = PS.getUnknownMemory();
     } else
         op1 = getOperand(op);
 
@@ -298,7 +298,7 @@ LLVMPointerGraphBuilder::createReturn(const llvm::Instruction *Inst) {
             if (!op1) {
                 llvm::errs() << "WARN: Unsupported return of an aggregate type\n";
                 llvm::errs() << *Inst << "\n";
-                op1 = UNKNOWN_MEMORY;
+                op1 = PS.getUnknownMemory();
             }
         } else if (retVal->getType()->isVectorTy()) {
             op1 = getOperand(retVal);
@@ -307,13 +307,13 @@ LLVMPointerGraphBuilder::createReturn(const llvm::Instruction *Inst) {
             } else {
                 llvm::errs() << "WARN: Unsupported return of a vector\n";
                 llvm::errs() << *Inst << "\n";
-                op1 = UNKNOWN_MEMORY;
+                op1 = PS.getUnknownMemory();
             }
         }
 
         if (llvm::isa<llvm::ConstantPointerNull>(retVal)
             || llvmutils::isConstantZero(retVal))
-            op1 = NULLPTR;
+            op1 = PS.getNull();
         else if (llvmutils::typeCanBePointer(&M->getDataLayout(), retVal->getType()) &&
                   (!isInvalid(retVal->stripPointerCasts(), invalidate_nodes) ||
                    llvm::isa<llvm::ConstantExpr>(retVal) ||
@@ -52,9 +52,9 @@ PSNode *LLVMPointerGraphBuilder::getConstant(const llvm::Value *val)
 {
     if (llvm::isa<llvm::ConstantPointerNull>(val)
         || llvmutils::isConstantZero(val)) {
-        return NULLPTR;
+        return PS.getNull();
     } else if (llvm::isa<llvm::UndefValue>(val)) {
-        return UNKNOWN_MEMORY;
+        return PS.getUnknownMemory();
     } else if (const llvm::ConstantExpr *CE
                     = llvm::dyn_cast<llvm::ConstantExpr>(val)) {
         return createConstantExpr(CE).getRepresentant();
@@ -64,7 +64,7 @@ PSNode *LLVMPointerGraphBuilder::getConstant(const llvm::Value *val)
         return ret;
     } else if (llvm::isa<llvm::Constant>(val)) {
         // it is just some constant that we can not handle
-        return UNKNOWN_MEMORY;
+        return PS.getUnknownMemory();
     } else
         return nullptr;
 }
@@ -111,7 +111,7 @@ PSNode *LLVMPointerGraphBuilder::getOperand(const llvm::Value *val)
     PSNode *op = tryGetOperand(val);
     if (!op) {
         if (isInvalid(val, invalidate_nodes))
-            return UNKNOWN_MEMORY;
+            return PS.getUnknownMemory();
 
         llvm::errs() << "ERROR: missing value in graph: " << *val << "\n";
         abort();
@@ -532,7 +532,7 @@ void LLVMPointerGraphBuilder::buildArguments(const llvm::Function& F,
         PSNode *a = tryGetOperand(&*A);
         // we must not have built this argument before
         // (or it is a number or irelevant value)
-        assert(a == nullptr || a == UNKNOWN_MEMORY);
+        assert(a == nullptr || a == PS.getUnknownMemory());
 #endif
         auto& arg = createArgument(&*A);
         arg.getSingleNode()->setParent(parent);
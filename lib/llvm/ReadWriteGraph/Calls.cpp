@@ -112,13 +112,13 @@ RWNode *LLVMReadWriteGraphBuilder::createUnknownCall(const llvm::CallInst *CInst
 
     bool args = false;
     if (_options.undefinedFunsReadAny()) {
-        node->addUse(UNKNOWN_MEMORY);
+        node->addUse(graph.getUnknownMemory());
     } else {
         args |= _options.undefinedFunsReadArgs();
     }
 
     if (_options.undefinedFunsWriteAny()) {
-        node->addDef(UNKNOWN_MEMORY);
+        node->addDef(graph.getUnknownMemory());
     } else {
         args |= _options.undefinedFunsWriteArgs();
     }
@@ -256,13 +256,13 @@ RWNode *LLVMReadWriteGraphBuilder::createIntrinsicCall(const llvm::CallInst *CIn
         if (!target) {
             // keeping such set is faster then printing it all to terminal
             // ... and we don't flood the terminal that way
-            static std::set<const llvm::Value *> warned;
+            static thread_local std::set<const llvm::Value *> warned;
             if (warned.insert(ptr.value).second) {
                 llvm::errs() << "[RD] error at " << ValInfo(CInst) << "\n"
                              << "[RD] error: Haven't created node for: "
                              << ValInfo(ptr.value) << "\n";
             }
-            target = UNKNOWN_MEMORY;
+            target = graph.getUnknownMemory();
         }
 
         // add the definition
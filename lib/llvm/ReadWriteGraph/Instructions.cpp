@@ -206,7 +206,7 @@ LLVMReadWriteGraphBuilder::createCall(const llvm::Instruction *Inst) {
     using namespace llvm;
     const CallInst *CInst = cast<CallInst>(Inst);
     const Value *calledVal = CInst->getCalledValue()->stripPointerCasts();
-    static bool warned_inline_assembly = false;
+    static thread_local bool warned_inline_assembly = false;
 
     if (CInst->isInlineAsm()) {
         if (!warned_inline_assembly) {
@@ -76,7 +76,7 @@ LLVMReadWriteGraphBuilder::mapPointers(const llvm::Value *where,
 
     auto psn = PTA->getLLVMPointsToChecked(val);
     if (!psn.first) {
-        result.push_back(DefSite(UNKNOWN_MEMORY));
+        result.push_back(DefSite(graph.getUnknownMemory()));
 #ifndef NDEBUG
         llvm::errs() << "[RD] warning at: " << ValInfo(where) << "\n";
         llvm::errs() << "No points-to set for: " << ValInfo(val) << "\n";
@@ -99,14 +99,14 @@ LLVMReadWriteGraphBuilder::mapPointers(const llvm::Value *where,
         // (there should be &p and &q)
         // NOTE: maybe this is a bit strong to say unknown memory,
         // but better be sound then incorrect
-        result.push_back(DefSite(UNKNOWN_MEMORY));
+        result.push_back(DefSite(graph.getUnknownMemory()));
         return result;
     }
 
     result.reserve(psn.second.size());
 
     if (psn.second.hasUnknown()) {
-        result.push_back(DefSite(UNKNOWN_MEMORY));
+        result.push_back(DefSite(graph.getUnknownMemory()));
     }
 
     for (const auto& ptr: psn.second) {
@@ -117,7 +117,7 @@ LLVMReadWriteGraphBuilder::mapPointers(const llvm::Value *where,
         if (!ptrNode) {
             // keeping such set is faster then printing it all to terminal
             // ... and we don't flood the terminal that way
-            static std::set<const llvm::Value *> warned;
+            static thread_local std::set<const llvm::Value *> warned;
             if (warned.insert(ptr.value).second) {
                 llvm::errs() << "[RD] error at "  << ValInfo(where) << "\n";
                 llvm::errs() << "[RD] error for " << ValInfo(val) << "\n";
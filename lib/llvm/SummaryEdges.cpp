@@ -1,12 +1,13 @@
-#include <utility>
+#include <cassert>
+#include <cstdint>
 #include <unordered_map>
-#include <set>
+#include <utility>
+#include <vector>
 
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMNode.h"
-//#include "llvm-utils.h"
-
-#include "dg/ADT/Queue.h"
+#include "dg/llvm/LLVMSummaryEdges.h"
+#include "dg/legacy/NodesWalk.h"
 
 namespace dg {
 
@@ -14,141 +15,351 @@ namespace dg {
 //  -- LLVMDependenceGraph -- summary edges
 /// ------------------------------------------------------------------
 
-extern std::map<llvm::Value *, LLVMDependenceGraph *> constructedFunctions;
+///
+// Computation of summary edges as described in
+//
+//  T. Reps, S. Horwitz, M. Sagiv, and G. Rosay. 1994.
+//  Speeding up slicing. SIGSOFT '94.
+//
+// The nodes of every function get a dense numbering and the path edges
+// (the nodes that a formal-out parameter depends on) are kept as a bitset
+// for every formal-out parameter. Every function has its own worklist,
+// so we process one function while its data are at hand. The summaries
+// are found between the formal parameters of a function and then they
+// are copied to all its call-sites.
 class SummaryEdgesComputation {
     using NodeT = LLVMNode;
-    using Edge = std::pair<NodeT *, NodeT *>;
-    ADT::QueueLIFO<Edge> workList;
-    // FIXME: optimize this: we can store only a subset of these edges
-    // and we can store only a set of nodes (beginnings of the paths)
-    std::set<Edge> pathEdge;
-
-    // collected vertices for fast checks
-    std::set<NodeT *> actualOutVertices;
-    std::set<NodeT *> formalInVertices;
-
-    void propagate(const Edge& e) {
-        if (pathEdge.insert(e).second) {
-            workList.push(e);
-        }
+    using NodeInfo = LLVMSummaryEdges::NodeInfo;
+    using Bitset = std::vector<uint64_t>;
+
+    enum : unsigned { NONE = LLVMSummaryEdges::NONE };
+
+    struct CallSite {
+        // the function that contains the call-site
+        unsigned caller;
+        // the actual parameters that correspond to the formal
+        // parameters of the called function (or nullptr)
+        std::vector<NodeT *> actualIns;
+        std::vector<NodeT *> actualOuts;
+    };
+
+    struct Procedure {
+        LLVMDependenceGraph *graph;
+        // local index -> node
+        std::vector<NodeT *> nodes;
+        // local indices of the formal-in (the first is the entry node)
+        // and formal-out (including the exit node) parameters
+        std::vector<unsigned> formalIns;
+        std::vector<unsigned> formalOuts;
+        // the nodes that every formal-out parameter depends on
+        std::vector<Bitset> pathEdges;
+        // nodes whose postponed data dependencies were computed
+        std::vector<bool> prepared;
+        // pairs (node, formal-out) whose edges were not followed yet
+        std::vector<std::pair<unsigned, unsigned>> workList;
+        // indices to 'callSites' of the call-sites of this function
+        std::vector<unsigned> callSites;
+        bool queued{false};
+
+        Procedure(LLVMDependenceGraph *g) : graph(g) {}
+    };
+
+    const LLVMDependenceGraph& dg;
+    LLVMSummaryEdges& result;
+
+    std::vector<Procedure> procedures;
+    std::vector<CallSite> callSites;
+    // functions with a non-empty worklist
+    std::vector<unsigned> queue;
+
+    static bool test(const Bitset& B, unsigned i) {
+        return B[i / 64] & (uint64_t(1) << (i % 64));
     }
 
-    void propagate(NodeT* n1, NodeT *n2) {
-        propagate({n1, n2});
+    // the local index of a node that was added to some function
+    unsigned localOf(const NodeT *n) const {
+        auto *info = result._info(n);
+        assert(info && "The node was not added");
+        return info->local;
     }
 
-    void initialize() {
-        // collect all actual out and formal in vertices,
-        // as we need to check whether a node is of this type
-        for (auto& it : getConstructedFunctions()) {
-            LLVMDependenceGraph *dg = it.second;
-            assert(dg && "null as dg");
-
-            // formal parameters of this dg
-            if (auto params = dg->getParameters()) {
-                for (auto& paramIt : *params) {
-                    // Initialize the worklist (using formal out params).
-                    propagate({paramIt.second.out, paramIt.second.out});
-                    // Gather formal in params.
-                    formalInVertices.insert(paramIt.second.in);
-                }
+    NodeInfo *add(unsigned p, NodeT *n, uint8_t kind) {
+        if (!n)
+            return nullptr;
+
+        // the references to the elements of unordered_map
+        // stay valid when new elements are inserted
+        auto& info = result._nodes[n];
+        info.kind |= kind;
+        if (info.procedure != NONE)
+            return &info;
+
+        auto& P = procedures[p];
+        info.procedure = p;
+        info.local = P.nodes.size();
+        P.nodes.push_back(n);
+        return &info;
+    }
+
+    void addFormal(unsigned p, NodeT *n, bool in) {
+        if (!n)
+            return;
+
+        auto& formals = in ? procedures[p].formalIns
+                           : procedures[p].formalOuts;
+        auto *info = add(p, n, in ? LLVMSummaryEdges::FORMAL_IN
+                                  : LLVMSummaryEdges::FORMAL_OUT);
+        info->formal = formals.size();
+        formals.push_back(info->local);
+    }
 
-                // XXX: what about params for globals?
+    void addNodes(unsigned p) {
+        LLVMDependenceGraph *graph = procedures[p].graph;
+
+        // the entry node must be the first formal-in
+        addFormal(p, graph->getEntry(), true);
+        add(p, graph->getEntry(), LLVMSummaryEdges::ENTRY);
+        if (auto *params = graph->getParameters()) {
+            for (auto& it : *params) {
+                addFormal(p, it.second.in, true);
+                addFormal(p, it.second.out, false);
+            }
+            for (auto I = params->global_begin(), E = params->global_end(); I != E; ++I) {
+                addFormal(p, I->second.in, true);
+                addFormal(p, I->second.out, false);
             }
+            if (auto *vararg = params->getVarArg()) {
+                add(p, vararg->in, 0);
+                add(p, vararg->out, 0);
+            }
+            addFormal(p, params->getNoReturn(), false);
+        }
+        addFormal(p, graph->getExit(), false);
 
-            for (auto callNode : dg->getCallNodes()) {
-                // gather actual-out vertices
-                if (auto params = callNode->getParameters()) {
-                    for (auto& paramIt : *params) {
-                        actualOutVertices.insert(paramIt.second.out);
-                    }
+        for (auto& it : *graph->getNodes()) {
+            NodeT *n = it.second;
+            add(p, n, n->getSubgraphs().empty() ? 0 : LLVMSummaryEdges::ACTUAL);
 
-                    // XXX: what about params for globals?
-                }
+            auto *params = n->getParameters();
+            if (!params)
+                continue;
+
+            for (auto& pit : *params) {
+                add(p, pit.second.in, LLVMSummaryEdges::ACTUAL);
+                add(p, pit.second.out, LLVMSummaryEdges::ACTUAL);
             }
+            for (auto I = params->global_begin(), E = params->global_end(); I != E; ++I) {
+                add(p, I->second.in, LLVMSummaryEdges::ACTUAL);
+                add(p, I->second.out, LLVMSummaryEdges::ACTUAL);
+            }
+            add(p, params->getNoReturn(), LLVMSummaryEdges::ACTUAL);
         }
     }
 
-    bool isActualOut(NodeT *n) const { return actualOutVertices.count(n) > 0; }
-    bool isFormalIn(NodeT *n) const { return formalInVertices.count(n) > 0; }
+    // match the actual parameters of the call node to the formal
+    // parameters of the called function using the edges between them
+    void addCallSite(unsigned caller, NodeT *callNode, unsigned callee) {
+        auto& P = procedures[callee];
+        callSites.emplace_back();
+        auto& C = callSites.back();
+        C.caller = caller;
+        C.actualIns.resize(P.formalIns.size());
+        C.actualOuts.resize(P.formalOuts.size());
+
+        // the formal parameter of the called function or nullptr
+        auto formal = [this, callee](NodeT *n, uint8_t kind) -> const NodeInfo * {
+            auto *info = result._info(n);
+            if (info && info->procedure == callee && (info->kind & kind))
+                return info;
+            return nullptr;
+        };
+
+        auto matchIn = [&](NodeT *act) {
+            if (!act)
+                return;
+            for (auto I = act->data_begin(), E = act->data_end(); I != E; ++I) {
+                if (auto *info = formal(*I, LLVMSummaryEdges::FORMAL_IN))
+                    C.actualIns[info->formal] = act;
+            }
+        };
+
+        auto matchOut = [&](NodeT *act) {
+            if (!act)
+                return;
+            for (auto I = act->rev_data_begin(), E = act->rev_data_end(); I != E; ++I) {
+                if (auto *info = formal(*I, LLVMSummaryEdges::FORMAL_OUT))
+                    C.actualOuts[info->formal] = act;
+            }
+            // the noreturn nodes are connected with control dependence
+            for (auto I = act->rev_control_begin(), E = act->rev_control_end(); I != E; ++I) {
+                if (auto *info = formal(*I, LLVMSummaryEdges::FORMAL_OUT))
+                    C.actualOuts[info->formal] = act;
+            }
+        };
 
-    void handleActualOut(const Edge& e) {
-        for (auto I = e.first->rev_control_begin(),
-                  E = e.first->rev_control_end(); I != E; ++I) {
-            propagate(*I, e.second);
+        // the call node stands for the entry node and for the returned value
+        C.actualIns[0] = callNode;
+        matchOut(callNode);
+
+        if (auto *params = callNode->getParameters()) {
+            for (auto& it : *params) {
+                matchIn(it.second.in);
+                matchOut(it.second.out);
+            }
+            for (auto I = params->global_begin(), E = params->global_end(); I != E; ++I) {
+                matchIn(I->second.in);
+                matchOut(I->second.out);
+            }
+            matchOut(params->getNoReturn());
         }
-        for (auto I = e.first->rev_summary_begin(),
-                  E = e.first->rev_summary_end(); I != E; ++I) {
-            propagate(*I, e.second);
+
+        P.callSites.push_back(callSites.size() - 1);
+    }
+
+    void propagate(unsigned p, unsigned n, unsigned fo) {
+        auto& P = procedures[p];
+        auto& word = P.pathEdges[fo][n / 64];
+        uint64_t bit = uint64_t(1) << (n % 64);
+        if (word & bit)
+            return;
+
+        word |= bit;
+        P.workList.emplace_back(n, fo);
+        if (!P.queued) {
+            P.queued = true;
+            queue.push_back(p);
         }
     }
 
-    void handleGenericEdge(const Edge& e) {
-        for (auto I = e.first->rev_control_begin(),
-                  E = e.first->rev_control_end(); I != E; ++I) {
-            propagate(*I, e.second);
+    // formal-out 'fo' of the function 'p' depends on the formal-in 'fi',
+    // add the summary edges to all call-sites
+    void addSummary(unsigned p, unsigned fi, unsigned fo) {
+        for (unsigned cs : procedures[p].callSites) {
+            auto& C = callSites[cs];
+            NodeT *in = C.actualIns[fi];
+            NodeT *out = C.actualOuts[fo];
+            if (!in || !out || !result.addEdge(in, out))
+                continue;
+
+            // the new edge extends the paths that go through 'out'
+            auto& Q = procedures[C.caller];
+            unsigned inIdx = localOf(in);
+            unsigned outIdx = localOf(out);
+            for (unsigned i = 0; i < Q.formalOuts.size(); ++i) {
+                if (test(Q.pathEdges[i], outIdx))
+                    propagate(C.caller, inIdx, i);
+            }
         }
-        for (auto I = e.first->rev_data_begin(),
-                  E = e.first->rev_data_end(); I != E; ++I) {
-            propagate(*I, e.second);
+    }
+
+    void process(unsigned p, unsigned n, unsigned fo) {
+        auto& P = procedures[p];
+        NodeT *node = P.nodes[n];
+
+        if (!P.prepared[n]) {
+            P.prepared[n] = true;
+            if (node->getDG() == P.graph)
+                P.graph->materializeDataDependencies(node);
         }
-        for (auto I = e.first->user_begin(),
-                  E = e.first->user_end(); I != E; ++I) {
-            propagate(*I, e.second);
+
+        auto *info = result._info(node);
+        if (info->kind & LLVMSummaryEdges::FORMAL_IN)
+            addSummary(p, info->formal, fo);
+
+        if (info->kind & LLVMSummaryEdges::ACTUAL) {
+            if (auto *sources = result.getSources(node)) {
+                for (NodeT *src : *sources)
+                    propagate(p, localOf(src), fo);
+            }
         }
+
+        // follow the same edges as the backward slicing,
+        // but stay in this function
+        auto follow = [&](NodeT *pred) {
+            auto *predInfo = result._info(pred);
+            if (!predInfo || predInfo->procedure != p ||
+                result.isParameterIn(pred, node) ||
+                result.isParameterOut(pred, node))
+                return;
+            propagate(p, predInfo->local, fo);
+        };
+
+        legacy::forEachWalkedNode(node,
+                                  legacy::NODES_WALK_REV_CD |
+                                  legacy::NODES_WALK_REV_DD |
+                                  legacy::NODES_WALK_USER |
+                                  legacy::NODES_WALK_ID |
+                                  legacy::NODES_WALK_REV_ID,
+                                  follow);
     }
 
-    void handleFormalIn(const Edge& e) {
-        using namespace llvm;
-
-        // the edge 'e' is a summary edge between formal parameters,
-        // we want to map it to actual parameters
-        assert(e.first->getDG());
-        assert(e.second->getDG());
-
-        auto params = LLVMDGFormalParameters::get(e.second->getDG()->getParameters());
-        assert(params);
-        assert(params->formalToActual.find(e.second) != params->formalToActual.end()
-                && "Cannot find formal -> actual parameter mapping");
-        for (auto& it : params->formalToActual[e.second]) {
-            // it = pair of (call-site, actual (out) param)
-            // get the actual in param too }
-            assert(params->formalToActual.find(e.first) != params->formalToActual.end());
-            auto actIn = params->formalToActual[e.first][it.first];
-            assert(actIn && "Do not have actual in param");
-
-            // add summary edge
-            actIn->addSummaryEdge(it.second);
-
-            // XXX: very inefficient
-            for (auto& pe : pathEdge) {
-                if (pe.first == it.second) {
-                    propagate(actIn, pe.second);
+    void initialize() {
+        result._nodes.clear();
+        result._sources.clear();
+        result._edges.clear();
+
+        std::unordered_map<const LLVMDependenceGraph *, unsigned> indices;
+        for (auto& it : dg.getConstructedFunctions()) {
+            indices.emplace(it.second, procedures.size());
+            procedures.emplace_back(it.second);
+        }
+
+        for (unsigned p = 0; p < procedures.size(); ++p)
+            addNodes(p);
+
+        for (unsigned p = 0; p < procedures.size(); ++p) {
+            for (NodeT *n : procedures[p].nodes) {
+                for (auto *subgraph : n->getSubgraphs()) {
+                    auto it = indices.find(subgraph);
+                    if (it != indices.end())
+                        addCallSite(p, n, it->second);
                 }
             }
         }
+
+        for (unsigned p = 0; p < procedures.size(); ++p) {
+            auto& P = procedures[p];
+            P.pathEdges.assign(P.formalOuts.size(),
+                               Bitset((P.nodes.size() + 63) / 64));
+            P.prepared.assign(P.nodes.size(), false);
+
+            // every node depends on the entry node (the backward
+            // slicing always keeps it)
+            for (unsigned fo = 0; fo < P.formalOuts.size(); ++fo) {
+                propagate(p, P.formalOuts[fo], fo);
+                propagate(p, P.formalIns[0], fo);
+            }
+        }
     }
 
-   public:
+public:
+    SummaryEdgesComputation(const LLVMDependenceGraph& dg,
+                            LLVMSummaryEdges& result)
+    : dg(dg), result(result) {}
+
     void computeSummaryEdges() {
         initialize();
 
-        while (!workList.empty()) {
-            Edge e = workList.pop();
+        while (!queue.empty()) {
+            unsigned p = queue.back();
+            queue.pop_back();
 
-            if (isActualOut(e.first)) {
-                handleActualOut(e);
-            } else if (isFormalIn(e.first)) {
-                handleFormalIn(e);
-            } else {
-                handleGenericEdge(e);
+            // the worklist of the function may grow while we process
+            // it (recursive calls), it stays queued meanwhile
+            auto& P = procedures[p];
+            while (!P.workList.empty()) {
+                auto e = P.workList.back();
+                P.workList.pop_back();
+                process(p, e.first, e.second);
             }
+            P.queued = false;
         }
     }
 };
 
-void LLVMDependenceGraph::computeSummaryEdges() {
-    SummaryEdgesComputation C;
+void LLVMSummaryEdges::compute(const LLVMDependenceGraph& dg) {
+    SummaryEdgesComputation C(dg, *this);
     C.computeSummaryEdges();
 }
+
 } // namespace dg
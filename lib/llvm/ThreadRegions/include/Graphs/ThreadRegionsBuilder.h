@@ -1,8 +1,8 @@
 #ifndef THREADREGIONBUILDER_H
 #define THREADREGIONBUILDER_H
 
-#include <unordered_map>
 #include <set>
+#include <vector>
 #include <iosfwd>
 
 #include "ThreadRegion.h"
@@ -14,8 +14,12 @@ class ExitNode;
 class ThreadRegionsBuilder
 {
 private:
-    std::unordered_map<Node *, ThreadRegion *> visitedNodeToRegionMap;
-    std::unordered_map<Node *, ThreadRegion *> examinedNodeToRegionMap;
+    // regions of the nodes that are being visited (on the stack of
+    // the search) and of the examined nodes, indexed by the IDs of nodes
+    std::vector<ThreadRegion *> visitedNodeToRegionMap;
+    std::vector<ThreadRegion *> examinedNodeToRegionMap;
+    // the examined nodes in the order in which they were examined
+    std::vector<Node *> examinedNodes;
 
     std::set<ThreadRegion *> threadRegions_;
 public:
@@ -56,6 +60,10 @@ private:
 
     ThreadRegion * regionOfExaminedNode(Node * node) const;
 
+    void setVisited(Node * node, ThreadRegion * region);
+
+    void setExamined(Node * node, ThreadRegion * region);
+
     bool shouldCreateNewRegion(Node * caller, Node * successor) const;
 };
 
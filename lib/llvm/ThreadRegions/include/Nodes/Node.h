@@ -1,6 +1,7 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <atomic>
 #include <set>
 #include <iosfwd>
 #include <string>
@@ -44,7 +45,7 @@ private:
     std::set<Node *>            predecessors_;
     std::set<Node *>            successors_;
 
-    static int lastId;
+    static std::atomic<int> lastId;
 
 public:
     Node(NodeType type, const llvm::Instruction * instruction = nullptr, const llvm::CallInst * callInst = nullptr);
@@ -1,11 +1,13 @@
 #include "ThreadRegionsBuilder.h"
 
+#include <utility>
+
 #include "Nodes.h"
 #include "ThreadRegion.h"
 
-ThreadRegionsBuilder::ThreadRegionsBuilder(std::size_t size):visitedNodeToRegionMap(size),
-    examinedNodeToRegionMap(size)
-{}
+ThreadRegionsBuilder::ThreadRegionsBuilder(std::size_t size) {
+    reserve(size);
+}
 
 ThreadRegionsBuilder::~ThreadRegionsBuilder() {
     clear();
@@ -14,7 +16,7 @@ ThreadRegionsBuilder::~ThreadRegionsBuilder() {
 void ThreadRegionsBuilder::build(Node *node) {
     auto threadRegion = new ThreadRegion(node);
     threadRegions_.insert(threadRegion);
-    this->visitedNodeToRegionMap.emplace(node, threadRegion);
+    setVisited(node, threadRegion);
 
     visit(node);
 //    visitRightNode(node);
@@ -23,8 +25,8 @@ void ThreadRegionsBuilder::build(Node *node) {
 }
 
 void ThreadRegionsBuilder::populateThreadRegions() {
-    for (auto nodeAngRegion : examinedNodeToRegionMap) {
-        nodeAngRegion.second->insertNode(nodeAngRegion.first);
+    for (auto node : examinedNodes) {
+        regionOfExaminedNode(node)->insertNode(node);
     }
 }
 
@@ -41,26 +43,41 @@ bool ThreadRegionsBuilder::examined(Node *node) const {
 }
 
 void ThreadRegionsBuilder::visit(Node *node) {
-    for (auto successor : *node) {
+    // DFS with an explicit stack, every frame remembers
+    // the successor of the node that comes next
+    std::vector<std::pair<Node *, NodeIterator>> stack;
+    stack.emplace_back(node, node->begin());
+
+    while (!stack.empty()) {
+        Node *current = stack.back().first;
+        auto& iterator = stack.back().second;
+
+        if (iterator == current->end()) {
+            setExamined(current, region(current));
+            this->visitedNodeToRegionMap[current->id()] = nullptr;
+            stack.pop_back();
+            continue;
+        }
+
+        Node *successor = *iterator;
+        ++iterator;
         if (visited(successor)) {
             continue;
         } else if (examined(region(successor))) {
-            region(node)->addSuccessor(region(successor));
+            region(current)->addSuccessor(region(successor));
         } else {
             ThreadRegion * successorRegion = nullptr;
-            if (shouldCreateNewRegion(node, successor)) {
+            if (shouldCreateNewRegion(current, successor)) {
                 successorRegion = new ThreadRegion(successor);
                 threadRegions_.insert(successorRegion);
-                region(node)->addSuccessor(successorRegion);
+                region(current)->addSuccessor(successorRegion);
             } else {
-                successorRegion = region(node);
+                successorRegion = region(current);
             }
-            this->visitedNodeToRegionMap.emplace(successor, successorRegion);
-            visit(successor);
+            setVisited(successor, successorRegion);
+            stack.emplace_back(successor, successor->begin());
         }
     }
-    this->examinedNodeToRegionMap.emplace(node, region(node));
-    this->visitedNodeToRegionMap.erase(node);
 }
 
 bool ThreadRegionsBuilder::examined(ThreadRegion *region) const {
@@ -93,17 +110,11 @@ void ThreadRegionsBuilder::printEdges(std::ostream &ostream) const {
 void ThreadRegionsBuilder::reserve(std::size_t size) {
     visitedNodeToRegionMap.reserve(size);
     examinedNodeToRegionMap.reserve(size);
+    examinedNodes.reserve(size);
 }
 
 void ThreadRegionsBuilder::clear() {
-    for (auto iterator : visitedNodeToRegionMap) {
-        delete iterator.second;
-    }
-
-    for (auto iterator : examinedNodeToRegionMap) {
-        delete iterator.second;
-    }
-
+    // the regions of the nodes are also in threadRegions_
     clearComputingData();
 
     for (auto iterator : threadRegions_) {
@@ -120,24 +131,46 @@ std::set<ThreadRegion *> ThreadRegionsBuilder::threadRegions() {
 void ThreadRegionsBuilder::clearComputingData() {
     visitedNodeToRegionMap.clear();
     examinedNodeToRegionMap.clear();
+    examinedNodes.clear();
 }
 
 ThreadRegion *ThreadRegionsBuilder::regionOfVisitedNode(Node *node) const {
-    auto iterator = visitedNodeToRegionMap.find(node);
-    if (iterator != visitedNodeToRegionMap.end()) {
-        return iterator->second;
+    auto id = static_cast<std::size_t>(node->id());
+    if (id < visitedNodeToRegionMap.size()) {
+        return visitedNodeToRegionMap[id];
     }
     return nullptr;
 }
 
 ThreadRegion *ThreadRegionsBuilder::regionOfExaminedNode(Node *node) const {
-    auto iterator = examinedNodeToRegionMap.find(node);
-    if (iterator != visitedNodeToRegionMap.end()) {
-        return iterator->second;
+    auto id = static_cast<std::size_t>(node->id());
+    if (id < examinedNodeToRegionMap.size()) {
+        return examinedNodeToRegionMap[id];
     }
     return nullptr;
 }
 
+void ThreadRegionsBuilder::setVisited(Node *node, ThreadRegion *region) {
+    auto id = static_cast<std::size_t>(node->id());
+    if (id >= visitedNodeToRegionMap.size()) {
+        visitedNodeToRegionMap.resize(id + 1, nullptr);
+    }
+    if (!visitedNodeToRegionMap[id]) {
+        visitedNodeToRegionMap[id] = region;
+    }
+}
+
+void ThreadRegionsBuilder::setExamined(Node *node, ThreadRegion *region) {
+    auto id = static_cast<std::size_t>(node->id());
+    if (id >= examinedNodeToRegionMap.size()) {
+        examinedNodeToRegionMap.resize(id + 1, nullptr);
+    }
+    if (!examinedNodeToRegionMap[id]) {
+        examinedNodeToRegionMap[id] = region;
+        examinedNodes.push_back(node);
+    }
+}
+
 bool ThreadRegionsBuilder::shouldCreateNewRegion(Node *caller, Node *successor) const {
     return caller->getType() == NodeType::EXIT      ||
            caller->getType() == NodeType::FORK      ||
@@ -1,9 +1,187 @@
 #include "MayHappenInParallel.h"
 
+#include <algorithm>
+
+#include "Nodes.h"
+
 using namespace std;
 
-MayHappenInParallel::MayHappenInParallel(set<ThreadRegion *> threadRegions):threadRegions_(move(threadRegions)) {}
+MayHappenInParallel::MayHappenInParallel(set<ThreadRegion *> threadRegions)
+    : threadRegions_(threadRegions.begin(), threadRegions.end()),
+      words_((threadRegions_.size() + 63) / 64),
+      parallel_(threadRegions_.size() * words_, 0),
+      forks_(threadRegions_.size()) {
+    for (size_t i = 0; i < threadRegions_.size(); ++i)
+        index_.emplace(threadRegions_[i], i);
+
+    buildRegionGraph();
+
+    size_t forkIndex = 0;
+    for (auto *region : threadRegions_) {
+        for (auto *node : region->nodes()) {
+            if (auto *fork = castNode<NodeType::FORK>(node))
+                addFork(fork, forkIndex++);
+        }
+    }
+}
+
+void MayHappenInParallel::buildRegionGraph() {
+    for (size_t i = 0; i < threadRegions_.size(); ++i) {
+        for (auto *node : threadRegions_[i]->nodes())
+            nodeToRegion_.emplace(node, i);
+    }
+
+    successors_.resize(threadRegions_.size());
+    forkSuccessors_.resize(threadRegions_.size());
+    joinSuccessors_.resize(threadRegions_.size());
+
+    auto addEdge = [&](vector<size_t>& edges, size_t from, const Node *to) {
+        auto it = nodeToRegion_.find(to);
+        if (it == nodeToRegion_.end())
+            return;
+        // edges inside of a region are not interesting,
+        // but the edges back to its beginning are
+        if (it->second == from && threadRegions_[from]->foundingNode() != to)
+            return;
+        edges.push_back(it->second);
+    };
+
+    for (size_t i = 0; i < threadRegions_.size(); ++i) {
+        for (auto *node : threadRegions_[i]->nodes()) {
+            for (auto *successor : node->successors())
+                addEdge(successors_[i], i, successor);
+            if (auto *fork = castNode<NodeType::FORK>(node)) {
+                for (auto *entry : fork->forkSuccessors())
+                    addEdge(forkSuccessors_[i], i, entry);
+            } else if (auto *exit = castNode<NodeType::EXIT>(node)) {
+                for (auto *join : exit->joinSuccessors())
+                    addEdge(joinSuccessors_[i], i, join);
+            }
+        }
+
+        for (auto *edges : {&successors_[i], &forkSuccessors_[i], &joinSuccessors_[i]}) {
+            sort(edges->begin(), edges->end());
+            edges->erase(unique(edges->begin(), edges->end()), edges->end());
+        }
+    }
+}
+
+MayHappenInParallel::Bits
+MayHappenInParallel::reachable(const vector<size_t>& start, bool followJoins,
+                               const Bits *stop) const {
+    Bits result(words_, 0);
+    vector<size_t> stack;
+
+    auto push = [&](size_t region) {
+        if (testBit(result, region) || (stop && testBit(*stop, region)))
+            return;
+        setBit(result, region);
+        stack.push_back(region);
+    };
+
+    for (auto region : start)
+        push(region);
+
+    while (!stack.empty()) {
+        auto region = stack.back();
+        stack.pop_back();
+        for (auto successor : successors_[region])
+            push(successor);
+        for (auto successor : forkSuccessors_[region])
+            push(successor);
+        if (followJoins) {
+            for (auto successor : joinSuccessors_[region])
+                push(successor);
+        }
+    }
+
+    return result;
+}
+
+void MayHappenInParallel::addFork(const ForkNode *fork, size_t forkIndex) {
+    auto forkRegion = nodeToRegion_.find(fork);
+    if (forkRegion == nodeToRegion_.end())
+        return;
+
+    // the fork ends its region and the joins start new regions,
+    // so the regions founded by these nodes are the whole story
+    auto regionsOf = [this](const Node *node, vector<size_t>& regions) {
+        auto it = nodeToRegion_.find(node);
+        if (it != nodeToRegion_.end() &&
+            threadRegions_[it->second]->foundingNode() == node)
+            regions.push_back(it->second);
+    };
+
+    vector<size_t> threadStart, continuationStart, joins;
+    for (auto *entry : fork->forkSuccessors())
+        regionsOf(entry, threadStart);
+    for (auto *successor : fork->successors())
+        regionsOf(successor, continuationStart);
+    if (threadStart.empty())
+        return;
+
+    // the regions of the forked thread (and of the threads that it forks)
+    auto thread = reachable(threadStart, false);
+
+    // the joins that can join only the forked thread wait for it
+    for (auto *join : fork->correspondingJoins()) {
+        const auto& forks = join->correspondingForks();
+        if (forks.size() == 1 && *forks.begin() == fork)
+            regionsOf(join, joins);
+    }
+    Bits joined(words_, 0);
+    for (auto region : joins)
+        setBit(joined, region);
+
+    auto continuation = reachable(continuationStart, true, &joined);
+    // if the fork can run again before the joins, they may join
+    // the thread of the other run and this one keeps running
+    if (testBit(continuation, forkRegion->second))
+        continuation = reachable(continuationStart, true);
+
+    for (size_t i = 0; i < threadRegions_.size(); ++i) {
+        if (testBit(thread, i)) {
+            forks_[i].push_back(forkIndex);
+            auto *r = row(i);
+            for (size_t w = 0; w < words_; ++w)
+                r[w] |= continuation[w];
+        }
+        if (testBit(continuation, i)) {
+            auto *r = row(i);
+            for (size_t w = 0; w < words_; ++w)
+                r[w] |= thread[w];
+        }
+    }
+}
+
+set<ThreadRegion *> MayHappenInParallel::parallelRegions(ThreadRegion *threadRegion) {
+    auto it = index_.find(threadRegion);
+    if (it == index_.end())
+        return {};
+
+    set<ThreadRegion *> result;
+    const auto *r = row(it->second);
+    for (size_t i = 0; i < threadRegions_.size(); ++i) {
+        if (r[i / 64] & (uint64_t(1) << (i % 64)))
+            result.insert(threadRegions_[i]);
+    }
+    return result;
+}
+
+bool MayHappenInParallel::mayHappenInParallel(const ThreadRegion *first,
+                                              const ThreadRegion *second) const {
+    auto f = index_.find(first);
+    auto s = index_.find(second);
+    if (f == index_.end() || s == index_.end())
+        return false;
+    return row(f->second)[s->second / 64] & (uint64_t(1) << (s->second % 64));
+}
 
-set<ThreadRegion *> MayHappenInParallel::parallelRegions(ThreadRegion *) {
-    return threadRegions_;
+bool MayHappenInParallel::inSameThreads(const ThreadRegion *first,
+                                        const ThreadRegion *second) const {
+    auto f = index_.find(first);
+    auto s = index_.find(second);
+    if (f == index_.end() || s == index_.end())
+        return false;
+    return forks_[f->second] == forks_[s->second];
 }
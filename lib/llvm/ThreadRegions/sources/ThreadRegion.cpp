@@ -3,7 +3,7 @@
 
 #include <iostream>
 
-int ThreadRegion::lastId = 0;
+std::atomic<int> ThreadRegion::lastId{0};
 
 ThreadRegion::ThreadRegion(Node *node):id_(lastId++),
                                        foundingNode_(node)
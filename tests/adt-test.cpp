@@ -1,11 +1,15 @@
 #include <assert.h>
 #include <cstdarg>
 #include <cstdio>
+#include <algorithm>
+#include <vector>
 
 #include "test-runner.h"
 
 #include "dg/ADT/Queue.h"
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/DGContainer.h"
+#include "dg/ADT/HashIndexedMap.h"
 #include "dg/ReadWriteGraph/DefSite.h"
 
 using namespace dg::ADT;
@@ -150,6 +154,104 @@ public:
     }
 };
 
+class TestVectorContainer : public Test
+{
+public:
+    TestVectorContainer() : Test("test vector container")
+    {}
+
+    void test()
+    {
+        DGVectorContainer<int> C;
+        check(C.empty(), "empty container not empty");
+
+        check(C.insert(4), "insert failed");
+        check(C.insert(1), "insert failed");
+        check(C.insert(13), "insert failed");
+        check(!C.insert(4), "inserted a duplicate");
+        check(C.size() == 3, "BUG in size");
+
+        std::vector<int> values = {0, 2, 4, 13, 20};
+        C.insertSorted(values);
+        check(C.size() == 6, "BUG in insertSorted");
+        check(std::is_sorted(C.begin(), C.end()), "values not sorted");
+        check(std::adjacent_find(C.begin(), C.end()) == C.end(),
+              "duplicate values");
+
+        check(C.contains(2) && C.contains(20), "BUG in contains");
+        check(!C.contains(3), "BUG in contains");
+
+        check(C.erase(4) == 1, "BUG in erase");
+        check(C.erase(4) == 0, "BUG in erase");
+        check(!C.contains(4), "erased value still there");
+
+        DGVectorContainer<int> D;
+        D.insert(20);
+        D.insert(1);
+        D.insert(7);
+        C.intersect(D);
+        check(C.size() == 2 && C.contains(1) && C.contains(20),
+              "BUG in intersect");
+
+        D.erase(7);
+        C.compact();
+        check(C == D, "BUG in comparison");
+        check(C.memoryUsage() == 2 * sizeof(int), "BUG in compact");
+    }
+};
+
+class TestHashIndexedMap : public Test
+{
+public:
+    TestHashIndexedMap() : Test("test hash-indexed map")
+    {}
+
+    void test()
+    {
+        HashIndexedMap<int, int> M;
+        check(M.empty(), "empty map not empty");
+        check(M.find(3) == M.end(), "found a value in empty map");
+
+        // insert enough values to rehash the index few times
+        for (int i = 1000; i > 0; --i)
+            check(M.emplace(i * 7, i).second, "insert failed");
+        check(!M.insert({7, 0}).second, "inserted a duplicate");
+        check(M.size() == 1000, "BUG in size");
+
+        int last = 0;
+        bool sorted = true;
+        for (auto& it : M) {
+            sorted &= last < it.first;
+            last = it.first;
+        }
+        check(sorted, "values not iterated in order");
+
+        check(M.find(700) != M.end() && M.find(700)->second == 100,
+              "BUG in find");
+        check(M.count(701) == 0, "BUG in count");
+
+        // erase every other value, the rest must stay in the index
+        for (int i = 1; i <= 1000; i += 2)
+            check(M.erase(i * 7) == 1, "BUG in erase");
+        check(M.erase(7) == 0, "BUG in erase");
+        check(M.size() == 500, "BUG in size after erase");
+
+        bool found = true;
+        for (int i = 1; i <= 1000; ++i)
+            found &= (M.count(i * 7) == 1) == (i % 2 == 0);
+        check(found, "BUG in index after erase");
+
+        M[3] = 5;
+        check(M.find(3)->second == 5 && M.size() == 501,
+              "BUG in operator[]");
+
+        auto C = M;
+        M.clear();
+        check(C.count(3) == 1 && C.count(14) == 1, "BUG in copy");
+        check(M.count(3) == 0 && M.empty(), "BUG in clear");
+    }
+};
+
 }; // namespace tests
 }; // namespace dg
 
@@ -162,6 +264,8 @@ int main()
     Runner.add(new TestFIFO());
     Runner.add(new TestPrioritySet());
     Runner.add(new TestIntervalsHandling());
+    Runner.add(new TestVectorContainer());
+    Runner.add(new TestHashIndexedMap());
 
     return Runner();
 }
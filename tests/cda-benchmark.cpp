@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <malloc.h>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IRReader/IRReader.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
+#include "dg/llvm/ControlDependence/ControlDependence.h"
+#include "../tools/TimeMeasure.h"
+
+///
+// Compare the algorithms for computing control dependencies on generated
+// CFGs of different shapes and sizes and on the given modules. For every
+// input and algorithm, the benchmark prints a CSV line with the time of
+// the computation, the peak of the heap memory allocated during the
+// computation and the number of computed control dependence edges.
+// The computation starts with the LLVM module and ends when all the
+// dependencies are computed, so it includes building the graphs that
+// the algorithms work on (for legacy, the dependence graph without edges,
+// but not the pointer analysis that is needed to build it). The edges
+// are the pairs of a block or an instruction and a block that it depends
+// on, only the edges computed by the control dependence analysis count.
+// The algorithms are:
+//  - scd     standard CD computed by LLVMControlDependenceAnalysis
+//  - ntscd   NTSCD computed by LLVMControlDependenceAnalysis
+//  - ntscd2  NTSCD computed by the ntscd2 algorithm
+//  - legacy  standard CD computed from post-dominators in the legacy DG
+//
+// Usage: cda-benchmark [-a alg1,alg2,...] [-g shape1,shape2,...]
+//                      [-n size1,size2,...] [-s seed] [-r repeat] [file.ll...]
+//
+// The shapes of the generated CFGs are chain, diamonds, irreducible,
+// nested and random, the size is the number of blocks. If some files are
+// given and no shape is, only the files are benchmarked.
+
+using namespace dg;
+using CDAlgorithm = ControlDependenceAnalysisOptions::CDAlgorithm;
+
+// successors of the blocks of a CFG, the block with the index
+// equal to the number of blocks is the exit block
+using Graph = std::vector<std::vector<unsigned>>;
+
+// every block jumps to the next block or to the exit block
+static Graph generateChain(unsigned size)
+{
+    Graph G(size);
+    for (unsigned i = 0; i < size; ++i)
+        G[i] = {i + 1, size};
+    return G;
+}
+
+// a sequence of if-then-else statements
+static Graph generateDiamonds(unsigned size)
+{
+    Graph G(size);
+    for (unsigned i = 0; i < size; ++i) {
+        if (i % 3 == 0)
+            G[i] = {std::min(i + 1, size), std::min(i + 2, size)};
+        else
+            G[i] = {std::min(i - i % 3 + 3, size)};
+    }
+    return G;
+}
+
+// a sequence of loops with two entries: a -> b, c; b <-> c; b, c -> d
+static Graph generateIrreducible(unsigned size)
+{
+    Graph G(size);
+    for (unsigned i = 0; i < size; ++i) {
+        unsigned base = i - i % 4;
+        auto blk = [&](unsigned n) { return std::min(base + n, size); };
+        switch (i % 4) {
+            case 0: G[i] = {blk(1), blk(2)}; break;
+            case 1: G[i] = {blk(2), blk(3)}; break;
+            case 2: G[i] = {blk(1), blk(3)}; break;
+            case 3: G[i] = {blk(4)}; break;
+        }
+    }
+    return G;
+}
+
+// while loops nested into each other: the first half of the blocks
+// are the headers of the loops, the second half are their latches
+// (and if the size is odd, the last block is after the outermost loop)
+static Graph generateNested(unsigned size)
+{
+    Graph G(size);
+    unsigned depth = size / 2;
+    unsigned after = 2 * depth < size ? 2 * depth : size;
+    if (after < size)
+        G[after] = {size};
+
+    // header i enters the loop i + 1 (the innermost header
+    // goes to its latch) or leaves the loop i, that is, jumps
+    // to the latch of the loop i - 1 or after the outermost loop
+    for (unsigned i = 0; i < depth; ++i) {
+        unsigned next = i + 1 < depth ? i + 1 : depth + i;
+        unsigned out = i > 0 ? depth + i - 1 : after;
+        G[i] = {next, out};
+    }
+    // latch of the loop i jumps back to header i
+    for (unsigned i = 0; i < depth; ++i)
+        G[depth + i] = {i};
+    return G;
+}
+
+// every block jumps to the next block and possibly to a random block
+static Graph generateRandom(unsigned size, std::mt19937& gen)
+{
+    Graph G(size);
+    std::uniform_int_distribution<unsigned> target(0, size);
+    std::bernoulli_distribution branch(0.5);
+    for (unsigned i = 0; i < size; ++i) {
+        G[i] = {i + 1};
+        if (branch(gen))
+            G[i].push_back(target(gen));
+    }
+    return G;
+}
+
+static std::unique_ptr<llvm::Module> createModule(llvm::LLVMContext& context,
+                                                  const Graph& G)
+{
+    using namespace llvm;
+
+    std::unique_ptr<Module> M(new Module("cfg", context));
+    auto *I32 = Type::getInt32Ty(context);
+    auto *FT = FunctionType::get(I32, {Type::getInt1Ty(context)}, false);
+    auto *F = Function::Create(FT, Function::ExternalLinkage, "main", M.get());
+    Value *cond = &*F->arg_begin();
+
+    auto *entry = BasicBlock::Create(context, "entry", F);
+    std::vector<BasicBlock *> blocks(G.size() + 1);
+    for (auto& B : blocks)
+        B = BasicBlock::Create(context, "", F);
+
+    BranchInst::Create(blocks[0], entry);
+    for (unsigned i = 0; i < G.size(); ++i) {
+        const auto& succs = G[i];
+        assert(succs.size() == 1 || succs.size() == 2);
+        if (succs.size() == 1 || succs[0] == succs[1])
+            BranchInst::Create(blocks[succs[0]], blocks[i]);
+        else
+            BranchInst::Create(blocks[succs[0]], blocks[succs[1]],
+                               cond, blocks[i]);
+    }
+    ReturnInst::Create(context, ConstantInt::get(I32, 0), blocks.back());
+
+    return M;
+}
+
+// the bytes currently allocated with operator new and their maximum,
+// the analyses run in one thread, so we do not need atomics
+static size_t allocatedBytes = 0;
+static size_t peakBytes = 0;
+
+static void *allocate(std::size_t size) noexcept
+{
+    void *p = std::malloc(size ? size : 1);
+    if (p) {
+        allocatedBytes += malloc_usable_size(p);
+        peakBytes = std::max(peakBytes, allocatedBytes);
+    }
+    return p;
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p)
+        return;
+    allocatedBytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) noexcept
+{
+    operator delete(p);
+}
+
+// measures the peak of the allocated heap memory since start()
+class HeapMeasure {
+    size_t _start{0};
+
+public:
+    void start()
+    {
+        _start = allocatedBytes;
+        peakBytes = allocatedBytes;
+    }
+
+    long peakKB() const { return (peakBytes - _start) / 1024; }
+};
+
+struct Result {
+    double time{0}; // ms
+    long memory{0}; // kB
+    size_t edges{0};
+};
+
+static double msec(dg::debug::TimeMeasure& tm)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(tm.duration()).count() / 1000.0;
+}
+
+static Result runCDA(llvm::Module *M, CDAlgorithm algorithm)
+{
+    LLVMControlDependenceAnalysisOptions opts;
+    opts.algorithm = algorithm;
+    opts.interprocedural = false;
+
+    Result res;
+    dg::debug::TimeMeasure tm;
+    HeapMeasure heap;
+    heap.start();
+    tm.start();
+
+    LLVMControlDependenceAnalysis cda(M, opts);
+    cda.run();
+    // the analyses may compute the dependencies on demand,
+    // so query all of them
+    for (auto& F : *M) {
+        for (auto& B : F) {
+            res.edges += cda.getDependencies(&B).size();
+            for (auto& I : B)
+                res.edges += cda.getDependencies(&I).size();
+        }
+    }
+
+    tm.stop();
+    res.time = msec(tm);
+    res.memory = heap.peakKB();
+    return res;
+}
+
+// the number of control dependence edges in the graph
+static size_t controlEdgesNum(LLVMDependenceGraph *dg)
+{
+    size_t num = 0;
+    for (auto& it : dg->getConstructedFunctions()) {
+        for (auto& bit : it.second->getBlocks()) {
+            auto *B = bit.second;
+            num += B->controlDependence().size();
+            for (auto *node : B->getNodes())
+                num += node->getControlDependenciesNum();
+        }
+    }
+    return num;
+}
+
+static Result runLegacy(llvm::Module *M)
+{
+    LLVMControlDependenceAnalysisOptions opts;
+    opts.interprocedural = false;
+
+    // the pointer analysis is needed to build the graph,
+    // but it is not a part of the measurement
+    DGLLVMPointerAnalysis PTA(M);
+    PTA.run();
+
+    Result res;
+    dg::debug::TimeMeasure tm;
+    HeapMeasure heap;
+    heap.start();
+    tm.start();
+
+    std::unique_ptr<LLVMDependenceGraph> dg(new LLVMDependenceGraph());
+    dg->build(M, &PTA, nullptr, M->getFunction("main"));
+    // building the graph adds some control dependencies
+    // (e.g., to the unified exit node), do not count them
+    size_t built = controlEdgesNum(dg.get());
+    dg->computeControlDependencies(opts);
+
+    tm.stop();
+    res.time = msec(tm);
+    res.memory = heap.peakKB();
+    res.edges = controlEdgesNum(dg.get()) - built;
+    return res;
+}
+
+static bool runAlgorithm(llvm::Module *M, const std::string& alg,
+                         const std::string& input, size_t blocks,
+                         unsigned repeat)
+{
+    Result total;
+    for (unsigned i = 0; i < repeat; ++i) {
+        Result res;
+        if (alg == "scd")
+            res = runCDA(M, CDAlgorithm::STANDARD);
+        else if (alg == "ntscd")
+            res = runCDA(M, CDAlgorithm::NTSCD);
+        else if (alg == "ntscd2")
+            res = runCDA(M, CDAlgorithm::NTSCD2);
+        else if (alg == "legacy") {
+            if (!M->getFunction("main")) {
+                std::cerr << input << ": no main function, skipping legacy\n";
+                return true;
+            }
+            res = runLegacy(M);
+        } else {
+            std::cerr << "Unknown algorithm: " << alg << "\n";
+            return false;
+        }
+
+        total.time += res.time;
+        total.memory = std::max(total.memory, res.memory);
+        total.edges = res.edges;
+    }
+
+    std::cout << input << "," << blocks << "," << alg << ","
+              << total.time / repeat << "," << total.memory << ","
+              << total.edges << std::endl;
+    return true;
+}
+
+static size_t blocksNum(const llvm::Module *M)
+{
+    size_t num = 0;
+    for (const auto& F : *M)
+        num += F.size();
+    return num;
+}
+
+static std::vector<std::string> splitList(const char *str)
+{
+    std::vector<std::string> ret;
+    std::string cur;
+    for (const char *c = str; *c; ++c) {
+        if (*c == ',') {
+            ret.push_back(cur);
+            cur.clear();
+        } else {
+            cur.push_back(*c);
+        }
+    }
+    if (!cur.empty())
+        ret.push_back(cur);
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> algorithms{"scd", "ntscd", "ntscd2", "legacy"};
+    std::vector<std::string> shapes;
+    std::vector<unsigned> sizes{1000, 5000};
+    std::vector<const char *> files;
+    unsigned seed = 0;
+    unsigned repeat = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+            algorithms = splitList(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            shapes = splitList(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            sizes.clear();
+            for (const auto& n : splitList(argv[++i]))
+                sizes.push_back(std::max(1, atoi(n.c_str())));
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = static_cast<unsigned>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++i]));
+        else if (argv[i][0] == '-') {
+            std::cerr << "Usage: " << argv[0]
+                      << " [-a alg1,alg2,...] [-g shape1,shape2,...]"
+                         " [-n size1,size2,...] [-s seed] [-r repeat] [file.ll...]\n";
+            return 1;
+        } else
+            files.push_back(argv[i]);
+    }
+
+    if (shapes.empty() && files.empty())
+        shapes = {"chain", "diamonds", "irreducible", "nested", "random"};
+
+    std::cout << "input,blocks,algorithm,time_ms,peak_heap_kB,edges\n";
+
+    bool ok = true;
+    std::mt19937 gen(seed);
+    for (const auto& shape : shapes) {
+        for (unsigned size : sizes) {
+            Graph G;
+            if (shape == "chain")
+                G = generateChain(size);
+            else if (shape == "diamonds")
+                G = generateDiamonds(size);
+            else if (shape == "irreducible")
+                G = generateIrreducible(size);
+            else if (shape == "nested")
+                G = generateNested(size);
+            else if (shape == "random")
+                G = generateRandom(size, gen);
+            else {
+                std::cerr << "Unknown shape: " << shape << "\n";
+                return 1;
+            }
+
+            llvm::LLVMContext context;
+            auto M = createModule(context, G);
+            for (const auto& alg : algorithms)
+                ok &= runAlgorithm(M.get(), alg, shape, blocksNum(M.get()), repeat);
+        }
+    }
+
+    for (const char *file : files) {
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto M = llvm::parseIRFile(file, SMD, context);
+        if (!M) {
+            SMD.print("cda-benchmark", llvm::errs());
+            ok = false;
+            continue;
+        }
+
+        for (const auto& alg : algorithms)
+            ok &= runAlgorithm(M.get(), alg, file, blocksNum(M.get()), repeat);
+    }
+
+    return ok ? 0 : 1;
+}
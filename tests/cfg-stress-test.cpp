@@ -0,0 +1,448 @@
+#include "catch.hpp"
+
+#include "dg/llvm/ControlDependence/ControlDependence.h"
+#include "dg/llvm/ThreadRegions/ControlFlowGraph.h"
+#include "dg/llvm/ThreadRegions/ThreadRegion.h"
+#include "../lib/llvm/ControlDependence/NTSCD.h"
+#include "../lib/llvm/ControlDependence/SCD.h"
+#include "../lib/llvm/ControlDependence/Block.h"
+#include "../lib/llvm/ControlDependence/InterproceduralCD.h"
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/Analysis/PostDominators.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using dg::llvmdg::Block;
+using CDAlgorithm = dg::ControlDependenceAnalysisOptions::CDAlgorithm;
+
+///
+// Add a function with a long chain of blocks into the module. Every block
+// of the chain jumps to the next block or to the exit block. If 'loops'
+// is set, every 16th block jumps back instead of to the exit block.
+// The graphs built from the function are deep, so any recursive
+// traversal would overflow the stack.
+static llvm::Function *addChain(llvm::Module *M, const char *name,
+                                unsigned size, bool loops = false)
+{
+    using namespace llvm;
+
+    auto& context = M->getContext();
+    auto *I32 = Type::getInt32Ty(context);
+    auto *FT = FunctionType::get(I32, {Type::getInt1Ty(context)}, false);
+    auto *F = Function::Create(FT, Function::ExternalLinkage, name, M);
+    Value *cond = &*F->arg_begin();
+
+    auto *entry = BasicBlock::Create(context, "entry", F);
+    std::vector<BasicBlock *> chain(size);
+    for (unsigned i = 0; i < size; ++i)
+        chain[i] = BasicBlock::Create(context, "", F);
+    auto *exit = BasicBlock::Create(context, "exit", F);
+
+    BranchInst::Create(chain[0], entry);
+    for (unsigned i = 0; i + 1 < size; ++i) {
+        BasicBlock *other = (loops && i % 16 == 15) ? chain[i / 2] : exit;
+        BranchInst::Create(chain[i + 1], other, cond, chain[i]);
+    }
+    BranchInst::Create(exit, chain[size - 1]);
+    ReturnInst::Create(context, ConstantInt::get(I32, 0), exit);
+
+    return F;
+}
+
+// create the module with the function main that is a chain of blocks
+static std::unique_ptr<llvm::Module> createChain(llvm::LLVMContext& context,
+                                                 unsigned size, bool loops = false)
+{
+    std::unique_ptr<llvm::Module> M(new llvm::Module("chain", context));
+    addChain(M.get(), "main", size, loops);
+    return M;
+}
+
+using Dependencies = std::set<std::pair<const llvm::BasicBlock *,
+                                        const llvm::BasicBlock *>>;
+
+static Dependencies computeNTSCD(const llvm::Module *M, CDAlgorithm algorithm,
+                                 unsigned workers = 1)
+{
+    dg::LLVMControlDependenceAnalysisOptions opts;
+    opts.algorithm = algorithm;
+    opts.workers = workers;
+    dg::llvmdg::NTSCD ntscd(M, opts);
+    ntscd.computeDependencies();
+
+    Dependencies ret;
+    for (const auto& it : ntscd.controlDependencies()) {
+        for (auto *dependent : it.second)
+            ret.emplace(it.first->llvmBlock(), dependent->llvmBlock());
+    }
+    return ret;
+}
+
+static Dependencies computeSCD(const llvm::Module *M, unsigned workers = 1)
+{
+    dg::LLVMControlDependenceAnalysisOptions opts;
+    opts.workers = workers;
+    dg::llvmdg::SCD scd(M, opts);
+    scd.run();
+
+    Dependencies ret;
+    for (const auto& F : *M) {
+        for (const auto& B : F) {
+            for (auto *dep : scd.getDependencies(&B))
+                ret.emplace(llvm::cast<llvm::BasicBlock>(dep), &B);
+        }
+    }
+    return ret;
+}
+
+// the standard control dependencies computed by the algorithm of Ferrante
+// et al.: for every CFG edge A -> B, B and its post-dominators up to
+// (but without) the immediate post-dominator of A are dependent on A
+static Dependencies computeSCDByEdges(llvm::Module *M)
+{
+    using namespace llvm;
+
+    Function *F = M->getFunction("main");
+    PostDominatorTreeWrapperPass wrapper;
+    wrapper.runOnFunction(*F);
+    auto& PDT = wrapper.getPostDomTree();
+
+    Dependencies ret;
+    for (const auto& A : *F) {
+        auto *ipdom = PDT.getNode(&A)->getIDom();
+        for (const auto *B : successors(&A)) {
+            for (auto *N = PDT.getNode(B); N != ipdom; N = N->getIDom())
+                ret.emplace(&A, N->getBlock());
+        }
+    }
+    return ret;
+}
+
+TEST_CASE("NTSCD of a chain of 1M blocks", "[stress]") {
+    const unsigned size = 1000000;
+    llvm::LLVMContext context;
+    auto M = createChain(context, size);
+
+    auto deps = computeNTSCD(M.get(), CDAlgorithm::NTSCD2);
+
+    // every block of the chain (but the last one) decides
+    // only whether we go to the next block
+    REQUIRE(deps.size() == size - 1);
+    bool nextBlocks = true;
+    for (const auto& dep : deps) {
+        nextBlocks &= dep.first->getNextNode() == dep.second;
+    }
+    REQUIRE(nextBlocks);
+}
+
+TEST_CASE("ntscd and ntscd2 compute the same dependencies", "[stress]") {
+    llvm::LLVMContext context;
+    auto M = createChain(context, 2000, /* loops = */ true);
+
+    auto deps = computeNTSCD(M.get(), CDAlgorithm::NTSCD);
+    auto deps2 = computeNTSCD(M.get(), CDAlgorithm::NTSCD2);
+    REQUIRE(!deps.empty());
+    REQUIRE(deps == deps2);
+}
+
+TEST_CASE("Thread regions of a chain of 1M blocks", "[stress]") {
+    llvm::LLVMContext context;
+    auto M = createChain(context, 1000000);
+
+    ControlFlowGraph controlFlowGraph(nullptr);
+    controlFlowGraph.buildFunction(M->getFunction("main"));
+
+    // the whole chain is one region, only the exit block has
+    // many predecessors and so it starts the second region
+    auto regions = controlFlowGraph.threadRegions();
+    REQUIRE(regions.size() == 2);
+}
+
+TEST_CASE("SCD of a chain of 1M blocks", "[stress]") {
+    const unsigned size = 1000000;
+    llvm::LLVMContext context;
+    auto M = createChain(context, size);
+
+    // the iterated frontiers would be quadratic here
+    auto deps = computeSCD(M.get());
+    REQUIRE(deps.size() == size - 1);
+}
+
+TEST_CASE("SCD computes the post-dominance frontiers", "[stress]") {
+    llvm::LLVMContext context;
+    auto M = createChain(context, 2000, /* loops = */ true);
+
+    auto deps = computeSCD(M.get());
+    REQUIRE(!deps.empty());
+    REQUIRE(deps == computeSCDByEdges(M.get()));
+}
+
+TEST_CASE("CD of functions computed in more threads", "[stress]") {
+    llvm::LLVMContext context;
+    auto M = createChain(context, 100, /* loops = */ true);
+
+    // the interprocedural CFG contains only the functions called from main
+    auto *main = M->getFunction("main");
+    auto *branch = main->getEntryBlock().getTerminator();
+    for (unsigned i = 0; i < 16; ++i) {
+        std::string name = "f" + std::to_string(i);
+        auto *F = addChain(M.get(), name.c_str(), 1000 + 100 * i, true);
+        llvm::CallInst::Create(F, {&*main->arg_begin()}, "", branch);
+    }
+
+    auto scd = computeSCD(M.get());
+    REQUIRE(!scd.empty());
+    REQUIRE(scd == computeSCD(M.get(), 4));
+
+    auto ntscd = computeNTSCD(M.get(), CDAlgorithm::NTSCD2);
+    REQUIRE(!ntscd.empty());
+    REQUIRE(ntscd == computeNTSCD(M.get(), CDAlgorithm::NTSCD2, 4));
+}
+
+// add a function with one block that returns (the calls are added later),
+// or ends with unreachable if 'returns' is false
+static llvm::Function *addCaller(llvm::Module *M, const std::string& name,
+                                 bool returns = true)
+{
+    using namespace llvm;
+
+    auto& context = M->getContext();
+    auto *FT = FunctionType::get(Type::getVoidTy(context), false);
+    auto *F = Function::Create(FT, Function::ExternalLinkage, name, M);
+    auto *B = BasicBlock::Create(context, "entry", F);
+    if (returns)
+        ReturnInst::Create(context, B);
+    else
+        new UnreachableInst(context, B);
+    return F;
+}
+
+static void addCall(llvm::Function *F, llvm::Function *called)
+{
+    llvm::CallInst::Create(called, {}, "", F->getEntryBlock().getTerminator());
+}
+
+TEST_CASE("No-return points of a chain of 100k calls", "[stress]") {
+    const unsigned size = 100000;
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> M(new llvm::Module("calls", context));
+
+    // main -> f0 -> f1 -> ... -> f99999 that does not return
+    auto *main = addCaller(M.get(), "main");
+    std::vector<llvm::Function *> chain;
+    for (unsigned i = 0; i < size; ++i)
+        chain.push_back(addCaller(M.get(), "f" + std::to_string(i),
+                                  i + 1 < size));
+    for (unsigned i = 0; i + 1 < size; ++i)
+        addCall(chain[i], chain[i + 1]);
+    addCall(main, chain[0]);
+
+    // main -> g <-> h, both return if the recursion ends
+    auto *g = addCaller(M.get(), "g");
+    auto *h = addCaller(M.get(), "h");
+    addCall(g, h);
+    addCall(h, g);
+    addCall(main, g);
+
+    // main -> r -> r
+    auto *r = addCaller(M.get(), "r");
+    addCall(r, r);
+    addCall(main, r);
+
+    // main -> k that returns
+    auto *k = addCaller(M.get(), "k");
+    addCall(main, k);
+
+    dg::llvmdg::LLVMInterprocCD cda(M.get());
+    // the no-return points are computed on demand
+    cda.getDependencies(main->getEntryBlock().getTerminator());
+
+    REQUIRE(cda.getNoReturns(main).size() == 3);
+    bool allNoret = true;
+    for (auto *F : chain)
+        allNoret &= cda.getNoReturns(F).size() == 1;
+    REQUIRE(allNoret);
+    REQUIRE(cda.getNoReturns(g).size() == 1);
+    REQUIRE(cda.getNoReturns(h).size() == 1);
+    REQUIRE(cda.getNoReturns(r).size() == 1);
+    REQUIRE(cda.getNoReturns(k).empty());
+}
+
+TEST_CASE("Interprocedural CD of blocks and instructions", "[stress]") {
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> M(new llvm::Module("calls", context));
+
+    // main: call f; call k; call f; br exit
+    // exit: ret
+    auto *f = addCaller(M.get(), "f", /* returns = */ false);
+    auto *k = addCaller(M.get(), "k");
+    auto *main = addCaller(M.get(), "main");
+    addCall(main, f);
+    addCall(main, k);
+    addCall(main, f);
+    auto *entry = &main->getEntryBlock();
+    auto *exit = llvm::BasicBlock::Create(context, "exit", main);
+    llvm::ReturnInst::Create(context, exit);
+    entry->getTerminator()->eraseFromParent();
+    llvm::BranchInst::Create(exit, entry);
+
+    dg::llvmdg::LLVMInterprocCD cda(M.get());
+    std::vector<size_t> sizes;
+    for (auto& I : *entry)
+        sizes.push_back(cda.getInstructionDependencies(&I).size());
+    REQUIRE(sizes == std::vector<size_t>{0, 1, 1, 2});
+    REQUIRE(cda.getBlockDependencies(entry).empty());
+    REQUIRE(cda.getBlockDependencies(exit).size() == 2);
+    REQUIRE(cda.getDependencies(exit->getTerminator()).size() == 2);
+    REQUIRE(cda.getDependencies(entry->getTerminator()).size() == 2);
+}
+
+static Dependencies getDependencies(dg::LLVMControlDependenceAnalysis& cda,
+                                    const llvm::Function *F)
+{
+    Dependencies ret;
+    for (const auto& B : *F) {
+        for (auto *dep : cda.getDependencies(&B))
+            ret.emplace(llvm::cast<llvm::BasicBlock>(dep), &B);
+    }
+    return ret;
+}
+
+TEST_CASE("Incremental update of control dependencies", "[stress]") {
+    using namespace llvm;
+
+    LLVMContext context;
+    auto M = createChain(context, 2000, /* loops = */ true);
+    auto *F = M->getFunction("main");
+    auto *other = addChain(M.get(), "other", 100, true);
+
+    dg::LLVMControlDependenceAnalysisOptions opts;
+    opts.incremental = true;
+    dg::LLVMControlDependenceAnalysis cda(M.get(), opts);
+    auto otherDeps = getDependencies(cda, other);
+    REQUIRE(getDependencies(cda, F) == computeSCDByEdges(M.get()));
+
+    std::vector<BasicBlock *> chain;
+    for (auto& B : *F)
+        chain.push_back(&B);
+    // chain[0] is the entry block
+    auto *exit = &F->back();
+
+    // the blocks 100 to 199 go only to the next block. We change the CFG
+    // first and report the changes after that, the analysis applies
+    // them to the post-dominator tree in one batch
+    std::vector<std::pair<BasicBlock *, BasicBlock *>> removed;
+    for (unsigned i = 100; i < 200; ++i) {
+        auto *T = chain[i]->getTerminator();
+        auto *succ = T->getSuccessor(0);
+        removed.emplace_back(chain[i], T->getSuccessor(1));
+        T->eraseFromParent();
+        BranchInst::Create(succ, chain[i]);
+    }
+    for (auto& edge : removed)
+        cda.deleteEdge(edge.first, edge.second);
+
+    // put a new block between the blocks 500 and 501
+    auto *N = BasicBlock::Create(context, "new", F, chain[501]);
+    BranchInst::Create(chain[501], N);
+    chain[500]->getTerminator()->setSuccessor(0, N);
+    cda.insertEdge(chain[500], N);
+    cda.insertEdge(N, chain[501]);
+    cda.deleteEdge(chain[500], chain[501]);
+
+    // remove the block 1001 (it is not a target of any loop). We take
+    // all its edges first, then we report the changes and delete the block
+    // (the pending updates are applied while the block is still there)
+    auto *B = chain[1001];
+    auto *pred = chain[1000];
+    pred->getTerminator()->eraseFromParent();
+    BranchInst::Create(chain[1002], exit, &*F->arg_begin(), pred);
+    B->getTerminator()->eraseFromParent();
+    new UnreachableInst(context, B);
+    cda.insertEdge(pred, chain[1002]);
+    cda.deleteEdge(pred, B);
+    cda.deleteEdge(B, chain[1002]);
+    cda.deleteEdge(B, exit);
+    cda.deleteBlock(B);
+    B->eraseFromParent();
+
+    REQUIRE(getDependencies(cda, F) == computeSCDByEdges(M.get()));
+    REQUIRE(getDependencies(cda, other) == otherDeps);
+}
+
+TEST_CASE("Interprocedural CD after changes of the CFG", "[stress]") {
+    using namespace llvm;
+
+    LLVMContext context;
+    std::unique_ptr<Module> M(new Module("calls", context));
+
+    // main: call f; call k; br exit   h: call f; ret
+    // exit: ret
+    auto *f = addCaller(M.get(), "f", /* returns = */ false);
+    auto *k = addCaller(M.get(), "k");
+    auto *h = addCaller(M.get(), "h");
+    auto *main = addCaller(M.get(), "main");
+    addCall(h, f);
+    addCall(main, f);
+    addCall(main, k);
+    auto *entry = &main->getEntryBlock();
+    auto *exit = BasicBlock::Create(context, "exit", main);
+    ReturnInst::Create(context, exit);
+    entry->getTerminator()->eraseFromParent();
+    BranchInst::Create(exit, entry);
+
+    auto getAllDependencies = [&](dg::llvmdg::LLVMInterprocCD& cda) {
+        std::vector<std::set<const Value *>> ret;
+        for (auto *F : {main, h}) {
+            for (auto& B : *F) {
+                for (auto& I : B) {
+                    auto deps = cda.getDependencies(&I);
+                    ret.emplace_back(deps.begin(), deps.end());
+                }
+            }
+        }
+        return ret;
+    };
+
+    dg::llvmdg::LLVMInterprocCD cda(M.get());
+    getAllDependencies(cda);
+
+    // entry -> mid -> exit, where mid: call f. The main function
+    // had a no-return point before, so only main is computed again
+    auto *mid = BasicBlock::Create(context, "mid", main, exit);
+    CallInst::Create(f, {}, "", mid);
+    BranchInst::Create(exit, mid);
+    entry->getTerminator()->setSuccessor(0, mid);
+    cda.insertEdge(entry, mid);
+    cda.insertEdge(mid, exit);
+    cda.deleteEdge(entry, exit);
+
+    dg::llvmdg::LLVMInterprocCD fresh(M.get());
+    REQUIRE(getAllDependencies(cda) == getAllDependencies(fresh));
+    REQUIRE(cda.getBlockDependencies(exit).size() == 2);
+}
@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "dg/legacy/NodesWalk.h"
+#include "test-dg.h"
+
+using namespace dg;
+using dg::tests::TestNode;
+
+// a binary tree of data dependencies, optionally with a back edge
+// from every leaf to the root
+static std::vector<std::unique_ptr<TestNode>>
+createTree(unsigned num, bool back_edges = true) {
+    std::vector<std::unique_ptr<TestNode>> nodes;
+    for (unsigned i = 0; i < num; ++i) {
+        nodes.emplace_back(new TestNode(i));
+        if (i > 0)
+            nodes[(i - 1) / 2]->addDataDependence(nodes[i].get());
+    }
+    if (back_edges) {
+        for (unsigned i = num / 2; i < num; ++i)
+            nodes[i]->addDataDependence(nodes[0].get());
+    }
+    return nodes;
+}
+
+TEST_CASE("DenseNodesWalk", "DenseNodesWalk") {
+    auto nodes = createTree(100);
+
+    legacy::DenseNodesWalk<TestNode> walk(legacy::NODES_WALK_DD);
+    std::set<TestNode *> reached;
+    walk.walk(nodes[1].get(), [](TestNode *n, std::set<TestNode *> *r) {
+        bool ret = r->insert(n).second;
+        REQUIRE(ret);
+    }, &reached);
+
+    // the subtree of the node 1 and (via the leaves) the whole tree
+    REQUIRE(reached.size() == 100);
+
+    // walk back to the root, the walk can be run again
+    nodes = createTree(100, false);
+    legacy::DenseNodesWalk<TestNode> rev(legacy::NODES_WALK_REV_DD);
+    for (int i = 0; i < 2; ++i) {
+        reached.clear();
+        rev.walk(std::vector<TestNode *>{nodes[7].get(), nodes[8].get()},
+                 [](TestNode *n, std::set<TestNode *> *r) { r->insert(n); },
+                 &reached);
+        REQUIRE(reached == std::set<TestNode *>{nodes[0].get(), nodes[1].get(),
+                                                nodes[3].get(), nodes[7].get(),
+                                                nodes[8].get()});
+        REQUIRE(rev.visited(nodes[3].get()));
+        REQUIRE(!rev.visited(nodes[2].get()));
+    }
+}
+
+TEST_CASE("DenseNodesWalk-parallel", "DenseNodesWalk") {
+    auto nodes = createTree(100000);
+    // nodes that are not reachable from the first tree
+    auto other = createTree(1000);
+
+    legacy::DenseNodesWalk<TestNode> seq(legacy::NODES_WALK_REV_DD);
+    legacy::DenseNodesWalk<TestNode> par(legacy::NODES_WALK_REV_DD, 4);
+
+    // the leaves reach the whole tree, the back edges
+    // from the leaves reach all leaves
+    std::vector<TestNode *> start{nodes[50000].get()};
+    unsigned seqNum = 0, parNum = 0;
+    seq.walk(start, [](TestNode *, unsigned *num) { ++*num; }, &seqNum);
+    par.walk(start, [](TestNode *n, unsigned *num) {
+        REQUIRE(n->counter == 0);
+        ++n->counter;
+        ++*num;
+    }, &parNum);
+
+    REQUIRE(seqNum == 100000);
+    REQUIRE(parNum == seqNum);
+    for (auto& nd : nodes) {
+        REQUIRE(nd->counter == 1);
+        REQUIRE(par.visited(nd.get()));
+    }
+    for (auto& nd : other)
+        REQUIRE(!par.visited(nd.get()));
+}
+
+TEST_CASE("Node IDs are recycled", "DenseNodesWalk") {
+    // the IDs (and so the bitsets of the walks) do not grow
+    // when graphs are created and destroyed one after another
+    createTree(1000);
+    auto maxID = TestNode::getMaxID();
+    for (int i = 0; i < 10; ++i) {
+        auto nodes = createTree(1000);
+        std::set<unsigned> ids;
+        for (auto& nd : nodes) {
+            REQUIRE(nd->getID() > 0);
+            REQUIRE(nd->getID() <= maxID);
+            ids.insert(nd->getID());
+        }
+        REQUIRE(ids.size() == 1000);
+    }
+    REQUIRE(TestNode::getMaxID() == maxID);
+}
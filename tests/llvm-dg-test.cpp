@@ -1,9 +1,45 @@
 #include <assert.h>
 #include <cstdarg>
 #include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/IRReader/IRReader.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
 
 #include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/LLVMDependenceGraphBuilder.h"
+#include "dg/llvm/LLVMSlicer.h"
+#include "dg/llvm/LLVMSummaryEdges.h"
+#include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
+#include "dg/llvm/DataDependence/DataDependence.h"
 #include "dg/DFS.h"
+#include "dg/Slicing.h"
 #include "test-runner.h"
 
 
@@ -55,6 +91,1023 @@ struct TestRefcount : public Test
     }
 };
 
+struct TestSummaryEdges : public Test
+{
+    TestSummaryEdges() : Test("summary edges test") {}
+
+    static bool hasSource(const LLVMSummaryEdges& summaries,
+                          LLVMNode *to, LLVMNode *from)
+    {
+        auto *sources = summaries.getSources(to);
+        return sources &&
+               std::find(sources->begin(), sources->end(), from) != sources->end();
+    }
+
+    void test()
+    {
+        // the returned value depends only on the first parameter
+        const char *code =
+            "define i32 @first(i32 %x, i32 %y) {\n"
+            "entry:\n"
+            "  %z = add i32 %y, 1\n"
+            "  ret i32 %x\n"
+            "}\n"
+            "define i32 @main() {\n"
+            "entry:\n"
+            "  %a = call i32 @first(i32 1, i32 2)\n"
+            "  %b = call i32 @first(i32 3, i32 4)\n"
+            "  %c = add i32 %a, %b\n"
+            "  ret i32 %c\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        LLVMSummaryEdges summaries;
+        summaries.compute(*graph);
+
+        unsigned calls = 0;
+        for (auto& it : *graph->getNodes()) {
+            LLVMNode *call = it.second;
+            if (call->getSubgraphs().empty())
+                continue;
+
+            ++calls;
+            auto *CI = llvm::cast<llvm::CallInst>(call->getValue());
+            auto *params = call->getParameters();
+            auto *x = params->find(CI->getArgOperand(0));
+            auto *y = params->find(CI->getArgOperand(1));
+            check(x && y, "missing actual parameters");
+
+            // the returned value goes to the call node
+            check(hasSource(summaries, call, x->in),
+                  "missing summary edge from the first parameter");
+            check(!hasSource(summaries, call, y->in),
+                  "summary edge from the second parameter");
+            check(hasSource(summaries, call, call),
+                  "missing summary edge for the entry node");
+            check(x->in->data_begin() != x->in->data_end() &&
+                  summaries.isParameterIn(x->in, *x->in->data_begin()),
+                  "the edge to the formal parameter is not a parameter-in edge");
+        }
+
+        check(calls == 2, "found %u call-sites instead of 2", calls);
+    }
+};
+
+struct TestContextSensitiveSlicing : public Test
+{
+    TestContextSensitiveSlicing() : Test("context-sensitive slicing test") {}
+
+    void test()
+    {
+        // the second call of @id does not influence the returned value
+        const char *code =
+            "define i32 @id(i32 %x) {\n"
+            "entry:\n"
+            "  ret i32 %x\n"
+            "}\n"
+            "define i32 @main() {\n"
+            "entry:\n"
+            "  %a = call i32 @id(i32 1)\n"
+            "  %b = call i32 @id(i32 2)\n"
+            "  ret i32 %a\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        LLVMSummaryEdges summaries;
+        summaries.compute(*graph);
+
+        LLVMNode *a = nullptr, *b = nullptr, *ret = nullptr;
+        for (auto& it : *graph->getNodes()) {
+            auto *val = it.second->getValue();
+            if (val->getName() == "a")
+                a = it.second;
+            else if (val->getName() == "b")
+                b = it.second;
+            else if (llvm::isa<llvm::ReturnInst>(val))
+                ret = it.second;
+        }
+        check(a && b && ret, "missing nodes");
+        if (!a || !b || !ret)
+            return;
+
+        ContextSensitiveWalkAndMark<LLVMNode, LLVMSummaryEdges> wm(summaries);
+        wm.mark(std::vector<LLVMNode *>{ret}, 1);
+
+        check(a->getSlice() == 1, "the first call is not in the slice");
+        check(b->getSlice() != 1, "the second call is in the slice");
+
+        // the returned value of @id is in the slice
+        bool found = false;
+        for (auto& it : graph->getConstructedFunctions()) {
+            if (it.first->getName() != "id")
+                continue;
+            for (auto& nit : *it.second->getNodes()) {
+                if (llvm::isa<llvm::ReturnInst>(nit.second->getValue()))
+                    found = nit.second->getSlice() == 1;
+            }
+        }
+        check(found, "the return of the called function is not in the slice");
+    }
+};
+
+struct TestBatchSlicing : public Test
+{
+    TestBatchSlicing() : Test("batch slicing test") {}
+
+    void test()
+    {
+        const char *code =
+            "@g = global i32 0\n"
+            "define i32 @foo(i32 %x) {\n"
+            "entry:\n"
+            "  %c = icmp sgt i32 %x, 0\n"
+            "  br i1 %c, label %then, label %end\n"
+            "then:\n"
+            "  store i32 %x, i32* @g\n"
+            "  br label %end\n"
+            "end:\n"
+            "  %r = load i32, i32* @g\n"
+            "  ret i32 %r\n"
+            "}\n"
+            "define i32 @main() {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 1, i32* %a\n"
+            "  br label %loop\n"
+            "loop:\n"
+            "  %i = phi i32 [0, %entry], [%n, %loop]\n"
+            "  %v = load i32, i32* %a\n"
+            "  %s = add i32 %v, %i\n"
+            "  store i32 %s, i32* %a\n"
+            "  %n = add i32 %i, 1\n"
+            "  %d = icmp slt i32 %n, 10\n"
+            "  br i1 %d, label %loop, label %out\n"
+            "out:\n"
+            "  %f = call i32 @foo(i32 %s)\n"
+            "  %b = load i32, i32* %a\n"
+            "  %e = add i32 %f, %b\n"
+            "  ret i32 %e\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        // slice w.r.t. every node separately
+        std::vector<LLVMNode *> nodes;
+        for (auto& it : graph->getConstructedFunctions()) {
+            for (auto& nit : *it.second->getNodes())
+                nodes.push_back(nit.second);
+        }
+
+        std::vector<std::set<LLVMNode *>> criteria;
+        for (LLVMNode *n : nodes)
+            criteria.push_back({n});
+
+        BatchWalkAndMark<LLVMNode> batch;
+        batch.compute(criteria);
+        check(batch.getCriteriaNum() == nodes.size(),
+              "computed %lu slices instead of %lu",
+              (unsigned long) batch.getCriteriaNum(),
+              (unsigned long) nodes.size());
+
+        for (unsigned i = 0; i < criteria.size(); ++i) {
+            // a new slice id, so that the previous slices do not count
+            uint32_t slice_id = i + 1;
+            WalkAndMark<LLVMNode> wm;
+            wm.mark(*criteria[i].begin(), slice_id);
+
+            for (LLVMNode *n : nodes) {
+                check((n->getSlice() == slice_id) == batch.isInSlice(n, i),
+                      "slice %u differs in a node of %s", i,
+                      n->getValue()->getName().str().c_str());
+            }
+
+            // the nodes that are not in the graphs (e.g., parameters)
+            for (LLVMNode *n : batch.getNodes()) {
+                check(!batch.isInSlice(n, i) || n->getSlice() == slice_id,
+                      "slice %u has a node that WalkAndMark did not mark", i);
+            }
+        }
+    }
+};
+
+struct TestSlicingUpdatesCD : public Test
+{
+    TestSlicingUpdatesCD() : Test("slicing updates control dependencies test") {}
+
+    void test()
+    {
+        // the blocks %else and %loop are sliced away
+        const char *code =
+            "define i32 @main(i32 %x) {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 0, i32* %a\n"
+            "  %c = icmp sgt i32 %x, 0\n"
+            "  br i1 %c, label %then, label %else\n"
+            "then:\n"
+            "  %c2 = icmp sgt i32 %x, 10\n"
+            "  br i1 %c2, label %big, label %join\n"
+            "big:\n"
+            "  store i32 2, i32* %a\n"
+            "  br label %join\n"
+            "else:\n"
+            "  %y = add i32 %x, 1\n"
+            "  br label %join\n"
+            "join:\n"
+            "  %l = load i32, i32* %a\n"
+            "  %c3 = icmp eq i32 %x, 5\n"
+            "  br i1 %c3, label %loop, label %end\n"
+            "loop:\n"
+            "  %z = mul i32 %x, 3\n"
+            "  br label %end\n"
+            "end:\n"
+            "  ret i32 %l\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        LLVMNode *ret = nullptr;
+        for (auto& it : *graph->getNodes()) {
+            if (llvm::isa<llvm::ReturnInst>(it.second->getValue()))
+                ret = it.second;
+        }
+        check(ret != nullptr, "missing the return node");
+        if (!ret)
+            return;
+
+        LLVMControlDependenceAnalysisOptions opts;
+        opts.incremental = true;
+        LLVMControlDependenceAnalysis cda(M.get(), opts);
+        llvm::Function *F = M->getFunction("main");
+        // compute the dependencies before slicing
+        for (auto& B : *F)
+            cda.getDependencies(&B);
+        size_t blocks = F->size();
+
+        llvmdg::LLVMSlicer slicer;
+        slicer.setControlDependence(&cda);
+        uint32_t slice_id = slicer.mark(ret, 1);
+        slicer.slice(graph.get(), nullptr, slice_id);
+
+        check(F->size() < blocks, "no block was sliced away");
+        check(!llvm::verifyFunction(*F, &llvm::errs()), "the sliced function is broken");
+
+        LLVMControlDependenceAnalysis fresh(M.get(), opts);
+        for (auto& B : *F) {
+            auto deps = cda.getDependencies(&B);
+            auto freshDeps = fresh.getDependencies(&B);
+            check(std::set<llvm::Value *>(deps.begin(), deps.end()) ==
+                  std::set<llvm::Value *>(freshDeps.begin(), freshDeps.end()),
+                  "the dependencies of the block %s were not updated",
+                  B.getName().str().c_str());
+        }
+    }
+};
+
+struct TestSlicedCFG : public Test
+{
+    TestSlicedCFG() : Test("sliced CFG test") {}
+
+    using SuccessorsT = std::map<std::string, std::vector<std::string>>;
+
+    // the names of the successors of every block in the order of labels
+    static SuccessorsT getSuccessors(const llvm::Function *F)
+    {
+        SuccessorsT succs;
+        for (const llvm::BasicBlock& B : *F) {
+            auto& S = succs[B.getName().str()];
+            const auto *T = B.getTerminator();
+            for (unsigned i = 0; T && i < T->getNumSuccessors(); ++i)
+                S.push_back(T->getSuccessor(i)->getName().str());
+        }
+        return succs;
+    }
+
+    void checkCFG(const llvm::Function *F, const char *slicer)
+    {
+        // %then, %s1, %s2, %loop and %early are sliced away,
+        // the edges to them lead to the blocks that stay after them
+        // or to the new exit block if no such block exists
+        const SuccessorsT expected = {
+            {"entry", {"join", "else"}},
+            {"else", {"join"}},
+            {"join", {"end", "end", "end", "safe_return"}},
+            {"end", {}},
+            {"safe_return", {}},
+        };
+
+        check(!llvm::verifyFunction(*F, &llvm::errs()),
+              "the function sliced by %s is broken", slicer);
+        auto succs = getSuccessors(F);
+        check(succs.size() == expected.size(),
+              "the function sliced by %s has %lu blocks instead of %lu", slicer,
+              (unsigned long) succs.size(), (unsigned long) expected.size());
+        for (auto& it : expected) {
+            auto sit = succs.find(it.first);
+            check(sit != succs.end() && sit->second == it.second,
+                  "wrong successors of the block %s sliced by %s",
+                  it.first.c_str(), slicer);
+        }
+    }
+
+    void test()
+    {
+        const char *code =
+            "@h = global i32 0\n"
+            "define i32 @main(i32 %x) {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 %x, i32* %a\n"
+            "  %c = icmp sgt i32 %x, 0\n"
+            "  br i1 %c, label %then, label %else\n"
+            "then:\n"
+            "  store i32 1, i32* @h\n"
+            "  br label %join\n"
+            "else:\n"
+            "  %x1 = add i32 %x, 1\n"
+            "  store i32 %x1, i32* %a\n"
+            "  br label %join\n"
+            "join:\n"
+            "  switch i32 %x, label %loop [ i32 1, label %s1\n"
+            "                               i32 2, label %s2\n"
+            "                               i32 3, label %early ]\n"
+            "s1:\n"
+            "  store i32 2, i32* @h\n"
+            "  br label %end\n"
+            "s2:\n"
+            "  store i32 3, i32* @h\n"
+            "  br label %end\n"
+            "loop:\n"
+            "  %i = phi i32 [0, %join], [%n, %loop]\n"
+            "  store i32 %i, i32* @h\n"
+            "  %n = add i32 %i, 1\n"
+            "  %d = icmp slt i32 %n, 10\n"
+            "  br i1 %d, label %loop, label %end\n"
+            "early:\n"
+            "  store i32 4, i32* @h\n"
+            "  ret i32 0\n"
+            "end:\n"
+            "  %r = load i32, i32* %a\n"
+            "  ret i32 %r\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        llvm::Function *F = M->getFunction("main");
+        LLVMNode *ret = nullptr;
+        for (auto& B : *F) {
+            if (B.getName() == "end")
+                ret = graph->getNode(B.getTerminator());
+        }
+        check(ret != nullptr, "missing the return node");
+        if (!ret)
+            return;
+
+        // the copying slicer leaves the graph untouched,
+        // so the in-place slicer must give the same CFG
+        llvmdg::LLVMSlicer slicer;
+        uint32_t slice_id = slicer.mark(ret, 1);
+        auto sliced = slicer.sliceCopy(graph.get(), slice_id);
+        check(sliced != nullptr, "failed copying the slice");
+        if (sliced)
+            checkCFG(sliced->getFunction("main"), "sliceCopy()");
+
+        slicer.slice(graph.get(), nullptr, slice_id);
+        checkCFG(F, "slice()");
+    }
+};
+
+using LLVMDefinitionsT
+    = std::map<const llvm::Value *, std::set<const llvm::Value *>>;
+
+// the definitions of all uses in the module
+static LLVMDefinitionsT
+getAllDefinitions(llvm::Module *M, LLVMPointerAnalysis *PTA, bool eager)
+{
+    LLVMDataDependenceAnalysisOptions opts;
+    opts.eagerPhiPlacement = eager;
+    dda::LLVMDataDependenceAnalysis DDA(M, PTA, opts);
+    DDA.run();
+
+    LLVMDefinitionsT defs;
+    for (auto& F : *M) {
+        for (auto& B : F) {
+            for (auto& I : B) {
+                if (!DDA.isUse(&I))
+                    continue;
+                auto& D = defs[&I];
+                for (auto *def : DDA.getLLVMDefinitions(&I))
+                    D.insert(def);
+            }
+        }
+    }
+    return defs;
+}
+
+static const llvm::Value *
+getInstruction(llvm::Function *F, const char *name)
+{
+    for (auto& B : *F) {
+        for (auto& I : B) {
+            if (I.getName() == name)
+                return &I;
+        }
+    }
+    return nullptr;
+}
+
+struct TestDefinitionsAfterCalls : public Test
+{
+    TestDefinitionsAfterCalls() : Test("definitions after calls test") {}
+
+    void test()
+    {
+        // @unk may define only unknown memory, so the search for
+        // the definitions of %a must continue before both calls
+        // (the second call reuses the outputs created for the first one)
+        const char *code =
+            "define void @unk(i64 %n) {\n"
+            "entry:\n"
+            "  %q = inttoptr i64 %n to i32*\n"
+            "  store i32 1, i32* %q\n"
+            "  ret void\n"
+            "}\n"
+            "define i32 @main(i64 %n) {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 0, i32* %a\n"
+            "  call void @unk(i64 %n)\n"
+            "  %l1 = load i32, i32* %a\n"
+            "  store i32 2, i32* %a\n"
+            "  call void @unk(i64 %n)\n"
+            "  %l2 = load i32, i32* %a\n"
+            "  %r = add i32 %l1, %l2\n"
+            "  ret i32 %r\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        DGLLVMPointerAnalysis PTA(M.get());
+        PTA.run();
+
+        llvm::Function *F = M->getFunction("main");
+        const llvm::Value *unkStore = nullptr;
+        for (auto& I : M->getFunction("unk")->getEntryBlock()) {
+            if (llvm::isa<llvm::StoreInst>(I))
+                unkStore = &I;
+        }
+        std::vector<const llvm::Value *> stores;
+        for (auto& I : F->getEntryBlock()) {
+            if (llvm::isa<llvm::StoreInst>(I))
+                stores.push_back(&I);
+        }
+        check(unkStore && stores.size() == 2, "missing the stores");
+        if (!unkStore || stores.size() != 2)
+            return;
+
+        for (bool eager : {false, true}) {
+            auto defs = getAllDefinitions(M.get(), &PTA, eager);
+            auto& l1 = defs[getInstruction(F, "l1")];
+            auto& l2 = defs[getInstruction(F, "l2")];
+            check(l1.count(stores[0]) > 0 && l1.count(unkStore) > 0,
+                  "missing a definition of %%l1 (eager: %d)", eager);
+            check(l2.count(stores[1]) > 0 && l2.count(unkStore) > 0,
+                  "missing a definition of %%l2 (eager: %d)", eager);
+            check(l2.count(stores[0]) == 0,
+                  "%%l2 is defined by an overwritten store (eager: %d)", eager);
+        }
+    }
+};
+
+struct TestEagerPhiPlacement : public Test
+{
+    TestEagerPhiPlacement() : Test("eager phi placement test") {}
+
+    void test()
+    {
+        const char *code =
+            "@g = global i32 0\n"
+            "define void @setg(i32 %x) {\n"
+            "entry:\n"
+            "  %c = icmp sgt i32 %x, 0\n"
+            "  br i1 %c, label %then, label %end\n"
+            "then:\n"
+            "  store i32 %x, i32* @g\n"
+            "  br label %end\n"
+            "end:\n"
+            "  ret void\n"
+            "}\n"
+            "define void @unk(i64 %n) {\n"
+            "entry:\n"
+            "  %q = inttoptr i64 %n to i32*\n"
+            "  store i32 1, i32* %q\n"
+            "  ret void\n"
+            "}\n"
+            "define i32 @main(i32 %x, i64 %n) {\n"
+            "entry:\n"
+            "  %a = alloca [2 x i32]\n"
+            "  %a0 = getelementptr [2 x i32], [2 x i32]* %a, i32 0, i32 0\n"
+            "  %a1 = getelementptr [2 x i32], [2 x i32]* %a, i32 0, i32 1\n"
+            "  store i32 0, i32* %a0\n"
+            "  store i32 0, i32* %a1\n"
+            "  br label %loop\n"
+            "loop:\n"
+            "  %i = phi i32 [0, %entry], [%i1, %latch]\n"
+            "  %v = load i32, i32* %a0\n"
+            "  %c = icmp sgt i32 %v, %x\n"
+            "  br i1 %c, label %then, label %else\n"
+            "then:\n"
+            "  store i32 %i, i32* %a0\n"
+            "  call void @setg(i32 %i)\n"
+            "  br label %latch\n"
+            "else:\n"
+            "  store i32 %i, i32* %a1\n"
+            "  call void @unk(i64 %n)\n"
+            "  br label %latch\n"
+            "latch:\n"
+            "  %w = load i32, i32* %a1\n"
+            "  call void @setg(i32 %w)\n"
+            "  %i1 = add i32 %i, 1\n"
+            "  %d = icmp slt i32 %i1, 10\n"
+            "  br i1 %d, label %loop, label %out\n"
+            "out:\n"
+            "  call void @unk(i64 %n)\n"
+            "  %b = load i32, i32* %a0\n"
+            "  %e = load i32, i32* %a1\n"
+            "  %f = load i32, i32* @g\n"
+            "  %s = add i32 %b, %e\n"
+            "  %r = add i32 %s, %f\n"
+            "  ret i32 %r\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        DGLLVMPointerAnalysis PTA(M.get());
+        PTA.run();
+
+        auto ondemand = getAllDefinitions(M.get(), &PTA, false);
+        auto eager = getAllDefinitions(M.get(), &PTA, true);
+        check(!ondemand.empty(), "found no uses");
+        check(ondemand.size() == eager.size(), "the uses differ");
+        for (auto& it : ondemand) {
+            auto& other = eager[it.first];
+            check(it.second == other,
+                  "the definitions of %s differ (%lu on-demand, %lu eager)",
+                  it.first->getName().str().c_str(),
+                  (unsigned long) it.second.size(),
+                  (unsigned long) other.size());
+        }
+    }
+};
+
+struct TestModRefSummariesCache : public Test
+{
+    TestModRefSummariesCache() : Test("mod/ref summaries cache test") {}
+
+    // the fingerprints depend on the accessed memory,
+    // so the change of @setg is that it writes also to @h
+    static std::string getCode(bool setgWritesH) {
+        return std::string(
+            "@g = global i32 0\n"
+            "@h = global i32 0\n"
+            "define void @setg() {\n"
+            "entry:\n"
+            "  store i32 1, i32* @g\n") +
+            (setgWritesH ? "  store i32 2, i32* @h\n" : "") +
+            "  ret void\n"
+            "}\n"
+            "define void @seth() {\n"
+            "entry:\n"
+            "  store i32 1, i32* @h\n"
+            "  ret void\n"
+            "}\n"
+            "define i32 @main() {\n"
+            "entry:\n"
+            "  call void @setg()\n"
+            "  call void @seth()\n"
+            "  %a = load i32, i32* @g\n"
+            "  %b = load i32, i32* @h\n"
+            "  %r = add i32 %a, %b\n"
+            "  ret i32 %r\n"
+            "}\n";
+    }
+
+    // run the analysis with the summaries from the file, store
+    // the updated summaries and return the number of reused summaries
+    unsigned runWithCache(const std::string& code, const char *file,
+                          bool checkDefinitions = false)
+    {
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return 0;
+
+        DGLLVMPointerAnalysis PTA(M.get());
+        PTA.run();
+
+        LLVMDataDependenceAnalysisOptions opts;
+        opts.modRefSummaries = file;
+        dda::LLVMDataDependenceAnalysis DDA(M.get(), &PTA, opts);
+        DDA.run();
+        check(DDA.storeModRefSummaries(), "failed storing the summaries");
+
+        if (checkDefinitions) {
+            auto nocache = getAllDefinitions(M.get(), &PTA, false);
+            for (auto& it : nocache) {
+                auto *use = const_cast<llvm::Value *>(it.first);
+                auto D = DDA.getLLVMDefinitions(use);
+                check(std::set<const llvm::Value *>(D.begin(), D.end()) == it.second,
+                      "the definitions of %s differ with the cache",
+                      use->getName().str().c_str());
+            }
+        }
+
+        return DDA.getReusedModRefSummaries();
+    }
+
+    void test()
+    {
+        const char *file = "llvm-dg-test-modref-summaries.txt";
+        std::remove(file);
+
+        // the cache is empty at first, then all summaries are reused
+        check(runWithCache(getCode(false), file) == 0,
+              "reused summaries from an empty cache");
+        unsigned reused = runWithCache(getCode(false), file, true);
+        check(reused == 3, "reused %u summaries instead of 3", reused);
+
+        // @setg changed and so did @main that calls it
+        reused = runWithCache(getCode(true), file);
+        check(reused == 1, "reused %u summaries instead of 1", reused);
+
+        // the summaries with the old fingerprints are evicted
+        dda::ModRefSummaries summaries;
+        std::ifstream in(file);
+        check(summaries.read(in), "failed reading the summaries");
+        check(summaries.size() == 3, "the cache has %lu summaries instead of 3",
+              (unsigned long) summaries.size());
+
+        std::remove(file);
+    }
+};
+
+struct TestLazyDataDependencies : public Test
+{
+    TestLazyDataDependencies() : Test("lazy data dependencies slicing test") {}
+
+    // slice the module w.r.t. the return from main and return the
+    // instructions that were left (the order of predecessors of blocks
+    // in the printed module may differ, so we do not compare that)
+    std::set<std::string> slice(const char *code, bool lazy)
+    {
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return {};
+
+        llvmdg::LLVMDependenceGraphOptions opts;
+        opts.lazyDataDependencies = lazy;
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get(), opts);
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return {};
+
+        LLVMNode *ret = nullptr;
+        for (auto& it : *graph->getNodes()) {
+            if (llvm::isa<llvm::ReturnInst>(it.second->getValue()))
+                ret = it.second;
+        }
+        check(ret != nullptr, "missing the return node");
+        if (!ret)
+            return {};
+
+        llvmdg::LLVMSlicer slicer;
+        uint32_t slice_id = slicer.mark(ret, 1);
+        slicer.slice(graph.get(), nullptr, slice_id);
+        check(!llvm::verifyModule(*M, &llvm::errs()), "the sliced module is broken");
+
+        std::set<std::string> instructions;
+        for (auto& F : *M) {
+            for (auto& B : F) {
+                for (auto& I : B) {
+                    std::string str;
+                    llvm::raw_string_ostream ostr(str);
+                    I.print(ostr);
+                    instructions.insert(F.getName().str() + ":" +
+                                        B.getName().str() + ":" + ostr.str());
+                }
+            }
+        }
+        return instructions;
+    }
+
+    void test()
+    {
+        // the blocks %else and %dead with loads whose
+        // data dependencies are never computed are sliced away
+        const char *code =
+            "@g = global i32 0\n"
+            "define i32 @get() {\n"
+            "entry:\n"
+            "  %v = load i32, i32* @g\n"
+            "  ret i32 %v\n"
+            "}\n"
+            "define i32 @main(i32 %x) {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  %b = alloca i32\n"
+            "  store i32 0, i32* %a\n"
+            "  store i32 1, i32* %b\n"
+            "  %c = icmp sgt i32 %x, 0\n"
+            "  br i1 %c, label %then, label %else\n"
+            "then:\n"
+            "  store i32 %x, i32* %a\n"
+            "  br label %join\n"
+            "else:\n"
+            "  %lb = load i32, i32* %b\n"
+            "  store i32 %lb, i32* @g\n"
+            "  br label %join\n"
+            "join:\n"
+            "  %c2 = icmp eq i32 %x, 5\n"
+            "  br i1 %c2, label %dead, label %end\n"
+            "dead:\n"
+            "  %lb2 = load i32, i32* %b\n"
+            "  %y = add i32 %lb2, 1\n"
+            "  store i32 %y, i32* %b\n"
+            "  br label %end\n"
+            "end:\n"
+            "  %la = load i32, i32* %a\n"
+            "  %r = call i32 @get()\n"
+            "  %s = add i32 %la, %r\n"
+            "  ret i32 %s\n"
+            "}\n";
+
+        auto eager = slice(code, false);
+        auto lazy = slice(code, true);
+        check(!eager.empty(), "the slice is empty");
+        for (auto& I : eager) {
+            check(I.find("%lb2") == std::string::npos,
+                  "the block %%dead was not sliced away");
+        }
+        check(eager == lazy, "the slices differ (%lu and %lu instructions)",
+              (unsigned long) eager.size(), (unsigned long) lazy.size());
+    }
+};
+
+struct TestBulkDefUseEdges : public Test
+{
+    TestBulkDefUseEdges() : Test("bulk def-use edges test") {}
+
+    using EdgesT = std::set<std::pair<llvm::Value *, llvm::Value *>>;
+
+    // the data dependence edges between the nodes of the functions,
+    // forward and reverse ones separately
+    static void getDataEdges(LLVMDependenceGraph *graph,
+                             EdgesT& edges, EdgesT& revEdges)
+    {
+        for (auto& it : graph->getConstructedFunctions()) {
+            for (auto& nit : *it.second->getNodes()) {
+                LLVMNode *n = nit.second;
+                for (auto I = n->data_begin(), E = n->data_end(); I != E; ++I)
+                    edges.emplace(n->getValue(), (*I)->getValue());
+                for (auto I = n->rev_data_begin(), E = n->rev_data_end(); I != E; ++I)
+                    revEdges.emplace((*I)->getValue(), n->getValue());
+            }
+        }
+    }
+
+    void test()
+    {
+        const char *code =
+            "@g = global i32 0\n"
+            "define void @setg(i32* %p, i32 %x) {\n"
+            "entry:\n"
+            "  store i32 %x, i32* @g\n"
+            "  %v = load i32, i32* %p\n"
+            "  %w = add i32 %v, %x\n"
+            "  store i32 %w, i32* %p\n"
+            "  ret void\n"
+            "}\n"
+            "define i32 @main(i32 %x) {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 0, i32* %a\n"
+            "  br label %loop\n"
+            "loop:\n"
+            "  %i = phi i32 [0, %entry], [%i1, %loop]\n"
+            "  %v = load i32, i32* %a\n"
+            "  %s = add i32 %v, %i\n"
+            "  store i32 %s, i32* %a\n"
+            "  call void @setg(i32* %a, i32 %s)\n"
+            "  %i1 = add i32 %i, 1\n"
+            "  %c = icmp slt i32 %i1, %x\n"
+            "  br i1 %c, label %loop, label %out\n"
+            "out:\n"
+            "  %b = load i32, i32* %a\n"
+            "  %gv = load i32, i32* @g\n"
+            "  %r = add i32 %b, %gv\n"
+            "  ret i32 %r\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        // the edges inserted in bulk while building the graph
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        // the edges from reads of memory inserted one by one
+        // when materializing the postponed data dependencies
+        llvmdg::LLVMDependenceGraphOptions opts;
+        opts.lazyDataDependencies = true;
+        llvmdg::LLVMDependenceGraphBuilder lazyBuilder(M.get(), opts);
+        auto lazyGraph = lazyBuilder.build();
+        check(lazyGraph != nullptr, "failed building the graph");
+        if (!lazyGraph)
+            return;
+
+        for (auto& it : lazyGraph->getConstructedFunctions()) {
+            for (auto& nit : *it.second->getNodes())
+                it.second->materializeDataDependencies(nit.second);
+        }
+
+        EdgesT bulk, bulkRev, perEdge, perEdgeRev;
+        getDataEdges(graph.get(), bulk, bulkRev);
+        getDataEdges(lazyGraph.get(), perEdge, perEdgeRev);
+
+        check(!bulk.empty(), "no data dependence edges");
+        check(bulk == bulkRev, "the reverse edges do not match the edges");
+        check(bulk == perEdge, "the edges differ (%lu in bulk, %lu one by one)",
+              (unsigned long) bulk.size(), (unsigned long) perEdge.size());
+        check(perEdge == perEdgeRev, "the reverse edges do not match the edges");
+    }
+};
+
+struct TestUnreachableDefUse : public Test
+{
+    TestUnreachableDefUse() : Test("def-use edges in unreachable blocks test") {}
+
+    // the values that the node of 'val' is data dependent on
+    static std::set<llvm::Value *>
+    getDataSources(LLVMDependenceGraph *graph, const llvm::Value *val)
+    {
+        std::set<llvm::Value *> sources;
+        LLVMNode *n = graph->getNode(const_cast<llvm::Value *>(val));
+        if (!n)
+            return sources;
+        for (auto I = n->rev_data_begin(), E = n->rev_data_end(); I != E; ++I)
+            sources.insert((*I)->getValue());
+        return sources;
+    }
+
+    void test()
+    {
+        // the block %dead and the function @get that is called only
+        // from it are not reachable from the entry of @main
+        const char *code =
+            "@g = global i32 0\n"
+            "define i32 @get() {\n"
+            "entry:\n"
+            "  %v = load i32, i32* @g\n"
+            "  ret i32 %v\n"
+            "}\n"
+            "define i32 @main() {\n"
+            "entry:\n"
+            "  %a = alloca i32\n"
+            "  store i32 1, i32* %a\n"
+            "  store i32 2, i32* @g\n"
+            "  %la = load i32, i32* %a\n"
+            "  ret i32 %la\n"
+            "dead:\n"
+            "  %ld = load i32, i32* %a\n"
+            "  %r = call i32 @get()\n"
+            "  %s = add i32 %ld, %r\n"
+            "  ret i32 %s\n"
+            "}\n";
+
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic SMD;
+        auto buf = llvm::MemoryBuffer::getMemBuffer(code);
+        auto M = llvm::parseIR(buf->getMemBufferRef(), SMD, context);
+        check(M != nullptr, "failed parsing the module");
+        if (!M)
+            return;
+
+        llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+        auto graph = builder.build();
+        check(graph != nullptr, "failed building the graph");
+        if (!graph)
+            return;
+
+        auto *main = M->getFunction("main");
+        auto *get = M->getFunction("get");
+        auto la = getDataSources(graph.get(), getInstruction(main, "la"));
+        check(std::any_of(la.begin(), la.end(),
+                           [](llvm::Value *v) { return llvm::isa<llvm::StoreInst>(v); }),
+              "the load in the entry block does not depend on the store");
+        for (const char *name : {"ld", "r", "s"}) {
+            check(getDataSources(graph.get(), getInstruction(main, name)).empty(),
+                  "%%%s in the unreachable block has def-use edges", name);
+        }
+
+        auto& CF = graph->getConstructedFunctions();
+        auto it = CF.find(get);
+        if (it != CF.end()) {
+            check(getDataSources(it->second, getInstruction(get, "v")).empty(),
+                  "the load in the unreachable function has def-use edges");
+        }
+    }
+};
+
 }
 }
 
@@ -65,6 +1118,17 @@ int main(void)
     TestRunner Runner;
 
     Runner.add(new TestRefcount());
+    Runner.add(new TestSummaryEdges());
+    Runner.add(new TestContextSensitiveSlicing());
+    Runner.add(new TestBatchSlicing());
+    Runner.add(new TestSlicingUpdatesCD());
+    Runner.add(new TestSlicedCFG());
+    Runner.add(new TestDefinitionsAfterCalls());
+    Runner.add(new TestEagerPhiPlacement());
+    Runner.add(new TestModRefSummariesCache());
+    Runner.add(new TestLazyDataDependencies());
+    Runner.add(new TestBulkDefUseEdges());
+    Runner.add(new TestUnreachableDefUse());
 
     return Runner();
 }
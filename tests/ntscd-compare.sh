@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+# Compare the results and the running times of the ntscd and ntscd2
+# algorithms on the sources of the slicing tests. Run it from the build
+# directory (or set BUILDDIR), additional arguments are passed
+# to llvm-ntscd-dump (e.g., -pta). The sources are compiled with $CLANG
+# (or $CC, clang by default).
+
+CLANG="${CLANG:-${CC:-clang}}"
+SRCDIR="$(cd "$(dirname "$0")" && pwd)/slicing"
+BUILDDIR="${BUILDDIR:-$(pwd)}"
+DUMP="$BUILDDIR/tools/llvm-ntscd-dump"
+
+if [ ! -x "$DUMP" ]; then
+	echo "Did not find $DUMP, build the llvm-ntscd-dump target" >&2
+	exit 1
+fi
+
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+FAILED=0
+for SRC in "$SRCDIR"/sources/*.c; do
+	BC="$TMP/$(basename "${SRC%.c}").bc"
+	if ! "$CLANG" -include "$SRCDIR/test_assert.h" -emit-llvm -c "$SRC" -o "$BC" 2>/dev/null; then
+		echo "Failed compiling $SRC, skipping" >&2
+		continue
+	fi
+
+	echo "$(basename "$SRC"):"
+	"$DUMP" -compare -time "$@" "$BC" || FAILED=1
+done
+
+exit $FAILED
@@ -5,6 +5,9 @@
 #include "dg/PointerAnalysis/PointerGraph.h"
 #include "dg/PointerAnalysis/Pointer.h"
 
+#include <thread>
+#include <vector>
+
 using namespace dg::pta;
 
 template<typename PTSetT>
@@ -245,6 +248,70 @@ void testSmallOverflowBehavior() { //only works for SmallOffsetsPTSet
     REQUIRE(S.overflowSetSize() == 0);
 }
 
+template<typename PTSetT>
+void specialTargetsTest() {
+    PTSetT S;
+    PTSetT S2;
+    PointerGraph PS;
+    PSNode* A = PS.create(PSNodeType::ALLOC);
+
+    REQUIRE(S.add(Pointer(A, 0)) == true);
+    REQUIRE(!S.hasUnknown());
+    REQUIRE(!S.hasNull());
+    REQUIRE(!S.hasInvalidated());
+
+    REQUIRE(S.add(Pointer(PS.getUnknownMemory(), 0)) == true);
+    REQUIRE(S.add(Pointer(PS.getUnknownMemory(), 8)) == true);
+    REQUIRE(S.hasUnknown());
+    REQUIRE(S.remove({PS.getUnknownMemory(), 0}) == true);
+    REQUIRE(S.hasUnknown());
+    REQUIRE(S.remove({PS.getUnknownMemory(), 8}) == true);
+    REQUIRE(!S.hasUnknown());
+
+    REQUIRE(S2.add(Pointer(PS.getNull(), 0)) == true);
+    REQUIRE(S2.add(Pointer(PS.getInvalidated(), 0)) == true);
+    REQUIRE(S.add(S2));
+    REQUIRE(S.hasNull());
+    REQUIRE(S.hasInvalidated());
+    REQUIRE(S.removeAny(PS.getNull()) == true);
+    REQUIRE(!S.hasNull());
+    REQUIRE(S.hasInvalidated());
+
+    S.swap(S2);
+    REQUIRE(S.hasNull());
+    REQUIRE(!S2.hasNull());
+    S.clear();
+    REQUIRE(!S.hasNull());
+    REQUIRE(!S.hasInvalidated());
+}
+
+template<typename PTSetT>
+void moreThreadsTest() {
+    // every thread numbers the elements of the sets separately
+    auto fill = [](size_t *result) {
+        PointerGraph PS;
+        std::vector<PTSetT> sets(10);
+        for (unsigned i = 0; i < 200; ++i) {
+            PSNode* A = PS.create(PSNodeType::ALLOC);
+            for (auto& S : sets)
+                S.add(Pointer(A, 8 * (i % 4)));
+        }
+        *result = 0;
+        for (auto& S : sets)
+            *result += S.size();
+    };
+
+    size_t results[4];
+    std::vector<std::thread> threads;
+    for (auto& result : results)
+        threads.emplace_back(fill, &result);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto result : results)
+        REQUIRE(result == 10 * 200);
+}
+
 TEST_CASE("Querying empty set", "PointsToSet") {
     queryingEmptySet<OffsetsSetPointsToSet>();
     queryingEmptySet<SimplePointsToSet>();
@@ -332,6 +399,24 @@ TEST_CASE("Test various points-to functions", "PointsToSet") {
     pointsToTest<AlignedPointerIdPointsToSet>();
 }
 
+TEST_CASE("Track special targets", "PointsToSet") { //SeparateOffsetsPointsToSet has different remove behavior, it isn't tested here
+    specialTargetsTest<OffsetsSetPointsToSet>();
+    specialTargetsTest<SimplePointsToSet>();
+    specialTargetsTest<PointerIdPointsToSet>();
+    specialTargetsTest<SmallOffsetsPointsToSet>();
+    specialTargetsTest<AlignedSmallOffsetsPointsToSet>();
+    specialTargetsTest<AlignedPointerIdPointsToSet>();
+}
+
+TEST_CASE("Fill sets in more threads", "PointsToSet") {
+    moreThreadsTest<OffsetsSetPointsToSet>();
+    moreThreadsTest<SimplePointsToSet>();
+    moreThreadsTest<PointerIdPointsToSet>();
+    moreThreadsTest<SmallOffsetsPointsToSet>();
+    moreThreadsTest<AlignedSmallOffsetsPointsToSet>();
+    moreThreadsTest<AlignedPointerIdPointsToSet>();
+}
+
 TEST_CASE("Test small overflow set behavior", "PointsToSet") {
     testSmallOverflowBehavior<SmallOffsetsPointsToSet>();
 }
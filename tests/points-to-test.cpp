@@ -377,7 +377,7 @@ public:
 
         PointerGraph PS;
         PSNode *B = PS.create(PSNodeType::ALLOC);
-        PSNode *S = PS.create(PSNodeType::STORE, pta::NULLPTR, B);
+        PSNode *S = PS.create(PSNodeType::STORE, PS.getNull(), B);
         PSNode *L = PS.create(PSNodeType::LOAD, B);
 
         B->addSuccessor(S);
@@ -388,7 +388,7 @@ public:
         PTStoT PA(&PS);
         PA.run();
 
-        check(L->doesPointsTo(NULLPTR), "L do not points to NULL");
+        check(L->doesPointsTo(PS.getNull()), "L do not points to NULL");
     }
 
     void constant_store()
@@ -431,7 +431,7 @@ public:
         PTStoT PA(&PS);
         PA.run();
 
-        check(L->doesPointsTo(NULLPTR), "L do not points to nullptr");
+        check(L->doesPointsTo(PS.getNull()), "L do not points to nullptr");
     }
 
     void load_from_unknown_offset()
@@ -728,8 +728,8 @@ public:
         PTStoT PA(&PS);
         PA.run();
 
-        check(L1->doesPointsTo(NULLPTR), "L1 does not point to NULL");
-        check(L2->doesPointsTo(NULLPTR), "L2 does not point to NULL");
+        check(L1->doesPointsTo(PS.getNull()), "L1 does not point to NULL");
+        check(L2->doesPointsTo(PS.getNull()), "L2 does not point to NULL");
     }
 
     void memcpy_test5()
@@ -855,9 +855,9 @@ public:
         PTStoT PA(&PS);
         PA.run();
 
-        check(L1->doesPointsTo(NULLPTR), "L1 does not point to NULL");
-        check(L2->doesPointsTo(NULLPTR), "L2 does not point to NULL");
-        check(L3->doesPointsTo(NULLPTR), "L2 does not point to NULL");
+        check(L1->doesPointsTo(PS.getNull()), "L1 does not point to NULL");
+        check(L2->doesPointsTo(PS.getNull()), "L2 does not point to NULL");
+        check(L3->doesPointsTo(PS.getNull()), "L2 does not point to NULL");
     }
 
     void memcpy_test8()
@@ -904,8 +904,8 @@ public:
         PA.run();
 
         check(L1->doesPointsTo(A, 3), "L1 does not point A + 3");
-        check(L2->doesPointsTo(NULLPTR), "L2 does not point to NULL");
-        check(L3->doesPointsTo(NULLPTR), "L3 does not point to NULL");
+        check(L2->doesPointsTo(PS.getNull()), "L2 does not point to NULL");
+        check(L3->doesPointsTo(PS.getNull()), "L3 does not point to NULL");
     }
 
     void test()
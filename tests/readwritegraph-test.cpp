@@ -1,7 +1,12 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <set>
+#include <sstream>
+
 #include "dg/ReadWriteGraph/ReadWriteGraph.h"
+#include "dg/MemorySSA/ModRefSummaries.h"
+#include "dg/Dominators/DominatorTree.h"
 
 using namespace dg::dda;
 
@@ -93,3 +98,125 @@ TEST_CASE("split around in middle", "[RWBBlock]") {
     CHECK(blks.second->getSingleSuccessor() == &succ);
 }
 
+
+TEST_CASE("nodes and blocks indices", "[ReadWriteGraph]") {
+    ReadWriteGraph G;
+    auto& subg1 = G.createSubgraph();
+    auto& subg2 = G.createSubgraph();
+    CHECK(subg1.getIndex() == 0);
+    CHECK(subg2.getIndex() == 1);
+
+    auto& A = G.create(RWNodeType::STORE);
+    auto& C = G.create(RWNodeType::CALL);
+    auto& B = G.create(RWNodeType::LOAD);
+    REQUIRE(G.getNodesNum() == 3);
+    CHECK(G.getNode(A.getID()) == &A);
+    CHECK(G.getNode(B.getID()) == &B);
+    CHECK(G.getNode(C.getID()) == &C);
+    CHECK(RWNodeCall::get(&C) != nullptr);
+
+    auto& block = subg1.createBBlock();
+    block.append(&A);
+    block.append(&C);
+    block.append(&B);
+    CHECK(block.getIndex() == 0);
+    CHECK(subg2.createBBlock().getIndex() == 0);
+
+    // calls of defined functions get their own blocks
+    RWNodeCall::get(&C)->addCallee(&subg2);
+    subg1.splitBBlocksOnCalls();
+    REQUIRE(subg1.size() == 3);
+    unsigned idx = 0;
+    for (auto *bblock : subg1.bblocks()) {
+        CHECK(bblock->getIndex() == idx++);
+    }
+}
+
+TEST_CASE("write and read summaries", "[ModRefSummaries]") {
+    ModRefSummaries S;
+    ModRefSummaries::Summary sum;
+    sum.maydef.push_back({"@g", 0, 3, {"f#1", "f#4"}});
+    sum.mayref.push_back({"odd name:\n", 4, dg::Offset::UNKNOWN, {"f#2"}});
+    S.set("f", 42, std::move(sum));
+
+    std::stringstream ss;
+    S.write(ss);
+
+    ModRefSummaries R;
+    REQUIRE(R.read(ss));
+    CHECK(R.size() == 1);
+    CHECK(R.get("f", 43) == nullptr);
+
+    auto *rsum = R.get("f", 42);
+    REQUIRE(rsum != nullptr);
+    REQUIRE(rsum->maydef.size() == 1);
+    CHECK(rsum->maydef[0].target == "@g");
+    CHECK(*rsum->maydef[0].end == 3);
+    CHECK(rsum->maydef[0].nodes == std::vector<std::string>{"f#1", "f#4"});
+    REQUIRE(rsum->mayref.size() == 1);
+    CHECK(rsum->mayref[0].target == "odd name:\n");
+    CHECK(rsum->mayref[0].end.isUnknown());
+    CHECK(rsum->mustdef.empty());
+}
+
+TEST_CASE("new fingerprint evicts the summary", "[ModRefSummaries]") {
+    ModRefSummaries S;
+    S.set("f", 42, {});
+    S.set("f", 43, {});
+    S.set("g", 42, {});
+    CHECK(S.size() == 2);
+    CHECK(S.get("f", 42) == nullptr);
+    CHECK(S.get("f", 43) != nullptr);
+    CHECK(S.get("g", 42) != nullptr);
+}
+
+TEST_CASE("read malformed summaries", "[ModRefSummaries]") {
+    std::stringstream ss("fun 1:f 42 1 0 0\n2:@g 0\n");
+    ModRefSummaries R;
+    CHECK(!R.read(ss));
+}
+
+TEST_CASE("dominators and frontiers", "[Dominators]") {
+    //      A
+    //      |
+    //      B <---+
+    //     / \    |
+    //    C   D   |
+    //     \ /    |
+    //      E ----+
+    //      |
+    //      F
+    RWBBlock A, B, C, D, E, F, U;
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+    B.addSuccessor(&D);
+    C.addSuccessor(&E);
+    D.addSuccessor(&E);
+    E.addSuccessor(&B);
+    E.addSuccessor(&F);
+    // unreachable block
+    U.addSuccessor(&E);
+
+    dg::DominatorTree<RWBBlock> DT;
+    DT.compute(&A);
+
+    CHECK(DT.size() == 6);
+    CHECK(!DT.isReachable(&U));
+    CHECK(DT.getIDom(&A) == nullptr);
+    CHECK(DT.getIDom(&U) == nullptr);
+    CHECK(DT.getIDom(&B) == &A);
+    CHECK(DT.getIDom(&C) == &B);
+    CHECK(DT.getIDom(&D) == &B);
+    CHECK(DT.getIDom(&E) == &B);
+    CHECK(DT.getIDom(&F) == &E);
+
+    CHECK(DT.getFrontiers(&A).empty());
+    CHECK(DT.getFrontiers(&C) == std::vector<RWBBlock *>{&E});
+    CHECK(DT.getFrontiers(&E) == std::vector<RWBBlock *>{&B});
+    CHECK(DT.getFrontiers(&B) == std::vector<RWBBlock *>{&B});
+
+    auto IDF = DT.getIteratedFrontiers(std::vector<RWBBlock *>{&C});
+    std::set<RWBBlock *> idf(IDF.begin(), IDF.end());
+    CHECK(idf == std::set<RWBBlock *>{&B, &E});
+    CHECK(DT.getIteratedFrontiers(std::vector<RWBBlock *>{&F}).empty());
+}
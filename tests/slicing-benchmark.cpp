@@ -0,0 +1,253 @@
+#include <set>
+#include <array>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IRReader/IRReader.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/LLVMSlicer.h"
+#include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/LLVMDependenceGraphBuilder.h"
+#include "../tools/TimeMeasure.h"
+
+///
+// Compare the forward slicing that walks the graph twice
+// (Slicer::markForwardTwoWalks) with the integrated forward slicing
+// (ForwardWalkAndMark). Every call-site of the given functions
+// (or every call-site if no function is given) in the given modules
+// is used as a slicing criterion. The slices computed in both ways
+// must be the same, otherwise the benchmark fails.
+//
+// Usage: slicing-benchmark [-c fun1,fun2,...] [-n repeat] file.ll...
+//
+// See slicing-benchmark.sh for running it on the slicing tests.
+
+using namespace dg;
+
+static void addSliceNode(LLVMNode *n, uint32_t id, std::set<LLVMNode *>& ret)
+{
+    if (n && n->getSlice() == id)
+        ret.insert(n);
+}
+
+static void addSliceParams(LLVMDGParameters *params, uint32_t id,
+                           std::set<LLVMNode *>& ret)
+{
+    if (!params)
+        return;
+
+    for (auto& it : *params) {
+        addSliceNode(it.second.in, id, ret);
+        addSliceNode(it.second.out, id, ret);
+    }
+    for (auto I = params->global_begin(), E = params->global_end(); I != E; ++I) {
+        addSliceNode(I->second.in, id, ret);
+        addSliceNode(I->second.out, id, ret);
+    }
+    addSliceNode(params->getNoReturn(), id, ret);
+}
+
+// the nodes of all the graphs that are marked with 'id'
+static std::set<LLVMNode *> getSlice(LLVMDependenceGraph& dg, uint32_t id)
+{
+    std::set<LLVMNode *> ret;
+    for (auto& it : dg.getConstructedFunctions()) {
+        LLVMDependenceGraph *graph = it.second;
+        addSliceNode(graph->getEntry(), id, ret);
+        addSliceNode(graph->getExit(), id, ret);
+        addSliceParams(graph->getParameters(), id, ret);
+        for (auto& nit : *graph->getNodes()) {
+            addSliceNode(nit.second, id, ret);
+            addSliceParams(nit.second->getParameters(), id, ret);
+        }
+    }
+
+    if (auto globals = dg.getGlobalNodes()) {
+        for (auto& it : *globals)
+            addSliceNode(it.second, id, ret);
+    }
+
+    return ret;
+}
+
+static std::vector<LLVMNode *> getCriteria(LLVMDependenceGraph& dg,
+                                           const std::vector<std::string>& funs)
+{
+    std::vector<LLVMNode *> ret;
+    for (auto& it : dg.getConstructedFunctions()) {
+        for (auto& nit : *it.second->getNodes()) {
+            auto *C = llvm::dyn_cast<llvm::CallInst>(nit.second->getValue());
+            if (!C)
+                continue;
+
+            if (funs.empty()) {
+                ret.push_back(nit.second);
+                continue;
+            }
+
+            auto *F = C->getCalledFunction();
+            if (!F)
+                continue;
+            for (const auto& name : funs) {
+                if (F->getName() == name) {
+                    ret.push_back(nit.second);
+                    break;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+static std::vector<std::string> splitNames(const char *str)
+{
+    std::vector<std::string> ret;
+    std::string cur;
+    for (const char *c = str; *c; ++c) {
+        if (*c == ',') {
+            ret.push_back(cur);
+            cur.clear();
+        } else {
+            cur.push_back(*c);
+        }
+    }
+    if (!cur.empty())
+        ret.push_back(cur);
+    return ret;
+}
+
+static double usec(dg::debug::TimeMeasure& tm)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(tm.duration()).count();
+}
+
+// returns false if the slices differ
+static bool benchmarkModule(const char *file,
+                            const std::vector<std::string>& funs,
+                            unsigned repeat,
+                            double& twoWalksTime, double& integratedTime)
+{
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic SMD;
+    auto M = llvm::parseIRFile(file, SMD, context);
+    if (!M) {
+        SMD.print("slicing-benchmark", llvm::errs());
+        return false;
+    }
+
+    if (!M->getFunction("main")) {
+        std::cout << file << ": no main function, skipping\n";
+        return true;
+    }
+
+    llvmdg::LLVMDependenceGraphBuilder builder(M.get());
+    auto dg = builder.build();
+    auto criteria = getCriteria(*dg, funs);
+
+    llvmdg::LLVMSlicer slicer;
+    uint32_t id = 0;
+    unsigned nodes = 0;
+    bool same = true;
+    dg::debug::TimeMeasure tm;
+    double twoWalks = 0, integrated = 0;
+
+    for (LLVMNode *crit : criteria) {
+        std::array<LLVMNode *, 1> start{{crit}};
+        std::set<LLVMNode *> slice[2];
+
+        for (unsigned i = 0; i < repeat; ++i) {
+            ++id;
+            tm.start();
+            slicer.markForwardTwoWalks(start, id);
+            tm.stop();
+            twoWalks += usec(tm);
+        }
+        slice[0] = getSlice(*dg, id);
+
+        for (unsigned i = 0; i < repeat; ++i) {
+            ++id;
+            tm.start();
+            slicer.mark(start, id, true /* forward */);
+            tm.stop();
+            integrated += usec(tm);
+        }
+        slice[1] = getSlice(*dg, id);
+
+        nodes += slice[1].size();
+        if (slice[0] != slice[1]) {
+            std::cout << file << ": the slices differ for "
+                      << "the criterion " << crit->getID() << "\n";
+            same = false;
+        }
+    }
+
+    std::cout << file << ": " << criteria.size() << " criteria, "
+              << nodes << " nodes in slices, two walks "
+              << twoWalks / 1000 << " ms, integrated "
+              << integrated / 1000 << " ms\n";
+
+    twoWalksTime += twoWalks;
+    integratedTime += integrated;
+    return same;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> funs;
+    std::vector<const char *> files;
+    unsigned repeat = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            funs = splitNames(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++i]));
+        else
+            files.push_back(argv[i]);
+    }
+
+    if (files.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-c fun1,fun2,...] [-n repeat] file.ll...\n";
+        return 1;
+    }
+
+    bool same = true;
+    double twoWalks = 0, integrated = 0;
+    for (const char *file : files)
+        same &= benchmarkModule(file, funs, repeat, twoWalks, integrated);
+
+    std::cout << "Total: two walks " << twoWalks / 1000
+              << " ms, integrated " << integrated / 1000 << " ms\n";
+
+    if (!same) {
+        std::cout << "FAILED: the slices differ\n";
+        return 1;
+    }
+
+    return 0;
+}
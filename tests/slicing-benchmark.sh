@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# Compare the forward slicing that walks the graph twice with the
+# integrated forward slicing on the sources of the slicing tests.
+# Run it from the build directory (or set BUILDDIR), additional
+# arguments are passed to slicing-benchmark (e.g., -n 10). The sources
+# are compiled with $CLANG (or $CC, clang by default).
+
+set -e
+
+CLANG="${CLANG:-${CC:-clang}}"
+SRCDIR="$(cd "$(dirname "$0")" && pwd)/slicing"
+BUILDDIR="${BUILDDIR:-$(pwd)}"
+BENCHMARK="$BUILDDIR/tests/slicing-benchmark"
+
+if [ ! -x "$BENCHMARK" ]; then
+	echo "Did not find $BENCHMARK, build the slicing-benchmark target" >&2
+	exit 1
+fi
+
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+for SRC in "$SRCDIR"/sources/*.c; do
+	BC="$TMP/$(basename "${SRC%.c}").bc"
+	"$CLANG" -include "$SRCDIR/test_assert.h" -emit-llvm -c "$SRC" -o "$BC" \
+		2>/dev/null || echo "Failed compiling $SRC, skipping" >&2
+done
+
+"$BENCHMARK" "$@" "$TMP"/*.bc
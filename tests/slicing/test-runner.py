@@ -34,7 +34,7 @@ def parse_cmake_cache(cmakecache):
 configs = {
 #   '-dda': ['rd', 'ssa'],
     '-pta': ['fi', 'fs', 'inv'],
-    '-cd-alg': ['ntscd', 'classic'],
+    '-cd-alg': ['ntscd', 'ntscd2', 'classic'],
 }
 
 
@@ -110,6 +110,18 @@ def slice(bccode, args):
     return output
 
 
+def slice_modules(bccodes, args):
+    """ Slice the modules in one run of llvm-slicer with more threads """
+    cmd = ["llvm-slicer", "-c", "test_assert",
+           "-jobs={0}".format(len(bccodes))] + args + bccodes
+
+    if command(cmd) != 0:
+        error('Failed executing llvm-slicer')
+
+    # the sliced modules are stored next to the input modules
+    return [bccode[:-3] + ".sliced" for bccode in bccodes]
+
+
 def link(bccode, codes, output=None):
     if output is None:
         output = bccode + ".linked"
@@ -202,6 +214,20 @@ def _test_enabled(test, setup):
     return True
 
 
+def run_jobs_test(test, bccodes, linkafter, args):
+    toremove = []
+
+    for bccode in slice_modules(bccodes, args + test.addparams):
+        toremove.append(bccode)
+        bccode = link(bccode, linkafter)
+        toremove.append(bccode)
+
+        execute(bccode, test.expectedoutput)
+
+    for f in toremove:
+        unlink(f)
+
+
 def run_test(test, bccode, optafter, linkafter, args):
     toremove = []
 
@@ -271,17 +297,27 @@ if __name__ == "__main__":
     if linkbefore:
         bccode = link(bccode, linkbefore)
 
+    jobsmodules = [bccode] + [compile(join(SOURCESDIR, m),
+                                      params=t.compilerparams)
+                              for m in t.jobsmodules]
+
     # always link test_assert() after slicing
     assertbc = compile(join(SOURCESDIR, '..', 'test_assert.c'),
                        params=t.compilerparams)
     linkafter.append(assertbc)
 
+    def run(setup):
+        if t.jobsmodules:
+            run_jobs_test(t, jobsmodules, linkafter, setup)
+        else:
+            run_test(t, bccode[:], optafter, linkafter, setup)
+
     # RUN!
     args = argv[2:]
     if args:
         stdout.write("Executing setup: {0} ... {1}".format(" ".join(args),
                                                            "\n" if debug else ""))
-        run_test(t, bccode[:], optafter, linkafter, args)
+        run(args)
         print('OK!')
     else:
         for setup in get_variations():
@@ -291,7 +327,7 @@ if __name__ == "__main__":
 
             stdout.write("Executing setup: {0} ... {1}".format(" ".join(setup),
                                                                "\n" if debug else ""))
-            run_test(t, bccode[:], optafter, linkafter, setup)
+            run(setup)
             print('OK!')
 
     # cleanup
@@ -4,7 +4,8 @@ class Test:
                             optbefore = None, optafter = None,\
                             addparams = [], requiredparams = [],\
                             compilerparams = [],
-                            expectedoutput=None):
+                            expectedoutput=None,
+                            jobsmodules = []):
         self.source = src
         self.linkbefore = linkbefore
         self.linkafter = linkafter
@@ -14,6 +15,9 @@ class Test:
         self.requiredparams = requiredparams
         self.compilerparams = compilerparams
         self.expectedoutput = expectedoutput
+        # more modules that are sliced together with the source
+        # in one run of llvm-slicer (each in its own thread)
+        self.jobsmodules = jobsmodules
 
 tests = {
     'test1'                : Test('test1.c'),
@@ -224,5 +228,8 @@ tests = {
     'unknown-interproc2-a': Test('unknown-interproc2-a.c',
                                   linkafter=['glob_ptr-a.c']),
     'unknown-interproc3'  : Test('unknown-interproc3.c',
-                                  linkafter=['a_ptr.c'])
+                                  linkafter=['a_ptr.c']),
+    'jobs1'               : Test('pointers1.c',
+                                  jobsmodules=['unknownptr2.c', 'funcptr1.c',
+                                               'memset1.c'])
 }
@@ -5,7 +5,9 @@
 
 #include "dg/llvm/ThreadRegions/ControlFlowGraph.h"
 #include "dg/llvm/ThreadRegions/ThreadRegion.h"
+#include "dg/llvm/ThreadRegions/MayHappenInParallel.h"
 #include "../lib/llvm/ThreadRegions/include/Graphs/GraphBuilder.h"
+#include "../lib/llvm/ThreadRegions/include/Graphs/ThreadRegionsBuilder.h"
 #include "../lib/llvm/ThreadRegions/include/Nodes/Nodes.h"
 
 // ignore unused parameters in LLVM libraries
@@ -590,3 +592,74 @@ TEST_CASE("GraphBuilder build tests", "[GraphBuilder]") {
         REQUIRE(i == 2);
     }
 }
+
+TEST_CASE("May happen in parallel", "[MHP]") {
+    // main: entry -> before -> fork -> during -> join -> after -> exit
+    // thread: threadEntry -> work -> threadExit
+    std::unique_ptr<EntryNode> entry(createNode<NodeType::ENTRY>()),
+                               threadEntry(createNode<NodeType::ENTRY>());
+    std::unique_ptr<ExitNode> exit(createNode<NodeType::EXIT>()),
+                              threadExit(createNode<NodeType::EXIT>());
+    std::unique_ptr<ForkNode> fork(createNode<NodeType::FORK>());
+    std::unique_ptr<JoinNode> join(createNode<NodeType::JOIN>());
+    NodePtr before(createNode<NodeType::GENERAL>()),
+            during(createNode<NodeType::GENERAL>()),
+            after(createNode<NodeType::GENERAL>()),
+            work(createNode<NodeType::GENERAL>());
+
+    entry->addSuccessor(before.get());
+    before->addSuccessor(fork.get());
+    fork->addSuccessor(during.get());
+    during->addSuccessor(join.get());
+    join->addSuccessor(after.get());
+    after->addSuccessor(exit.get());
+
+    threadEntry->addSuccessor(work.get());
+    work->addSuccessor(threadExit.get());
+
+    fork->addForkSuccessor(threadEntry.get());
+    join->addCorrespondingFork(fork.get());
+    join->addJoinPredecessor(threadExit.get());
+
+    auto check = [&](bool loop) {
+        if (loop) {
+            during->addSuccessor(fork.get());
+        }
+
+        ThreadRegionsBuilder builder;
+        builder.build(entry.get());
+        auto regions = builder.threadRegions();
+        auto region = [&regions](Node *node) -> ThreadRegion * {
+            for (auto threadRegion : regions) {
+                if (threadRegion->nodes().count(node)) {
+                    return threadRegion;
+                }
+            }
+            return nullptr;
+        };
+
+        MayHappenInParallel mhp(regions);
+        REQUIRE(mhp.mayHappenInParallel(region(work.get()), region(during.get())));
+        REQUIRE(mhp.mayHappenInParallel(region(during.get()), region(work.get())));
+        REQUIRE(mhp.parallelRegions(region(during.get())).count(region(work.get())) == 1);
+        REQUIRE_FALSE(mhp.mayHappenInParallel(region(work.get()), region(before.get())));
+        REQUIRE_FALSE(mhp.mayHappenInParallel(region(during.get()), region(during.get())));
+        REQUIRE_FALSE(mhp.mayHappenInParallel(region(before.get()), region(after.get())));
+        REQUIRE(mhp.parallelRegions(region(before.get())).empty());
+        REQUIRE(mhp.inSameThreads(region(before.get()), region(after.get())));
+        REQUIRE_FALSE(mhp.inSameThreads(region(work.get()), region(after.get())));
+
+        // the join waits for the thread unless the fork can run
+        // again and create a thread that the join does not wait for
+        REQUIRE(mhp.mayHappenInParallel(region(work.get()), region(after.get())) == loop);
+        REQUIRE(mhp.mayHappenInParallel(region(work.get()), region(work.get())) == loop);
+    };
+
+    SECTION("Fork and join") {
+        check(false);
+    }
+
+    SECTION("Fork in a loop") {
+        check(true);
+    }
+}
@@ -1,4 +1,5 @@
 #include <set>
+#include <map>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -67,6 +68,16 @@ llvm::cl::opt<bool> todot("dot",
     llvm::cl::desc("Output in graphviz format (forced atm.)."),
     llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> compare_phi_placement("compare-phi-placement",
+    llvm::cl::desc("Compare on-demand and eager placement of phi nodes\n"
+                   "in MemorySSA instead of dumping (default=false)."),
+    llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> statistics("statistics",
+    llvm::cl::desc("Compute the definitions of all uses and print statistics\n"
+                   "about the read-write graph instead of dumping (default=false)."),
+    llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 static inline size_t count_ws(const std::string& str) {
     size_t n = 0;
     while (isspace(str[n])) {
@@ -132,6 +143,7 @@ static void printRWNodeType(enum RWNodeType type) {
         ELEM(RWNodeType::NOOP)
         ELEM(RWNodeType::GENERIC)
         ELEM(RWNodeType::NONE)
+        ELEM(RWNodeType::UNKNOWN_MEM)
         default:
             printf("!unknown RWNodeType!");
     };
@@ -176,7 +188,7 @@ protected:
             return;
         }
 
-        if (node == UNKNOWN_MEMORY) {
+        if (node->isUnknown()) {
             printf("unknown mem");
             return;
         }
@@ -630,6 +642,113 @@ dumpDefs(LLVMDataDependenceAnalysis *DDA, bool todot)
     }
 }
 
+using LLVMDefinitionsT
+    = std::map<const llvm::Value *, std::set<const llvm::Value *>>;
+
+// run the MemorySSA with on-demand or eager placement of phi nodes,
+// report the time and the number of phi nodes and return
+// the definitions of all uses in the module
+static LLVMDefinitionsT
+runPhiPlacement(llvm::Module *M, LLVMPointerAnalysis *PTA,
+                LLVMDataDependenceAnalysisOptions opts, bool eager)
+{
+    debug::TimeMeasure tm;
+    const char *mode = eager ? "eager" : "on-demand";
+
+    opts.eagerPhiPlacement = eager;
+    opts.modRefSummaries.clear();
+
+    LLVMDataDependenceAnalysis DDA(M, PTA, opts);
+    DDA.buildGraph();
+
+    tm.start();
+    DDA.run();
+    auto SSA = static_cast<MemorySSATransformation*>(DDA.getDDA()->getImpl());
+    SSA->computeAllDefinitions();
+    tm.stop();
+
+    std::string msg = std::string("INFO: Data dependence analysis with ")
+                      + mode + " phi placement took";
+    tm.report(msg);
+    llvm::errs() << "INFO: Created " << SSA->getPhisNum() << " phi nodes ("
+                 << mode << ")\n";
+
+    LLVMDefinitionsT defs;
+    for (auto& F : *M) {
+        for (auto& B : F) {
+            for (auto& I : B) {
+                if (!DDA.isUse(&I))
+                    continue;
+                auto& D = defs[&I];
+                for (auto *def : DDA.getLLVMDefinitions(&I))
+                    D.insert(def);
+            }
+        }
+    }
+
+    return defs;
+}
+
+static void
+comparePhiPlacement(llvm::Module *M, LLVMPointerAnalysis *PTA,
+                    const LLVMDataDependenceAnalysisOptions& opts)
+{
+    if (!opts.isSSA()) {
+        llvm::errs() << "The phi placement can be compared only for MemorySSA\n";
+        return;
+    }
+
+    auto ondemand = runPhiPlacement(M, PTA, opts, /* eager = */ false);
+    auto eager = runPhiPlacement(M, PTA, opts, /* eager = */ true);
+
+    unsigned differ = 0;
+    for (auto& it : ondemand) {
+        if (eager[it.first] != it.second) {
+            llvm::errs() << "Definitions differ for: " << *it.first << "\n";
+            ++differ;
+        }
+    }
+
+    llvm::errs() << "INFO: Definitions of " << differ << " of "
+                 << ondemand.size() << " uses differ\n";
+}
+
+static void dumpStatistics(LLVMDataDependenceAnalysis *DDA)
+{
+    auto *graph = DDA->getGraph();
+
+    size_t blocks = 0;
+    for (auto *subg : graph->subgraphs())
+        blocks += subg->size();
+
+    size_t phis = 0, calls = 0, defuse = 0, defsites = 0;
+    for (unsigned id = 1; id <= graph->getNodesNum(); ++id) {
+        auto *nd = graph->getNode(id);
+        if (nd->isPhi())
+            ++phis;
+        if (nd->isCall())
+            ++calls;
+        for (auto *def : nd->defuse) {
+            (void) def;
+            ++defuse;
+        }
+        defsites += nd->annotations.defs.size()
+                    + nd->annotations.overwrites.size()
+                    + nd->annotations.uses.size();
+    }
+
+    llvm::errs() << "INFO: Subgraphs: " << graph->size()
+                 << ", blocks: " << blocks
+                 << ", nodes: " << graph->getNodesNum()
+                 << " (phi: " << phis << ", call: " << calls << ")\n";
+    llvm::errs() << "INFO: Def-use edges: " << defuse
+                 << ", def sites: " << defsites << "\n";
+    llvm::errs() << "INFO: Memory of nodes: "
+                 << graph->getNodesMemory() / 1024 << " kB"
+                 << " (sizeof(RWNode) = " << sizeof(RWNode)
+                 << ", sizeof(RWNodeCall) = " << sizeof(RWNodeCall) << ")\n";
+}
+
 std::unique_ptr<llvm::Module> parseModule(llvm::LLVMContext& context,
                                           const SlicerOptions& options)
 {
@@ -681,6 +800,11 @@ int main(int argc, char *argv[])
     tm.stop();
     tm.report("INFO: Pointer analysis took");
 
+    if (compare_phi_placement) {
+        comparePhiPlacement(M.get(), &PTA, options.dgOptions.DDAOptions);
+        return 0;
+    }
+
     tm.start();
     LLVMDataDependenceAnalysis DDA(M.get(), &PTA, options.dgOptions.DDAOptions);
     if (graph_only) {
@@ -691,6 +815,28 @@ int main(int argc, char *argv[])
     tm.stop();
     tm.report("INFO: Data dependence analysis took");
 
+    if (statistics) {
+        if (!graph_only && options.dgOptions.DDAOptions.isSSA()) {
+            tm.start();
+            auto SSA = static_cast<MemorySSATransformation*>(DDA.getDDA()->getImpl());
+            SSA->computeAllDefinitions();
+            tm.stop();
+            tm.report("INFO: Computing all definitions took");
+        }
+
+        dumpStatistics(&DDA);
+        return 0;
+    }
+
+    if (!graph_only && !options.dgOptions.DDAOptions.modRefSummaries.empty()) {
+        llvm::errs() << "INFO: Reused " << DDA.getReusedModRefSummaries()
+                     << " mod/ref summaries\n";
+        if (!DDA.storeModRefSummaries()) {
+            llvm::errs() << "Failed storing mod/ref summaries into "
+                         << options.dgOptions.DDAOptions.modRefSummaries << "\n";
+        }
+    }
+
     dumpDefs(&DDA, todot);
 
     return 0;
@@ -55,6 +55,34 @@
 using namespace dg;
 using llvm::errs;
 
+static void dumpStatistics(const LLVMDependenceGraph *dg)
+{
+    size_t nodes = 0, edges = 0, edgesMemory = 0;
+    dg->forEachNode([&](LLVMNode *n) {
+        ++nodes;
+        // count every edge once (only the forward direction)
+        edges += n->getControlDependenciesNum()
+                 + n->getDataDependenciesNum()
+                 + n->getUseDependenciesNum();
+        edgesMemory += n->getEdgesMemoryUsage();
+    });
+
+    size_t nodesMemory = nodes * sizeof(LLVMNode);
+    errs() << "Nodes: " << nodes << ", dependence edges: " << edges << "\n";
+#ifdef DG_VECTOR_EDGES
+    errs() << "Edges are stored in sorted vectors\n";
+#else
+    errs() << "Edges are stored in sets\n";
+#endif
+    errs() << "Memory of nodes: " << nodesMemory << " B ("
+           << sizeof(LLVMNode) << " B per node)\n";
+    errs() << "Memory of edges: " << edgesMemory << " B ("
+           << (nodes ? edgesMemory / nodes : 0) << " B per node)\n";
+    errs() << "Total: " << nodesMemory + edgesMemory << " B ("
+           << (nodes ? (nodesMemory + edgesMemory) / nodes : 0)
+           << " B per node)\n";
+}
+
 int main(int argc, char *argv[])
 {
     llvm::Module *M;
@@ -63,6 +91,7 @@ int main(int argc, char *argv[])
     bool mark_only = false;
     bool bb_only = false;
     bool threads = false;
+    bool statistics = false;
     const char *module = nullptr;
     const char *slicing_criterion = nullptr;
     const char *dump_func_only = nullptr;
@@ -108,6 +137,8 @@ int main(int argc, char *argv[])
             slicing_criterion = argv[++i];
         } else if (strcmp(argv[i], "-threads") == 0) {
             threads = true;
+        } else if (strcmp(argv[i], "-statistics") == 0) {
+            statistics = true;
         } else if (strcmp(argv[i], "-entry") == 0) {
             entry_func = argv[++i];
         } else if (strcmp(argv[i], "-cd-alg") == 0) {
@@ -118,6 +149,8 @@ int main(int argc, char *argv[])
                 cd_alg = LLVMControlDependenceAnalysisOptions::CDAlgorithm::STANDARD;
             else if (strcmp(arg, "ntscd") == 0)
                 cd_alg = LLVMControlDependenceAnalysisOptions::CDAlgorithm::NTSCD;
+            else if (strcmp(arg, "ntscd2") == 0)
+                cd_alg = LLVMControlDependenceAnalysisOptions::CDAlgorithm::NTSCD2;
             else {
                 errs() << "Invalid control dependencies algorithm, try: classic, ce\n";
                 abort();
@@ -172,6 +205,8 @@ int main(int argc, char *argv[])
     llvmdg::LLVMDependenceGraphBuilder builder(M, options);
     auto dg = builder.build();
 
+    if (statistics)
+        dumpStatistics(dg.get());
 
     std::set<LLVMNode *> callsites;
     if (slicing_criterion) {
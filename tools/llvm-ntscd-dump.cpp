@@ -3,6 +3,8 @@
 
 #include "../lib/llvm/ControlDependence/GraphBuilder.h"
 #include "../lib/llvm/ControlDependence/NTSCD.h"
+#include "../lib/llvm/ControlDependence/Block.h"
+#include "TimeMeasure.h"
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -26,6 +28,100 @@
 #endif
 
 #include <fstream>
+#include <map>
+#include <set>
+#include <utility>
+
+using dg::llvmdg::Block;
+using CDAlgorithm = dg::ControlDependenceAnalysisOptions::CDAlgorithm;
+
+// a key of the block that does not depend on the instance of the analysis:
+// the first instruction of the block, the call for the call-return block
+// or the function for the exit block
+static std::pair<const llvm::Value *, int> blockKey(const Block *block) {
+    if (!block->isArtificial())
+        return {block->llvmInstructions().front(), 0};
+
+    if (block->predecessors().empty())
+        return {nullptr, 2};
+
+    auto *predecessor = *block->predecessors().begin();
+    if (block->isCallReturn())
+        return {predecessor->llvmInstructions().front(), 1};
+    return {predecessor->llvmBlock()->getParent(), 2};
+}
+
+using Dependencies = std::set<std::pair<std::pair<const llvm::Value *, int>,
+                                        std::pair<const llvm::Value *, int>>>;
+
+static Dependencies getDependencies(const dg::llvmdg::NTSCD& analysis) {
+    Dependencies ret;
+    for (const auto& it : analysis.controlDependencies()) {
+        for (auto *dependent : it.second)
+            ret.emplace(blockKey(it.first), blockKey(dependent));
+    }
+    return ret;
+}
+
+static void computeDependencies(dg::llvmdg::NTSCD& analysis, bool time,
+                                const char *name) {
+    dg::debug::TimeMeasure tm;
+    tm.start();
+    analysis.computeDependencies();
+    tm.stop();
+    if (time)
+        tm.report(std::string("INFO: Computing ") + name + " took");
+}
+
+static void dumpKey(const std::pair<const llvm::Value *, int>& key) {
+    if (!key.first)
+        llvm::errs() << "<unknown>";
+    else if (key.second == 2)
+        llvm::errs() << "exit of " << key.first->getName();
+    else
+        llvm::errs() << *key.first << (key.second == 1 ? " (call return)" : "");
+}
+
+// compute the dependencies with both algorithms,
+// return false if they differ
+static bool compare(const llvm::Module *M, dg::LLVMPointerAnalysis *PTA, bool time) {
+    dg::LLVMControlDependenceAnalysisOptions opts;
+    opts.algorithm = CDAlgorithm::NTSCD;
+    dg::llvmdg::NTSCD ntscd(M, opts, PTA);
+    computeDependencies(ntscd, time, "ntscd");
+
+    opts.algorithm = CDAlgorithm::NTSCD2;
+    dg::llvmdg::NTSCD ntscd2(M, opts, PTA);
+    computeDependencies(ntscd2, time, "ntscd2");
+
+    auto deps = getDependencies(ntscd);
+    auto deps2 = getDependencies(ntscd2);
+    if (deps == deps2) {
+        llvm::errs() << "The dependencies are the same ("
+                     << deps.size() << " edges)\n";
+        return true;
+    }
+
+    for (auto& dep : deps) {
+        if (deps2.count(dep) == 0) {
+            llvm::errs() << "Only ntscd: ";
+            dumpKey(dep.first);
+            llvm::errs() << " -> ";
+            dumpKey(dep.second);
+            llvm::errs() << "\n";
+        }
+    }
+    for (auto& dep : deps2) {
+        if (deps.count(dep) == 0) {
+            llvm::errs() << "Only ntscd2: ";
+            dumpKey(dep.first);
+            llvm::errs() << " -> ";
+            dumpKey(dep.second);
+            llvm::errs() << "\n";
+        }
+    }
+    return false;
+}
 
 int main(int argc, const char *argv[]) {
     using namespace std;
@@ -48,6 +144,26 @@ int main(int argc, const char *argv[]) {
     llvm::cl::opt<bool> withpta("pta",
                                 llvm::cl::desc("Run pointer analysis to ger reachable functions (default=false)."),
                                 llvm::cl::init(false));
+
+    llvm::cl::opt<CDAlgorithm> algorithm("cda",
+        llvm::cl::desc("Choose the algorithm for computing NTSCD:"),
+        llvm::cl::values(
+            clEnumValN(CDAlgorithm::NTSCD, "ntscd", "The original algorithm (default)"),
+            clEnumValN(CDAlgorithm::NTSCD2, "ntscd2", "The algorithm that visits only the relevant blocks")
+    #if LLVM_VERSION_MAJOR < 4
+            , nullptr
+    #endif
+             ),
+        llvm::cl::init(CDAlgorithm::NTSCD));
+
+    llvm::cl::opt<bool> comparealgs("compare",
+                                llvm::cl::desc("Compute the dependencies with both algorithms and compare\n"
+                                               "the results instead of dumping them (default=false)."),
+                                llvm::cl::init(false));
+
+    llvm::cl::opt<bool> reportTime("time",
+                                llvm::cl::desc("Report the time of computing the dependencies (default=false)."),
+                                llvm::cl::init(false));
     llvm::LLVMContext context;
     llvm::SMDiagnostic SMD;
 
@@ -77,8 +193,15 @@ int main(int argc, const char *argv[]) {
         PTA->run();
     }
 
-    dg::llvmdg::NTSCD controlDependencyAnalysis(M.get(), {}, PTA.get());
-    controlDependencyAnalysis.run();
+    if (comparealgs) {
+        return compare(M.get(), PTA.get(), reportTime) ? 0 : 1;
+    }
+
+    dg::LLVMControlDependenceAnalysisOptions opts;
+    opts.algorithm = algorithm;
+    dg::llvmdg::NTSCD controlDependencyAnalysis(M.get(), opts, PTA.get());
+    computeDependencies(controlDependencyAnalysis, reportTime,
+                        algorithm == CDAlgorithm::NTSCD2 ? "ntscd2" : "ntscd");
 
     if (graphVizFileName == "") {
         controlDependencyAnalysis.dump(std::cout);
@@ -207,8 +207,8 @@ static AliasResult doAlias(DGLLVMPointerAnalysis *pta,
     }
     return MayAlias;
   }
-  Pointer ptr1(UNKNOWN_MEMORY, Offset::UNKNOWN);
-  Pointer ptr2(UNKNOWN_MEMORY, Offset::UNKNOWN);
+  Pointer ptr1 = pta->getPS()->getUnknownPointer();
+  Pointer ptr2 = pta->getPS()->getUnknownPointer();
   if (count1 == 0 && count2 == 0) {
     return NoAlias;
   }
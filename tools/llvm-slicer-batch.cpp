@@ -0,0 +1,226 @@
+#include <set>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+
+#ifndef HAVE_LLVM
+#error "This code needs LLVM enabled"
+#endif
+
+#include <llvm/Config/llvm-config.h>
+
+// ignore unused parameters in LLVM libraries
+#if (__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/raw_ostream.h>
+
+#if (__clang__)
+#pragma clang diagnostic pop // ignore -Wunused-parameter
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include "dg/llvm/LLVMNode.h"
+#include "dg/llvm/LLVMDependenceGraph.h"
+
+using namespace dg;
+
+namespace {
+
+// position of an instruction in the module
+struct InstPosition {
+    unsigned function{std::numeric_limits<unsigned>::max()};
+    unsigned index{0};
+    unsigned line{0};
+
+    bool operator<(const InstPosition& rhs) const {
+        return function == rhs.function ? index < rhs.index
+                                        : function < rhs.function;
+    }
+};
+
+class InstPositions {
+    std::vector<const llvm::Function *> _functions;
+    std::unordered_map<const llvm::Value *, InstPosition> _positions;
+
+public:
+    InstPositions(const llvm::Module *M) {
+        for (const llvm::Function& F : *M) {
+            if (F.isDeclaration())
+                continue;
+
+            InstPosition pos;
+            pos.function = _functions.size();
+            _functions.push_back(&F);
+            for (const llvm::BasicBlock& B : F) {
+                for (const llvm::Instruction& I : B) {
+                    const auto& Loc = I.getDebugLoc();
+                    pos.line = Loc ? Loc.getLine() : 0;
+                    _positions.emplace(&I, pos);
+                    ++pos.index;
+                }
+            }
+        }
+    }
+
+    const InstPosition *get(const llvm::Value *val) const {
+        auto it = _positions.find(val);
+        return it == _positions.end() ? nullptr : &it->second;
+    }
+
+    llvm::StringRef getFunctionName(const InstPosition& pos) const {
+        assert(pos.function < _functions.size());
+        return _functions[pos.function]->getName();
+    }
+};
+
+std::string escapeJSON(llvm::StringRef str) {
+    std::string ret;
+    ret.reserve(str.size());
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            ret.push_back('\\');
+            ret.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            ret += buf;
+        } else {
+            ret.push_back(c);
+        }
+    }
+    return ret;
+}
+
+// function names in CSV are always quoted
+std::string escapeCSV(llvm::StringRef str) {
+    std::string ret = "\"";
+    for (char c : str) {
+        if (c == '"')
+            ret.push_back('"');
+        ret.push_back(c);
+    }
+    ret.push_back('"');
+    return ret;
+}
+
+} // anonymous namespace
+
+// Sort the slicing criteria nodes by their position in the module,
+// so that the numbers of the slices do not depend on the addresses
+// of the nodes.
+std::vector<LLVMNode *> sortBatchCriteria(llvm::Module *M,
+                                          const std::set<LLVMNode *>& nodes)
+{
+    InstPositions positions(M);
+    std::vector<LLVMNode *> ret(nodes.begin(), nodes.end());
+    // nodes that are not instructions (e.g., globals) go last
+    // in the order in which we got them
+    std::stable_sort(ret.begin(), ret.end(),
+        [&positions](LLVMNode *a, LLVMNode *b) {
+            static const InstPosition none;
+            const auto *pa = positions.get(a->getValue());
+            const auto *pb = positions.get(b->getValue());
+            return (pa ? *pa : none) < (pb ? *pb : none);
+        });
+
+    return ret;
+}
+
+///
+// Write the instructions that are in the slices computed by
+// the batch slicing, 'slices' are the nodes of every slice as they
+// are kept in the sliced modules. The format of the report is CSV if the name
+// of the file ends with .csv, otherwise it is JSON.
+// Instructions are identified by the function and their index
+// in the function (counted from 0 in the order of basic blocks).
+bool writeBatchReport(const std::string& file,
+                      LLVMDependenceGraph& dg,
+                      const std::vector<std::vector<LLVMNode *>>& nodes,
+                      const std::vector<LLVMNode *>& criteria)
+{
+    InstPositions positions(dg.getModule());
+
+    // gather the instructions in the slices
+    std::vector<std::vector<InstPosition>> slices(nodes.size());
+    for (unsigned c = 0; c < nodes.size(); ++c) {
+        for (LLVMNode *nd : nodes[c]) {
+            if (const auto *pos = positions.get(nd->getValue()))
+                slices[c].push_back(*pos);
+        }
+
+        std::sort(slices[c].begin(), slices[c].end());
+    }
+
+    std::ofstream ofs(file);
+    if (!ofs.is_open()) {
+        llvm::errs() << "[llvm-slicer] Failed opening file for the report: "
+                     << file << "\n";
+        return false;
+    }
+
+    llvm::errs() << "[llvm-slicer] Saving the batch report to: " << file << "\n";
+
+    bool csv = file.size() >= 4 && file.compare(file.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        ofs << "slice,criterion_function,criterion_instruction,function,instruction,line\n";
+        for (unsigned c = 0; c < slices.size(); ++c) {
+            const auto *cpos = positions.get(criteria[c]->getValue());
+            std::string cfun = cpos ? escapeCSV(positions.getFunctionName(*cpos)) : "";
+            std::string cidx = cpos ? std::to_string(cpos->index) : "";
+
+            for (const auto& pos : slices[c]) {
+                ofs << c << "," << cfun << "," << cidx << ","
+                    << escapeCSV(positions.getFunctionName(pos)) << ","
+                    << pos.index << "," << pos.line << "\n";
+            }
+        }
+
+        return ofs.good();
+    }
+
+    ofs << "{\n  \"module\": \""
+        << escapeJSON(dg.getModule()->getModuleIdentifier()) << "\",\n"
+        << "  \"slices\": [";
+    for (unsigned c = 0; c < slices.size(); ++c) {
+        ofs << (c == 0 ? "\n" : ",\n");
+        ofs << "    {\n      \"id\": " << c << ",\n      \"criterion\": ";
+        if (const auto *cpos = positions.get(criteria[c]->getValue())) {
+            ofs << "{\"function\": \""
+                << escapeJSON(positions.getFunctionName(*cpos))
+                << "\", \"instruction\": " << cpos->index
+                << ", \"line\": " << cpos->line << "}";
+        } else {
+            ofs << "{\"value\": \""
+                << escapeJSON(criteria[c]->getValue()->getName()) << "\"}";
+        }
+
+        ofs << ",\n      \"size\": " << slices[c].size()
+            << ",\n      \"instructions\": [";
+        bool first = true;
+        for (const auto& pos : slices[c]) {
+            ofs << (first ? "\n" : ",\n");
+            first = false;
+            ofs << "        {\"function\": \""
+                << escapeJSON(positions.getFunctionName(pos))
+                << "\", \"instruction\": " << pos.index
+                << ", \"line\": " << pos.line << "}";
+        }
+        ofs << (first ? "]\n    }" : "\n      ]\n    }");
+    }
+    ofs << (slices.empty() ? "]\n}\n" : "\n  ]\n}\n");
+
+    return ofs.good();
+}
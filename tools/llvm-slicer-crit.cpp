@@ -1,7 +1,9 @@
+#include <map>
 #include <set>
 #include <vector>
 #include <string>
 #include <cassert>
+#include <unordered_map>
 
 #ifndef HAVE_LLVM
 #error "This code needs LLVM enabled"
@@ -44,98 +46,91 @@ using namespace dg;
 
 using llvm::errs;
 
-// mapping of AllocaInst to the names of C variables
-static std::map<const llvm::Value *, std::string> valuesToVariables;
-
-static bool usesTheVariable(LLVMDependenceGraph& dg,
-                            const llvm::Value *v,
-                            const std::string& var)
-{
-    auto pts = dg.getPTA()->getLLVMPointsTo(v);
-    if (pts.empty() || pts.hasUnknown())
-        return true; // it may be a definition of the variable, we do not know
-
-    for (const auto& ptr : pts) {
-        auto name = valuesToVariables.find(ptr.value);
-        if (name != valuesToVariables.end()) {
-            if (name->second == var)
-                return true;
+///
+// The index of the instructions and the variables that the slicing
+// criteria with lines and variables can refer to. It is built in one
+// pass over the constructed functions, so that matching the criteria
+// consists of lookups and the points-to sets are queried only
+// for the loads and stores on the lines from the criteria.
+class CriteriaIndex {
+    // the nodes of the loads and stores on the lines
+    std::unordered_map<unsigned, std::vector<LLVMNode *>> _lines;
+    // values (allocas, globals, ...) with the names of C variables
+    std::unordered_map<std::string, std::set<const llvm::Value *>> _variables;
+    // global variables by their names
+    std::unordered_map<std::string, const llvm::GlobalVariable *> _globals;
+    bool _hasDbg{false};
+
+public:
+    CriteriaIndex(LLVMDependenceGraph& dg) {
+#if (LLVM_VERSION_MAJOR > 3 || LLVM_VERSION_MINOR >= 7)
+        // the mapping from LLVM values to C variable names
+        std::map<const llvm::Value *, std::string> valuesToVariables;
+        for (auto& it : dg.getConstructedFunctions()) {
+            for (auto& I : llvm::instructions(*llvm::cast<llvm::Function>(it.first))) {
+                if (const llvm::DbgDeclareInst *DD = llvm::dyn_cast<llvm::DbgDeclareInst>(&I)) {
+                    auto val = DD->getAddress();
+                    valuesToVariables[val] = DD->getVariable()->getName().str();
+                } else if (const llvm::DbgValueInst *DV
+                            = llvm::dyn_cast<llvm::DbgValueInst>(&I)) {
+                    auto val = DV->getValue();
+                    valuesToVariables[val] = DV->getVariable()->getName().str();
+                } else if (llvm::isa<llvm::LoadInst>(&I) ||
+                           llvm::isa<llvm::StoreInst>(&I)) {
+                    auto& Loc = I.getDebugLoc();
+                    LLVMNode *nd = it.second->getNode(&I);
+                    if (Loc && nd)
+                        _lines[Loc.getLine()].push_back(nd);
+                }
+            }
         }
-    }
-
-    return false;
-}
-
-template <typename InstT>
-static bool useOfTheVar(LLVMDependenceGraph& dg,
-                        const llvm::Instruction& I,
-                        const std::string& var)
-{
-    // check that we store to that variable
-    const InstT *tmp = llvm::dyn_cast<InstT>(&I);
-    if (!tmp)
-        return false;
-
-    return usesTheVariable(dg, tmp->getPointerOperand(), var);
-}
-
-static bool isStoreToTheVar(LLVMDependenceGraph& dg,
-                            const llvm::Instruction& I,
-                            const std::string& var)
-{
-    return useOfTheVar<llvm::StoreInst>(dg, I, var);
-}
-
-static bool isLoadOfTheVar(LLVMDependenceGraph& dg,
-                           const llvm::Instruction& I,
-                           const std::string& var)
-{
-    return useOfTheVar<llvm::LoadInst>(dg, I, var);
-}
 
+        _hasDbg = !valuesToVariables.empty();
+        for (const auto& GV : dg.getModule()->globals()) {
+            valuesToVariables[&GV] = GV.getName().str();
+            _globals.emplace(GV.getName().str(), &GV);
+        }
 
-static bool instMatchesCrit(LLVMDependenceGraph& dg,
-                            const llvm::Instruction& I,
-                            const std::vector<std::pair<int, std::string>>& parsedCrit)
-{
-    for (const auto& c : parsedCrit) {
-        auto& Loc = I.getDebugLoc();
-#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR < 7)
-        if (Loc.getLine() <= 0) {
+        for (auto& it : valuesToVariables)
+            _variables[it.second].insert(it.first);
 #else
-        if (!Loc) {
+        (void) dg;
 #endif
-            continue;
-        }
+    }
 
-        if (static_cast<int>(Loc.getLine()) != c.first)
-            continue;
+    bool hasDebugInfo() const { return _hasDbg; }
 
-        if (isStoreToTheVar(dg, I, c.second) ||
-            isLoadOfTheVar(dg, I, c.second)) {
-            llvm::errs() << "Matched line " << c.first << " with variable "
-                         << c.second << " to:\n" << I << "\n";
-            return true;
-        }
+    const llvm::GlobalVariable *getGlobal(const std::string& name) const {
+        auto it = _globals.find(name);
+        return it == _globals.end() ? nullptr : it->second;
     }
 
-    return false;
-}
+    const std::vector<LLVMNode *> *getLine(unsigned line) const {
+        auto it = _lines.find(line);
+        return it == _lines.end() ? nullptr : &it->second;
+    }
 
-static bool globalMatchesCrit(const llvm::GlobalVariable& G,
-                              const std::vector<std::pair<int, std::string>>& parsedCrit)
-{
-    for (const auto& c : parsedCrit) {
-        if (c.first != -1)
-            continue;
-        if (c.second == G.getName().str()) {
-            llvm::errs() << "Matched global variable "
-                         << c.second << " to:\n" << G << "\n";
-            return true;
+    // can a pointer that points to 'targets' point to the variable?
+    bool mayPointTo(const std::vector<const llvm::Value *>& targets,
+                    const std::string& var) const {
+        auto it = _variables.find(var);
+        if (it == _variables.end())
+            return false;
+
+        for (const llvm::Value *target : targets) {
+            if (it->second.count(target) > 0)
+                return true;
         }
+
+        return false;
     }
+};
 
-    return false;
+static const llvm::Value *getPointerOperand(const llvm::Instruction *I)
+{
+    if (auto *S = llvm::dyn_cast<llvm::StoreInst>(I))
+        return S->getPointerOperand();
+    return llvm::cast<llvm::LoadInst>(I)->getPointerOperand();
 }
 
 static inline bool isNumber(const std::string& s) {
@@ -175,25 +170,18 @@ static void getLineCriteriaNodes(LLVMDependenceGraph& dg,
 
     assert(!parsedCrit.empty() && "Failed parsing criteria");
 
+    // the variables from the criteria for every line
+    std::map<int, std::set<std::string>> lineCrit;
+    for (const auto& c : parsedCrit)
+        lineCrit[c.first].insert(c.second);
+
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR < 7)
     llvm::errs() << "WARNING: Variables names matching is not supported for LLVM older than 3.7\n";
     llvm::errs() << "WARNING: The slicing criteria with variables names will not work\n";
 #else
-    // create the mapping from LLVM values to C variable names
-    for (auto& it : getConstructedFunctions()) {
-        for (auto& I : llvm::instructions(*llvm::cast<llvm::Function>(it.first))) {
-            if (const llvm::DbgDeclareInst *DD = llvm::dyn_cast<llvm::DbgDeclareInst>(&I)) {
-                auto val = DD->getAddress();
-                valuesToVariables[val] = DD->getVariable()->getName().str();
-            } else if (const llvm::DbgValueInst *DV
-                        = llvm::dyn_cast<llvm::DbgValueInst>(&I)) {
-                auto val = DV->getValue();
-                valuesToVariables[val] = DV->getVariable()->getName().str();
-            }
-        }
-    }
+    CriteriaIndex index(dg);
 
-    bool no_dbg = valuesToVariables.empty();
+    bool no_dbg = !index.hasDebugInfo();
     if (no_dbg) {
         llvm::errs() << "No debugging information found in program,\n"
                      << "slicing criteria with lines and variables will work\n"
@@ -201,16 +189,17 @@ static void getLineCriteriaNodes(LLVMDependenceGraph& dg,
                      << "You can still use the criteria based on call sites ;)\n";
     }
 
-    for (const auto& GV : dg.getModule()->globals()) {
-        valuesToVariables[&GV] = GV.getName().str();
-    }
-
     // try match globals
-    for (auto& G : dg.getModule()->globals()) {
-        if (globalMatchesCrit(G, parsedCrit)) {
-            LLVMNode *nd = dg.getGlobalNode(&G);
-            assert(nd);
-            nodes.insert(nd);
+    auto globalCrit = lineCrit.find(-1);
+    if (globalCrit != lineCrit.end()) {
+        for (const auto& var : globalCrit->second) {
+            if (const auto *G = index.getGlobal(var)) {
+                llvm::errs() << "Matched global variable "
+                             << var << " to:\n" << *G << "\n";
+                LLVMNode *nd = dg.getGlobalNode(const_cast<llvm::GlobalVariable *>(G));
+                assert(nd);
+                nodes.insert(nd);
+            }
         }
     }
 
@@ -220,12 +209,32 @@ static void getLineCriteriaNodes(LLVMDependenceGraph& dg,
     }
 
     // map line criteria to nodes
-    for (auto& it : getConstructedFunctions()) {
-        for (auto& I : llvm::instructions(*llvm::cast<llvm::Function>(it.first))) {
-            if (instMatchesCrit(dg, I, parsedCrit)) {
-                LLVMNode *nd = it.second->getNode(&I);
-                assert(nd);
+    for (const auto& c : lineCrit) {
+        if (c.first <= 0)
+            continue;
+
+        const auto *lineNodes = index.getLine(c.first);
+        if (!lineNodes)
+            continue;
+
+        for (LLVMNode *nd : *lineNodes) {
+            const auto *I = llvm::cast<llvm::Instruction>(nd->getValue());
+            auto pts = dg.getPTA()->getLLVMPointsTo(getPointerOperand(I));
+            // it may be a definition of any variable, we do not know
+            bool unknown = pts.empty() || pts.hasUnknown();
+            // the iterators of the points-to set can be used only once
+            std::vector<const llvm::Value *> targets;
+            for (const auto& ptr : pts)
+                targets.push_back(ptr.value);
+
+            for (const auto& var : c.second) {
+                if (!unknown && !index.mayPointTo(targets, var))
+                    continue;
+
+                llvm::errs() << "Matched line " << c.first << " with variable "
+                             << var << " to:\n" << *I << "\n";
                 nodes.insert(nd);
+                break;
             }
         }
     }
@@ -72,8 +72,8 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
                        "a .sliced suffix is used with the original module name."),
         llvm::cl::value_desc("filename"), llvm::cl::init(""), llvm::cl::cat(SlicingOpts));
 
-    llvm::cl::opt<std::string> inputFile(llvm::cl::Positional, llvm::cl::Required,
-        llvm::cl::desc("<input file>"), llvm::cl::init(""), llvm::cl::cat(SlicingOpts));
+    llvm::cl::list<std::string> inputFiles(llvm::cl::Positional, llvm::cl::OneOrMore,
+        llvm::cl::desc("<input files>"), llvm::cl::cat(SlicingOpts));
 
     llvm::cl::opt<std::string> slicingCriteria("c",
         llvm::cl::desc("Slice with respect to the call-sites of a given function\n"
@@ -117,6 +117,25 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
                        "calls calls to exit() from inside of procedures. Default: true.\n"),
                        llvm::cl::init(true), llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<bool> cdBlockEdges("cd-block-edges",
+        llvm::cl::desc("Add control dependencies between basic blocks instead of\n"
+                       "adding them to every instruction of the dependent block\n"
+                       "(used with NTSCD, standard CD works always on blocks).\n"
+                       "Ignored with -forward. Default: false.\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> cdaThreads("cda-threads",
+        llvm::cl::desc("The number of threads that compute control dependencies\n"
+                       "of different functions at once (default=1).\n"),
+                       llvm::cl::init(1), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> cdaIncremental("cda-incremental",
+        llvm::cl::desc("Keep the post-dominator trees of the functions and update\n"
+                       "them and the control dependencies after the CFG changes\n"
+                       "(e.g., by slicing) instead of computing them again.\n"
+                       "Standard CD only. Default: false.\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<uint64_t> ptaFieldSensitivity("pta-field-sensitive",
         llvm::cl::desc("Make PTA field sensitive/insensitive. The offset in a pointer\n"
                        "is cropped to Offset::UNKNOWN when it is greater than N bytes.\n"
@@ -194,6 +213,35 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
         llvm::cl::init(LLVMDataDependenceAnalysisOptions::AnalysisType::ssa),
                        llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<std::string> ddaModRefSummaries("dda-modref-summaries",
+        llvm::cl::desc("Reuse mod/ref summaries of functions stored in the file\n"
+                       "by previous runs and store the new ones there.\n"),
+                       llvm::cl::value_desc("file"), llvm::cl::init(""),
+                       llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ddaEagerPhis("dda-eager-phis",
+        llvm::cl::desc("Place phi nodes in MemorySSA eagerly into iterated\n"
+                       "dominance frontiers instead of on demand (default=false).\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> walkThreads("walk-threads",
+        llvm::cl::desc("The number of threads used for searching the nodes\n"
+                       "that are in the slice (default=1).\n"),
+                       llvm::cl::init(1), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> contextSensitive("context-sensitive",
+        llvm::cl::desc("Compute the slice context-sensitively using summary edges,\n"
+                       "so that it contains only the calls that may influence\n"
+                       "the slicing criteria (default=false).\n"
+                       "Cannot be used with -forward and -batch.\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> lazyDD("lazy-dd",
+        llvm::cl::desc("Compute data dependencies only for the instructions\n"
+                       "that are reached while searching the backward slice\n"
+                       "(default=false). Ignored with -forward.\n"),
+                       llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<dg::ControlDependenceAnalysisOptions::CDAlgorithm> cdAlgorithm("cda",
         llvm::cl::desc("Choose control dependencies algorithm:"),
         llvm::cl::values(
@@ -202,7 +250,9 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
             clEnumValN(dg::ControlDependenceAnalysisOptions::CDAlgorithm::STANDARD,
                        "classic", "Alias to \"standard\""),
             clEnumValN(dg::ControlDependenceAnalysisOptions::CDAlgorithm::NTSCD,
-                       "ntscd", "Non-termination sensitive control dependencies algorithm")
+                       "ntscd", "Non-termination sensitive control dependencies algorithm"),
+            clEnumValN(dg::ControlDependenceAnalysisOptions::CDAlgorithm::NTSCD2,
+                       "ntscd2", "Faster algorithm for non-termination sensitive control dependencies")
     #if LLVM_VERSION_MAJOR < 4
             , nullptr
     #endif
@@ -236,13 +286,16 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
     /// Fill the structure
     SlicerOptions options;
 
-    options.inputFile = inputFile;
+    options.inputFiles.assign(inputFiles.begin(), inputFiles.end());
+    options.inputFile = options.inputFiles.front();
     options.outputFile = outputFile;
     options.slicingCriteria = slicingCriteria;
     options.secondarySlicingCriteria = secondarySlicingCriteria;
     options.preservedFunctions = splitList(preservedFuns);
     options.removeSlicingCriteria = removeSlicingCriteria;
     options.forwardSlicing = forwardSlicing;
+    options.walkThreads = walkThreads;
+    options.contextSensitive = contextSensitive;
 
     auto& dgOptions = options.dgOptions;
     auto& PTAOptions = dgOptions.PTAOptions;
@@ -251,10 +304,17 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
 
     dgOptions.entryFunction = entryFunction;
     dgOptions.threads = threads;
+    // forward slicing needs all the data dependencies
+    dgOptions.lazyDataDependencies = lazyDD && !forwardSlicing;
 
     // FIXME: add options class for CD
     CDAOptions.algorithm = cdAlgorithm;
     CDAOptions.interprocedural = interprocCd;
+    // forward slicing treats the dependencies between blocks
+    // differently, it would give a different (bigger) slice
+    CDAOptions.blockEdges = cdBlockEdges && !forwardSlicing;
+    CDAOptions.workers = cdaThreads;
+    CDAOptions.incremental = cdaIncremental;
 
     addAllocationFuns(dgOptions, allocationFuns);
 
@@ -267,6 +327,8 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit) {
     DDAOptions.entryFunction = entryFunction;
     DDAOptions.undefinedFunsBehavior = undefinedFunsBehavior;
     DDAOptions.analysisType = ddaType;
+    DDAOptions.modRefSummaries = ddaModRefSummaries;
+    DDAOptions.eagerPhiPlacement = ddaEagerPhis;
 
     return options;
 }
@@ -42,9 +42,18 @@ struct SlicerOptions {
     // do we perform forward slicing?
     bool forwardSlicing{false};
 
+    // the number of threads used for searching the slice
+    unsigned walkThreads{1};
+
+    // use summary edges to get a context-sensitive (backward) slice
+    bool contextSensitive{false};
+
     std::string slicingCriteria{};
     std::string secondarySlicingCriteria{};
+    // the first of the input files
     std::string inputFile{};
+    // all the input files (only llvm-slicer takes more of them)
+    std::vector<std::string> inputFiles{};
     std::string outputFile{};
 };
 
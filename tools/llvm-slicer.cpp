@@ -1,7 +1,10 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <thread>
 #include <cassert>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -55,6 +58,7 @@
 #include "dg/llvm/LLVMDG2Dot.h"
 #include "dg/llvm/LLVMDGAssemblyAnnotationWriter.h"
 #include "dg/util/debug.h"
+#include "dg/util/parallel.h"
 
 using namespace dg;
 
@@ -107,18 +111,41 @@ llvm::cl::opt<std::string> annotationOpts("annotate",
     llvm::cl::value_desc("val1,val2,..."), llvm::cl::init(""),
     llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> batch_slicing("batch",
+    llvm::cl::desc("Compute a separate slice w.r.t. every slicing criterion\n"
+                   "node (e.g., every found call-site), all at once using one\n"
+                   "dependence graph (default=false)."),
+    llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<std::string> batch_report("batch-report",
+    llvm::cl::desc("Save the instructions in the slices computed with -batch\n"
+                   "into the file (CSV if the file ends with .csv, JSON otherwise)."),
+    llvm::cl::value_desc("file"), llvm::cl::init(""),
+    llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> batch_modules("batch-modules",
+    llvm::cl::desc("Save a sliced module for every slice computed with -batch\n"
+                   "(the output name with the number of the slice appended)\n"
+                   "(default=true)."),
+    llvm::cl::init(true), llvm::cl::cat(SlicingOpts));
 
-// mapping of AllocaInst to the names of C variables
-std::map<const llvm::Value *, std::string> valuesToVariables;
+llvm::cl::opt<unsigned> jobs("jobs",
+    llvm::cl::desc("The number of modules that are sliced in parallel\n"
+                   "when more input modules are given (0 = the number\n"
+                   "of CPUs, default=1)."),
+    llvm::cl::value_desc("N"), llvm::cl::init(1),
+    llvm::cl::cat(SlicingOpts));
 
 class ModuleWriter {
     const SlicerOptions& options;
     llvm::Module *M;
+    std::string outputFile;
 
 public:
     ModuleWriter(const SlicerOptions& o,
-                 llvm::Module *m)
-    : options(o), M(m) {}
+                 llvm::Module *m,
+                 std::string output = "")
+    : options(o), M(m), outputFile(std::move(output)) {}
 
     int cleanAndSaveModule(bool should_verify_module = true) {
         // remove unneeded parts of the module
@@ -130,6 +157,16 @@ public:
         return saveModule(should_verify_module);
     }
 
+    static std::string getOutputFile(const SlicerOptions& options)
+    {
+        if (!options.outputFile.empty())
+            return options.outputFile;
+
+        std::string fl = options.inputFile;
+        replace_suffix(fl, ".sliced");
+        return fl;
+    }
+
     int saveModule(bool should_verify_module = true)
     {
         if (should_verify_module)
@@ -171,13 +208,8 @@ public:
 private:
     bool writeModule() {
         // compose name if not given
-        std::string fl;
-        if (!options.outputFile.empty()) {
-            fl = options.outputFile;
-        } else {
-            fl = options.inputFile;
-            replace_suffix(fl, ".sliced");
-        }
+        std::string fl = outputFile.empty() ? getOutputFile(options)
+                                            : outputFile;
 
         // open stream to write to
         std::ofstream ofs(fl);
@@ -435,7 +467,8 @@ public:
 
         errs() << "[llvm-slicer] Saving IR with annotations to " << fl << "\n";
         auto annot
-            = new dg::debug::LLVMDGAssemblyAnnotationWriter(annotationOptions,
+            = new dg::debug::LLVMDGAssemblyAnnotationWriter(dg->getConstructedFunctions(),
+                                                            annotationOptions,
                                                             dg->getPTA(),
                                                             dg->getDDA(),
                                                             criteria);
@@ -520,22 +553,78 @@ bool findSecondarySlicingCriteria(std::set<LLVMNode *>& criteria_nodes,
                                   const std::set<std::string>& secondaryControlCriteria,
                                   const std::set<std::string>& secondaryDataCriteria);
 
-
-int main(int argc, char *argv[])
+// defined in llvm-slicer-batch.cpp
+std::vector<LLVMNode *> sortBatchCriteria(llvm::Module *M,
+                                          const std::set<LLVMNode *>& nodes);
+
+bool writeBatchReport(const std::string& file,
+                      LLVMDependenceGraph& dg,
+                      const std::vector<std::vector<LLVMNode *>>& nodes,
+                      const std::vector<LLVMNode *>& criteria);
+
+///
+// Slice w.r.t. every criterion node separately, using one
+// dependence graph and one walk of the graph for all the slices.
+static int sliceBatch(::Slicer& slicer, const SlicerOptions& options,
+                      const std::set<LLVMNode *>& criteria_nodes,
+                      const std::set<std::string>& secondaryControlCriteria,
+                      const std::set<std::string>& secondaryDataCriteria)
 {
-    setupStackTraceOnError(argc, argv);
+    auto criteria = sortBatchCriteria(slicer.getDG().getModule(), criteria_nodes);
+
+    std::vector<std::set<LLVMNode *>> criteria_sets;
+    criteria_sets.reserve(criteria.size());
+    for (LLVMNode *crit : criteria) {
+        std::set<LLVMNode *> nodes{crit};
+        if (!findSecondarySlicingCriteria(nodes,
+                                          secondaryControlCriteria,
+                                          secondaryDataCriteria)) {
+            llvm::errs() << "Finding secondary slicing criteria nodes failed\n";
+            return 1;
+        }
+        criteria_sets.push_back(std::move(nodes));
+    }
 
-    SlicerOptions options = parseSlicerOptions(argc, argv, true /* require crit*/);
+    if (!slicer.markBatch(criteria_sets)) {
+        llvm::errs() << "Finding dependent nodes failed\n";
+        return 1;
+    }
 
-    if (enable_debug) {
-        DBG_ENABLE();
+    int ret = 0;
+    if (!batch_report.empty()) {
+        std::vector<std::vector<LLVMNode *>> slices;
+        slices.reserve(criteria.size());
+        for (unsigned i = 0; i < criteria.size(); ++i)
+            slices.push_back(slicer.getBatchSlice(i));
+
+        if (!writeBatchReport(batch_report, slicer.getDG(), slices, criteria))
+            ret = 1;
     }
 
-    // dump_dg_only implies dumg_dg
-    if (dump_dg_only) {
-        dump_dg = true;
+    if (!batch_modules)
+        return ret;
+
+    std::string output = ModuleWriter::getOutputFile(options);
+    for (unsigned i = 0; i < criteria.size(); ++i) {
+        slicer.markBatchSlice(i);
+        auto sliced = slicer.sliceCopy();
+
+        ModuleWriter writer(options, sliced.get(),
+                            output + "." + std::to_string(i));
+        maybe_print_statistics(sliced.get(), "Statistics after ");
+        if (writer.cleanAndSaveModule(should_verify_module) != 0)
+            ret = 1;
     }
 
+    return ret;
+}
+
+
+// Slice the module options.inputFile. Every call uses its own
+// LLVM context and dependence graph, so more modules can be sliced
+// in parallel.
+static int sliceModule(const SlicerOptions& options)
+{
     llvm::LLVMContext context;
     std::unique_ptr<llvm::Module> M = parseModule(context, options);
     if (!M) {
@@ -596,6 +685,16 @@ int main(int argc, char *argv[])
     const auto& secondaryControlCriteria = secondaryCriteria.first;
     const auto& secondaryDataCriteria = secondaryCriteria.second;
 
+    if (options.contextSensitive && options.forwardSlicing) {
+        llvm::errs() << "Context-sensitive slicing supports only backward slicing\n";
+        return 1;
+    }
+
+    if (batch_slicing) {
+        return sliceBatch(slicer, options, criteria_nodes,
+                          secondaryControlCriteria, secondaryDataCriteria);
+    }
+
     // mark nodes that are going to be in the slice
     if (!findSecondarySlicingCriteria(criteria_nodes,
                                       secondaryControlCriteria,
@@ -637,3 +736,70 @@ int main(int argc, char *argv[])
     maybe_print_statistics(M.get(), "Statistics after ");
     return writer.cleanAndSaveModule(should_verify_module);
 }
+
+// Slice the input modules using 'jobs' threads. Every thread takes
+// the next module that was not sliced yet. Return the number
+// of modules that failed.
+static unsigned sliceModules(const SlicerOptions& options, unsigned jobs)
+{
+    const auto& files = options.inputFiles;
+    std::atomic<unsigned> failed{0};
+
+    parallelFor(files.size(), jobs, [&](size_t idx, unsigned) {
+        SlicerOptions opts = options;
+        opts.inputFile = files[idx];
+        opts.inputFiles = {files[idx]};
+        if (sliceModule(opts) != 0) {
+            llvm::errs() << "[llvm-slicer] Slicing '" << files[idx]
+                         << "' failed\n";
+            ++failed;
+        }
+    });
+
+    return failed;
+}
+
+int main(int argc, char *argv[])
+{
+    setupStackTraceOnError(argc, argv);
+
+    SlicerOptions options = parseSlicerOptions(argc, argv, true /* require crit*/);
+
+    if (enable_debug) {
+        DBG_ENABLE();
+    }
+
+    // dump_dg_only implies dumg_dg
+    if (dump_dg_only) {
+        dump_dg = true;
+    }
+
+    if (batch_slicing) {
+        if (options.forwardSlicing) {
+            llvm::errs() << "Batch slicing supports only backward slicing\n";
+            return 1;
+        }
+
+        if (options.contextSensitive) {
+            llvm::errs() << "Batch slicing cannot be used with -context-sensitive\n";
+            return 1;
+        }
+    }
+
+    if (options.inputFiles.size() == 1) {
+        return sliceModule(options);
+    }
+
+    if (!options.outputFile.empty() || !batch_report.empty()) {
+        llvm::errs() << "The output file (-o) and -batch-report cannot "
+                        "be used with more input files\n";
+        return 1;
+    }
+
+    unsigned jobs_num = jobs;
+    if (jobs_num == 0) {
+        jobs_num = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    return sliceModules(options, jobs_num) == 0 ? 0 : 1;
+}
@@ -2,6 +2,10 @@
 #define _DG_TOOL_LLVM_SLICER_H_
 
 #include <ctime>
+#include <limits>
+#include <memory>
+#include <set>
+#include <vector>
 
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
@@ -24,6 +28,7 @@
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMDependenceGraphBuilder.h"
 #include "dg/llvm/LLVMSlicer.h"
+#include "dg/llvm/LLVMSummaryEdges.h"
 
 #include "dg/llvm/LLVMDGAssemblyAnnotationWriter.h"
 #include "llvm-slicer-opts.h"
@@ -55,6 +60,12 @@
 //
 /// --------------------------------------------------------------------
 class Slicer {
+    // the id of the slice marked by mark()
+    static constexpr uint32_t SLICE_ID = 0xdead;
+    // the slices marked by markBatchSlice() get the ids from this one up,
+    // so that they do not collide with SLICE_ID (see markBatch())
+    static constexpr uint32_t BATCH_SLICE_ID = SLICE_ID + 1;
+
     llvm::Module *M{};
     const SlicerOptions& _options;
 
@@ -65,6 +76,11 @@ class Slicer {
     uint32_t slice_id = 0;
     bool _computed_deps{false};
 
+    // slices computed by markBatch()
+    dg::BatchWalkAndMark<dg::LLVMNode> _batch{};
+    // nodes to unmark in every slice if we remove slicing criteria
+    std::vector<std::set<dg::LLVMNode *>> _batch_unmark{};
+
 public:
     Slicer(llvm::Module *mod, const SlicerOptions& opts)
     : M(mod), _options(opts),
@@ -135,11 +151,26 @@ public:
         for (auto& funcName : _options.preservedFunctions)
             slicer.keepFunctionUntouched(funcName.c_str());
 
-        slice_id = 0xdead;
+        slice_id = SLICE_ID;
 
-        tm.start();
-        for (dg::LLVMNode *start : criteria_nodes)
-            slice_id = slicer.mark(start, slice_id, _options.forwardSlicing);
+        if (_options.contextSensitive) {
+            assert(!_options.forwardSlicing && "Context-sensitive slicing is only backward");
+
+            dg::LLVMSummaryEdges summaries;
+            tm.start();
+            summaries.compute(*_dg);
+            tm.stop();
+            tm.report("[llvm-slicer] Computing summary edges took");
+            llvm::errs() << "[llvm-slicer] Found " << summaries.size()
+                         << " summary edges\n";
+
+            tm.start();
+            slice_id = slicer.markContextSensitive(criteria_nodes, summaries, slice_id);
+        } else {
+            tm.start();
+            slicer.setWalkThreads(_options.walkThreads);
+            slice_id = slicer.mark(criteria_nodes, slice_id, _options.forwardSlicing);
+        }
 
         assert(slice_id != 0 && "Somethig went wrong when marking nodes");
 
@@ -153,6 +184,102 @@ public:
         return true;
     }
 
+    ///
+    // Compute the slices w.r.t. every set of nodes from 'criteria'
+    // at once. A particular slice is then selected using
+    // markBatchSlice() and written into a copy of the module
+    // using sliceCopy(). This method calls computeDependencies().
+    bool markBatch(std::vector<std::set<dg::LLVMNode *>>& criteria)
+    {
+        assert(_dg && "markBatch() called without the dependence graph built");
+        assert(!criteria.empty() && "Do not have slicing criteria");
+        assert(!_options.forwardSlicing && "Batch slicing is only backward");
+
+        if (criteria.size() > std::numeric_limits<uint32_t>::max() - BATCH_SLICE_ID) {
+            llvm::errs() << "[llvm-slicer] Too many slicing criteria: "
+                         << criteria.size() << "\n";
+            return false;
+        }
+
+        dg::debug::TimeMeasure tm;
+
+        computeDependencies();
+
+        if (_options.removeSlicingCriteria)
+            _batch_unmark = criteria;
+
+        std::set<dg::LLVMNode *> additional;
+        _dg->getCallSites(_options.additionalSlicingCriteria, &additional);
+        for (auto& crit : criteria)
+            crit.insert(additional.begin(), additional.end());
+
+        for (auto& funcName : _options.preservedFunctions)
+            slicer.keepFunctionUntouched(funcName.c_str());
+
+        tm.start();
+        _batch = slicer.markBatch(criteria);
+        tm.stop();
+        tm.report("[llvm-slicer] Finding dependent nodes took");
+
+        llvm::errs() << "[llvm-slicer] Computed " << criteria.size()
+                     << " slices over " << _batch.getNodes().size()
+                     << " nodes\n";
+        return true;
+    }
+
+    // Mark the nodes from the slice w.r.t. the i-th criterion
+    // given to markBatch()
+    void markBatchSlice(unsigned i)
+    {
+        assert(i < _batch.getCriteriaNum());
+
+        // every slice has its own id, so that the marks
+        // from the previous slices are not taken into account
+        slice_id = BATCH_SLICE_ID + i;
+        _batch.mark(i, slice_id);
+
+        if (i < _batch_unmark.size()) {
+            for (dg::LLVMNode *nd : _batch_unmark[i])
+                nd->setSlice(0);
+        }
+    }
+
+    // The nodes that are in the slice w.r.t. the i-th criterion given
+    // to markBatch(), that is, the nodes that sliceCopy() keeps
+    // after markBatchSlice(i) (the unmarked criteria are not there)
+    std::vector<dg::LLVMNode *> getBatchSlice(unsigned i)
+    {
+        markBatchSlice(i);
+
+        std::vector<dg::LLVMNode *> ret;
+        for (dg::LLVMNode *nd : _batch.getNodes()) {
+            if (nd->getSlice() == slice_id)
+                ret.push_back(nd);
+        }
+        return ret;
+    }
+
+    // Slice a copy of the module w.r.t. the marked slice.
+    // Unlike slice(), the graph and the module stay untouched.
+    std::unique_ptr<llvm::Module> sliceCopy()
+    {
+        assert(_dg && "Must run buildDG() and computeDependencies()");
+        assert(slice_id != 0 && "Must mark the slice before sliceCopy()");
+
+        dg::debug::TimeMeasure tm;
+
+        tm.start();
+        auto sliced = slicer.sliceCopy(_dg.get(), slice_id);
+        tm.stop();
+        tm.report("[llvm-slicer] Slicing a copy of the module took");
+
+        dg::SlicerStatistics& st = slicer.getStatistics();
+        llvm::errs() << "[llvm-slicer] Sliced away " << st.nodesRemoved
+                     << " from " << st.nodesTotal << " nodes in DG\n";
+
+        return sliced;
+    }
+
     bool slice()
     {
         assert(_dg && "Must run buildDG() and computeDependencies()");
@@ -160,6 +287,11 @@ public:
 
         dg::debug::TimeMeasure tm;
 
+        // keep the control dependencies up to date with the sliced CFG
+        const auto& CDAOptions = _options.dgOptions.CDAOptions;
+        if (CDAOptions.incremental && CDAOptions.standardCD())
+            slicer.setControlDependence(_builder.getCDA());
+
         tm.start();
         slicer.slice(_dg.get(), nullptr, slice_id);
 